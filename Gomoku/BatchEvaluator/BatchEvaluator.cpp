@@ -0,0 +1,220 @@
+/*
+ ============================================================================
+ Name		 : BatchEvaluator.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Console tool that rates many positions with the evaluation
+               of the segment based AIs, e.g. to label training data.
+
+ Usage: BatchEvaluator <positions> <scores file> [my weight]
+                       [enemy weight] [threads]
+
+ The positions use the format of the ProofSolver tool, every line
+ describes one position by the moves that led to it:
+   <columns> <rows> <pair check 0/1> <pairs to win> <x>,<y> <x>,<y> ...
+ The player that made the first move has color 1, the moves alternate.
+ All positions are rated with the grid size and pair check of the first
+ one, other positions are skipped. The number of pairs to win has to be
+ valid, but is not used by the evaluation. Empty lines and lines starting
+ with '#' are ignored.
+ For every position, a line is written to the scores file:
+   <line number> <score>
+ The score is for the player that made the last move, higher is better.
+ The default weights 1 1 are the ones of the reference AI.
+ ============================================================================
+ */
+
+#include <e32base.h>
+#include <e32cons.h>
+#include <f32file.h>
+#include "GomokuBatchEvaluator.h"
+#include "GomokuPositionReader.h"
+
+_LIT(KTitle, "Gomoku Batch Evaluator");
+_LIT(KUsage, "BatchEvaluator <positions> <scores file> [my weight] [enemy weight] [threads]\n");
+
+/**
+ * Maximum length of a line of the scores file.
+ */
+const TInt KMaxScoreLength = 32;
+
+LOCAL_C void EvaluatePositionsL(CConsoleBase& aConsole)
+	{
+	// Arguments
+	HBufC* commandLine = HBufC::NewLC(User::CommandLineLength());
+	TPtr arguments = commandLine->Des();
+	User::CommandLine(arguments);
+	TLex lex(arguments);
+	const TPtrC positionsFileName = lex.NextToken();
+	const TPtrC scoresFileName = lex.NextToken();
+	TInt myWeight = 1;
+	TInt enemyWeight = 1;
+	TInt threads = 1;
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(myWeight) != KErrNone)
+		{
+		myWeight = 0;
+		}
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(enemyWeight) != KErrNone)
+		{
+		enemyWeight = 0;
+		}
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(threads) != KErrNone)
+		{
+		threads = 0;
+		}
+	if (scoresFileName.Length() == 0 || myWeight <= 0 || enemyWeight <= 0
+			|| threads <= 0 || threads > KBatchMaxThreads)
+		{
+		aConsole.Printf(KUsage);
+		CleanupStack::PopAndDestroy(commandLine);
+		return;
+		}
+
+	RFs fs;
+	User::LeaveIfError(fs.Connect());
+	CleanupClosePushL(fs);
+
+	// Read the positions
+	RFile positionsFile;
+	User::LeaveIfError(positionsFile.Open(fs, positionsFileName, EFileRead
+			| EFileShareReadersOnly));
+	CleanupClosePushL(positionsFile);
+	TInt size;
+	User::LeaveIfError(positionsFile.Size(size));
+	HBufC8* positions = HBufC8::NewLC(size);
+	TPtr8 positionsPtr = positions->Des();
+	User::LeaveIfError(positionsFile.Read(positionsPtr));
+	TPoint* moves = new (ELeave) TPoint[KMaxPositionMoves];
+	CleanupArrayDeletePushL(moves);
+
+	// The first valid position defines the kind of game of the batch.
+	TInt maxPositions = 0;
+	TSize gridSize;
+	TBool pairCheck = EFalse;
+	TGomokuPositionReader counter(*positions);
+	while (counter.NextLine())
+		{
+		TInt numPairsWin;
+		TInt numMoves;
+		if (maxPositions == 0 && !counter.ParsePosition(gridSize, pairCheck,
+				numPairsWin, moves, numMoves))
+			{
+			continue;
+			}
+		maxPositions++;
+		}
+	if (maxPositions == 0)
+		{
+		aConsole.Printf(_L("No valid positions\n"));
+		CleanupStack::PopAndDestroy(5, commandLine); // moves, positions, positionsFile, fs, commandLine
+		return;
+		}
+
+	CGomokuBatchEvaluator* evaluator = CGomokuBatchEvaluator::NewL(gridSize,
+			pairCheck, myWeight, enemyWeight);
+	CleanupStack::PushL(evaluator);
+	evaluator->SetThreadsL(threads);
+	CGrid* grid = CGrid::NewL();
+	CleanupStack::PushL(grid);
+
+	// The evaluator rates a batch for one color, so the boards are packed
+	// into one batch per color of the last move.
+	const TInt packedSize = CGomokuBoard::PackedSize(gridSize);
+	HBufC8* boards1 = HBufC8::NewLC(maxPositions * packedSize);
+	HBufC8* boards2 = HBufC8::NewLC(maxPositions * packedSize);
+	TPtr8 boardsPtr1 = boards1->Des();
+	TPtr8 boardsPtr2 = boards2->Des();
+	TInt* lineNumbers = new (ELeave) TInt[maxPositions];
+	CleanupArrayDeletePushL(lineNumbers);
+	TBool* lastMoveColor1 = new (ELeave) TBool[maxPositions];
+	CleanupArrayDeletePushL(lastMoveColor1);
+
+	TInt numPositions = 0;
+	TInt numSkipped = 0;
+	TGomokuPositionReader reader(*positions);
+	while (reader.NextLine())
+		{
+		TSize positionGridSize;
+		TBool positionPairCheck;
+		TInt numPairsWin;
+		TInt numMoves;
+		TInt capturedPairs[2];
+		if (!reader.ParsePosition(positionGridSize, positionPairCheck,
+				numPairsWin, moves, numMoves) || positionGridSize != gridSize
+				|| positionPairCheck != pairCheck)
+			{
+			numSkipped++;
+			continue;
+			}
+		grid->ResizeGridL(gridSize);
+		if (!TGomokuPositionReader::PlayMoves(grid, pairCheck, moves,
+				numMoves, capturedPairs))
+			{
+			numSkipped++;
+			continue;
+			}
+		lineNumbers[numPositions] = reader.LineNumber();
+		lastMoveColor1[numPositions] = (numMoves % 2 == 1);
+		CGomokuBoard::Pack(grid, lastMoveColor1[numPositions] ? boardsPtr1
+				: boardsPtr2);
+		numPositions++;
+		}
+
+	TInt* scores = new (ELeave) TInt[numPositions * 2];
+	CleanupArrayDeletePushL(scores);
+	TInt* scores1 = scores;
+	TInt* scores2 = scores + numPositions;
+	evaluator->EvaluateL(*boards1, EColor1, scores1);
+	evaluator->EvaluateL(*boards2, EColor2, scores2);
+
+	// Write the scores in the order of the positions.
+	RFile scoresFile;
+	User::LeaveIfError(scoresFile.Replace(fs, scoresFileName, EFileWrite));
+	CleanupClosePushL(scoresFile);
+	TBuf8<KMaxScoreLength> score;
+	for (TInt i = 0; i < numPositions; i++)
+		{
+		score.Num(lineNumbers[i]);
+		score.Append(' ');
+		score.AppendNum(lastMoveColor1[i] ? *scores1++ : *scores2++);
+		score.Append('\n');
+		User::LeaveIfError(scoresFile.Write(score));
+		}
+
+	aConsole.Printf(_L("%d positions rated, %d invalid positions skipped\n"),
+			numPositions, numSkipped);
+	aConsole.Printf(_L("Scores written to %S\n"), &scoresFileName);
+
+	CleanupStack::PopAndDestroy(13, commandLine); // scoresFile, scores, lastMoveColor1, lineNumbers, boards2, boards1, grid, evaluator, moves, positions, positionsFile, fs, commandLine
+	}
+
+GLDEF_C TInt E32Main()
+	{
+	__UHEAP_MARK;
+	CTrapCleanup* cleanup = CTrapCleanup::New();
+	CConsoleBase* console = NULL;
+	TRAPD(err, console = Console::NewL(KTitle, TSize(KConsFullScreen,
+					KConsFullScreen)));
+	if (err == KErrNone)
+		{
+		TRAP(err, EvaluatePositionsL(*console));
+		if (err != KErrNone)
+			{
+			console->Printf(_L("Failed: %d\n"), err);
+			}
+		console->Printf(_L("[press any key]\n"));
+		console->Getch();
+		delete console;
+		}
+	delete cleanup;
+	__UHEAP_MARKEND;
+	return err;
+	}
@@ -0,0 +1,201 @@
+/*
+ ============================================================================
+ Name		 : BookBuilder.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Console tool that compiles the opening book from a text
+               file with game records.
+
+ Usage: BookBuilder <game records> <book file> [minimum games per move]
+
+ Every line of the game records describes one finished game:
+   <columns> <rows> <pair check 0/1> <winner 0/1/2> <x>,<y> <x>,<y> ...
+ The winner is 0 for a draw, 1 for the player that made the first move
+ and 2 for the other player. Empty lines and lines starting with '#' are
+ ignored. Copy the book to the private directory of Gomoku as
+ OpeningBook.dat to use it.
+ ============================================================================
+ */
+
+#include <e32base.h>
+#include <e32cons.h>
+#include <f32file.h>
+#include "GomokuBookBuilder.h"
+
+_LIT(KTitle, "Gomoku Book Builder");
+_LIT(KUsage, "BookBuilder <game records> <book file> [minimum games]\n");
+
+/**
+ * Maximum number of moves of a game record.
+ */
+const TInt KMaxGameMoves = 1024;
+
+/**
+ * Parse one game record.
+ * \return EFalse if the line is not a valid game record.
+ */
+LOCAL_C TBool ParseGame(const TDesC8& aLine, TSize& aGridSize,
+		TBool& aPairCheck, eCellColor& aWinner, TPoint* aMoves, TInt& aNumMoves)
+	{
+	TLex8 lex(aLine);
+	TInt pairCheck;
+	TInt winner;
+	lex.SkipSpace();
+	if (lex.Val(aGridSize.iWidth) != KErrNone)
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(aGridSize.iHeight) != KErrNone)
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(pairCheck) != KErrNone)
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(winner) != KErrNone || winner < 0 || winner > 2)
+		{
+		return EFalse;
+		}
+	aPairCheck = (pairCheck != 0);
+	aWinner = (winner == 1) ? EColor1 : ((winner == 2) ? EColor2
+			: EColorNeutral);
+
+	aNumMoves = 0;
+	lex.SkipSpace();
+	while (!lex.Eos())
+		{
+		if (aNumMoves == KMaxGameMoves || lex.Val(aMoves[aNumMoves].iX)
+				!= KErrNone || lex.Get() != ',' || lex.Val(
+				aMoves[aNumMoves].iY) != KErrNone)
+			{
+			return EFalse;
+			}
+		aNumMoves++;
+		lex.SkipSpace();
+		}
+	return ETrue;
+	}
+
+LOCAL_C void BuildBookL(CConsoleBase& aConsole)
+	{
+	// Arguments
+	HBufC* commandLine = HBufC::NewLC(User::CommandLineLength());
+	TPtr arguments = commandLine->Des();
+	User::CommandLine(arguments);
+	TLex lex(arguments);
+	const TPtrC gamesFileName = lex.NextToken();
+	const TPtrC bookFileName = lex.NextToken();
+	TInt minGames = KBookDefaultMinGames;
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(minGames) != KErrNone)
+		{
+		minGames = 0;
+		}
+	if (bookFileName.Length() == 0 || minGames <= 0)
+		{
+		aConsole.Printf(KUsage);
+		CleanupStack::PopAndDestroy(commandLine);
+		return;
+		}
+
+	RFs fs;
+	User::LeaveIfError(fs.Connect());
+	CleanupClosePushL(fs);
+
+	// Read the game records
+	RFile gamesFile;
+	User::LeaveIfError(gamesFile.Open(fs, gamesFileName, EFileRead
+			| EFileShareReadersOnly));
+	CleanupClosePushL(gamesFile);
+	TInt size;
+	User::LeaveIfError(gamesFile.Size(size));
+	HBufC8* games = HBufC8::NewLC(size);
+	TPtr8 gamesPtr = games->Des();
+	User::LeaveIfError(gamesFile.Read(gamesPtr));
+
+	CGomokuBookBuilder* builder = CGomokuBookBuilder::NewL();
+	CleanupStack::PushL(builder);
+	builder->SetMinGames(minGames);
+	TPoint* moves = new (ELeave) TPoint[KMaxGameMoves];
+	CleanupArrayDeletePushL(moves);
+
+	TInt numGames = 0;
+	TInt numSkipped = 0;
+	TPtrC8 remaining(*games);
+	while (remaining.Length() > 0)
+		{
+		TInt lineLength = remaining.Locate('\n');
+		if (lineLength == KErrNotFound)
+			{
+			lineLength = remaining.Length();
+			}
+		const TPtrC8 line = remaining.Left(lineLength);
+		remaining.Set(remaining.Mid(Min(lineLength + 1, remaining.Length())));
+
+		TLex8 first(line);
+		first.SkipSpace();
+		if (first.Eos() || first.Peek() == '#')
+			{
+			continue;
+			}
+		TSize gridSize;
+		TBool pairCheck;
+		eCellColor winner;
+		TInt numMoves;
+		if (ParseGame(line, gridSize, pairCheck, winner, moves, numMoves))
+			{
+			TRAPD(err, builder->AddGameL(gridSize, pairCheck, moves,
+							numMoves, winner));
+			if (err == KErrNone)
+				{
+				numGames++;
+				continue;
+				}
+			if (err != KErrCorrupt)
+				{
+				User::Leave(err);
+				}
+			}
+		numSkipped++;
+		}
+
+	const TInt numPositions = builder->WriteL(fs, bookFileName);
+	aConsole.Printf(_L("%d games, %d invalid records skipped\n"), numGames,
+			numSkipped);
+	aConsole.Printf(_L("%d positions written to %S\n"), numPositions,
+			&bookFileName);
+
+	CleanupStack::PopAndDestroy(6, commandLine); // moves, builder, games, gamesFile, fs, commandLine
+	}
+
+GLDEF_C TInt E32Main()
+	{
+	__UHEAP_MARK;
+	CTrapCleanup* cleanup = CTrapCleanup::New();
+	CConsoleBase* console = NULL;
+	TRAPD(err, console = Console::NewL(KTitle, TSize(KConsFullScreen,
+					KConsFullScreen)));
+	if (err == KErrNone)
+		{
+		TRAP(err, BuildBookL(*console));
+		if (err != KErrNone)
+			{
+			console->Printf(_L("Failed: %d\n"), err);
+			}
+		console->Printf(_L("[press any key]\n"));
+		console->Getch();
+		delete console;
+		}
+	delete cleanup;
+	__UHEAP_MARKEND;
+	return err;
+	}
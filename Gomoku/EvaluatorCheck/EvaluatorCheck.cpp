@@ -0,0 +1,1046 @@
+/*
+ ============================================================================
+ Name		 : EvaluatorCheck.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Console tool that checks the fast evaluations of the AIs
+               against the original rating, which counts the stones of
+               every segment cell by cell.
+
+ Usage: EvaluatorCheck [positions per game type] [seed]
+
+ For every game type (two grid sizes, each with and without pair check),
+ random games are played with the seed, so that every run checks the same
+ positions. For every position, the reference, the aggressive and the
+ defensive AI rate all cells for the player to move with the original
+ rating (ERatingPathLegacy). Their rating grids are compared cell by cell
+ with the rating grids of
+ - a turn of the AI (the line evaluator with its line cache),
+ - the segment table, which rates grids that the line evaluator doesn't
+   support,
+ - the batch evaluator with 1 and KBatchMaxThreads threads, with the same
+   weights (the cell ratings of the positions, and the scores of the boards
+   after every move). The scores of the positions are compared with the
+   original rating of the boards,
+ - the analysis (hints of the human player), with the weights of the
+   reference AI,
+ - the expert AI: every cell has to get the rating of a separate quiescence
+   search, which has to be the rating of the reference AI where it finds no
+   forcing moves.
+ The private directory of this tool has no network file, so the AIs rate
+ with the line evaluator. The neural network is checked with a random network: updating the
+ accumulators with the moves has to give the same rating as calculating
+ them from the board.
+
+ Every difference is counted and the first ones of each check are printed.
+ The summary of every check and the speedup over the original rating are
+ always printed.
+ ============================================================================
+ */
+
+#include <e32base.h>
+#include <e32cons.h>
+#include "GomokuPlayerAiReference.h"
+#include "GomokuPlayerAiAggressive.h"
+#include "GomokuPlayerAiDefensive.h"
+#include "GomokuPlayerAiExpert.h"
+#include "GomokuBatchEvaluator.h"
+#include "GomokuAnalysis.h"
+
+_LIT(KTitle, "Gomoku Evaluator Check");
+_LIT(KUsage, "EvaluatorCheck [positions per game type] [seed]\n");
+
+_LIT(KReferenceName, "Reference AI");
+_LIT(KAggressiveName, "Aggressive AI");
+_LIT(KDefensiveName, "Defensive AI");
+_LIT(KSegmentTableName, "segment table");
+_LIT(KBatchCellsName, "batch cells");
+_LIT(KBatchMovesName, "batch moves");
+_LIT(KBatchScoresName, "batch scores");
+_LIT(KAnalysisName, "Analysis");
+_LIT(KExpertName, "Expert AI");
+_LIT(KNnueName, "Network");
+
+/**
+ * Default number of positions per game type.
+ */
+const TInt KCheckDefaultPositions = 32;
+
+/**
+ * Default seed of the positions.
+ */
+const TInt KCheckDefaultSeed = 2009;
+
+/**
+ * Maximum number of moves of a position.
+ */
+const TInt KCheckMaxMoves = 40;
+
+/**
+ * Number of captured pairs required for winning the games.
+ */
+const TInt KCheckNumPairsWin = 5;
+
+/**
+ * Only the first differences of every check are printed.
+ */
+const TInt KCheckMaxPrinted = 3;
+
+/**
+ * Accumulator size of the random network.
+ */
+const TInt KCheckNnueSize = 32;
+
+/**
+ * Grid sizes of the checked games: the default size and the largest
+ * size of the settings. Every size is checked with and without pair check.
+ */
+const TInt KCheckNumGridSizes = 2;
+const TInt KCheckGridCols[KCheckNumGridSizes] = { 10, 19 };
+const TInt KCheckGridRows[KCheckNumGridSizes] = { 10, 15 };
+
+/**
+ * The checked personalities of the segment AI.
+ */
+enum TCheckPersonality
+	{
+	ECheckReference,
+	ECheckAggressive,
+	ECheckDefensive,
+	ECheckNumPersonalities
+	};
+
+// CLASS DECLARATION
+
+/**
+ * Generates the positions and runs the checks of one game type after
+ * the other.
+ */
+class CEvaluatorCheck : public CBase
+	{
+public:
+	/**
+	 * Destructor.
+	 */
+	~CEvaluatorCheck();
+
+	/**
+	 * Two-phased constructor.
+	 *
+	 * \param aConsole receives the results.
+	 * \param aNumPositions number of positions per game type.
+	 * \param aSeed seed of the random games.
+	 */
+	static CEvaluatorCheck* NewLC(CConsoleBase& aConsole, TInt aNumPositions,
+			TUint64 aSeed);
+
+	/**
+	 * Run all checks for all game types.
+	 * \return number of differences.
+	 */
+	TInt RunL();
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CEvaluatorCheck(CConsoleBase& aConsole, TInt aNumPositions);
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL(TUint64 aSeed);
+
+	/**
+	 * Run all checks for one game type.
+	 */
+	void CheckGameTypeL(TSize aGridSize, TBool aPairCheck);
+
+	/**
+	 * Play the random games of the positions.
+	 */
+	void GeneratePositionsL();
+
+	/**
+	 * Set up the position on the grid.
+	 *
+	 * \param aCapturedPairs receives the pairs captured by the player to
+	 * move and by the opponent.
+	 * \return the color of the player to move.
+	 */
+	eCellColor RestorePositionL(TInt aPosition, CGrid* aGrid,
+			TInt* aCapturedPairs);
+
+	/**
+	 * Compare the rating grids of an AI with the original rating and store
+	 * the original rating grids in iLegacy. Then check the batch evaluator,
+	 * and for the reference AI the analysis and the expert AI.
+	 */
+	void CheckPersonalityL(TInt aPersonality);
+
+	/**
+	 * Compare the batch evaluator with the original rating of iLegacy.
+	 */
+	void CheckBatchL(CGomokuPlayerAiSegment** aAis, TInt aMyWeight,
+			TInt aEnemyWeight);
+
+	/**
+	 * Compare the hints of the analysis with the original rating of the
+	 * reference AI in iLegacy.
+	 */
+	void CheckAnalysisL();
+
+	/**
+	 * Compare the rating grids of the expert AI with the original rating
+	 * of the reference AI in iLegacy and with a separate quiescence search.
+	 */
+	void CheckExpertL();
+
+	/**
+	 * Compare the incrementally updated neural network with the network
+	 * calculated from the board.
+	 */
+	void CheckNnueL();
+
+	/**
+	 * Count a difference and print it if it is one of the first ones.
+	 */
+	void AddDifference(const TDesC& aCheck, TInt aPosition, TInt aCell,
+			TInt aRating, TInt aReference);
+
+	/**
+	 * Compare two rating grids and count the different cells.
+	 */
+	void CompareGrids(const TDesC& aCheck, TInt aPosition,
+			const TInt* aRatings, const TInt* aReference);
+
+	/**
+	 * Print the result of a check and start the next one.
+	 *
+	 * \param aCompared number of compared ratings.
+	 * \param aTicks fast counter ticks of the check, 0 if the speedup
+	 * isn't printed.
+	 * \param aLegacyTicks fast counter ticks of the original rating for
+	 * the same cells.
+	 */
+	void ReportCheck(const TDesC& aCheck, TInt aCompared, TInt64 aTicks = 0,
+			TInt64 aLegacyTicks = 0);
+
+private:
+	/**
+	 * Receives the results.
+	 */
+	CConsoleBase& iConsole;
+
+	/**
+	 * Number of positions per game type.
+	 */
+	TInt iNumPositions;
+
+	/**
+	 * Plays the random games.
+	 */
+	TGomokuRandom iRandom;
+
+	/**
+	 * Grid size of the current game type.
+	 */
+	TSize iGridSize;
+
+	/**
+	 * Number of cells of the current grid size.
+	 */
+	TInt iNumCells;
+
+	/**
+	 * Pair check of the current game type.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Grid of the game, the AIs rate the position on this grid. Owned.
+	 */
+	CGrid* iGrid;
+
+	/**
+	 * Grid for trying the moves of a position. Owned.
+	 */
+	CGrid* iWorkGrid;
+
+	/**
+	 * Moves of all positions, KCheckMaxMoves per position.
+	 */
+	TPoint* iMoves;
+
+	/**
+	 * Number of moves of every position.
+	 */
+	TInt* iNumMoves;
+
+	/**
+	 * Original rating grids of all positions, row by row.
+	 */
+	TInt* iLegacy;
+
+	/**
+	 * Rating grid to compare with iLegacy.
+	 */
+	TInt* iRatings;
+
+	/**
+	 * Rates the positions of the quiescence search of CheckExpertL().
+	 */
+	TGomokuLineEvaluator iLineEvaluator;
+
+	/**
+	 * Differences of the current check.
+	 */
+	TInt iCheckDifferences;
+
+	/**
+	 * Differences of all checks.
+	 */
+	TInt iDifferences;
+	};
+
+CEvaluatorCheck::CEvaluatorCheck(CConsoleBase& aConsole, TInt aNumPositions) :
+	iConsole(aConsole), iNumPositions(aNumPositions)
+	{
+	// No implementation required
+	}
+
+CEvaluatorCheck::~CEvaluatorCheck()
+	{
+	delete iGrid;
+	delete iWorkGrid;
+	delete[] iMoves;
+	delete[] iNumMoves;
+	delete[] iLegacy;
+	delete[] iRatings;
+	}
+
+CEvaluatorCheck* CEvaluatorCheck::NewLC(CConsoleBase& aConsole,
+		TInt aNumPositions, TUint64 aSeed)
+	{
+	CEvaluatorCheck* self = new (ELeave) CEvaluatorCheck(aConsole,
+			aNumPositions);
+	CleanupStack::PushL(self);
+	self->ConstructL(aSeed);
+	return self;
+	}
+
+void CEvaluatorCheck::ConstructL(TUint64 aSeed)
+	{
+	iRandom.SetSeed(aSeed);
+	iGrid = CGrid::NewL();
+	iWorkGrid = CGrid::NewL();
+	TInt maxCells = 0;
+	for (TInt i = 0; i < KCheckNumGridSizes; i++)
+		{
+		maxCells = Max(maxCells, KCheckGridCols[i] * KCheckGridRows[i]);
+		}
+	iMoves = new (ELeave) TPoint[iNumPositions * KCheckMaxMoves];
+	iNumMoves = new (ELeave) TInt[iNumPositions];
+	iLegacy = new (ELeave) TInt[iNumPositions * maxCells];
+	iRatings = new (ELeave) TInt[maxCells];
+	}
+
+TInt CEvaluatorCheck::RunL()
+	{
+	for (TInt size = 0; size < KCheckNumGridSizes; size++)
+		{
+		const TSize gridSize(KCheckGridCols[size], KCheckGridRows[size]);
+		CheckGameTypeL(gridSize, EFalse);
+		CheckGameTypeL(gridSize, ETrue);
+		}
+	return iDifferences;
+	}
+
+void CEvaluatorCheck::CheckGameTypeL(TSize aGridSize, TBool aPairCheck)
+	{
+	iGridSize = aGridSize;
+	iNumCells = aGridSize.iWidth * aGridSize.iHeight;
+	iPairCheck = aPairCheck;
+	iGrid->ResizeGridL(aGridSize);
+	iWorkGrid->ResizeGridL(aGridSize);
+	iConsole.Printf(_L("%dx%d, pair check %d: %d positions\n"),
+			aGridSize.iWidth, aGridSize.iHeight, aPairCheck, iNumPositions);
+
+	GeneratePositionsL();
+	for (TInt personality = 0; personality < ECheckNumPersonalities; personality++)
+		{
+		CheckPersonalityL(personality);
+		}
+	CheckNnueL();
+	}
+
+void CEvaluatorCheck::GeneratePositionsL()
+	{
+	const TInt maxMoves = Min(KCheckMaxMoves, iNumCells / 3);
+	TInt* candidates = new (ELeave) TInt[iNumCells];
+	CleanupArrayDeletePushL(candidates);
+	for (TInt position = 0; position < iNumPositions; position++)
+		{
+		TPoint* moves = iMoves + position * KCheckMaxMoves;
+		const TInt numMoves = 1 + iRandom.Next(maxMoves);
+		iGrid->ResizeGridL(iGridSize);
+		TInt move;
+		for (move = 0; move < numMoves; move++)
+			{
+			// The first stone is placed close to the center, the others
+			// at most two cells away from a stone, like in real games.
+			TInt numCandidates = 0;
+			for (TInt cell = 0; cell < iNumCells; cell++)
+				{
+				const TInt x = cell % iGridSize.iWidth;
+				const TInt y = cell / iGridSize.iWidth;
+				if (!iGrid->GetGridCell(x, y)->IsFree())
+					{
+					continue;
+					}
+				TBool nearStone = (move == 0 && Abs(x - iGridSize.iWidth / 2)
+						<= 1 && Abs(y - iGridSize.iHeight / 2) <= 1);
+				for (TInt dy = -2; dy <= 2 && !nearStone; dy++)
+					{
+					for (TInt dx = -2; dx <= 2 && !nearStone; dx++)
+						{
+						nearStone = iGrid->IsInGrid(x + dx, iGridSize.iWidth)
+								&& iGrid->IsInGrid(y + dy, iGridSize.iHeight)
+								&& !iGrid->GetGridCell(x + dx, y + dy)->IsFree();
+						}
+					}
+				if (nearStone)
+					{
+					candidates[numCandidates++] = cell;
+					}
+				}
+			if (numCandidates == 0)
+				{
+				break;
+				}
+			const TInt cell = candidates[iRandom.Next(numCandidates)];
+			moves[move].SetXY(cell % iGridSize.iWidth, cell / iGridSize.iWidth);
+			iGrid->SetGridCell(moves[move].iX, moves[move].iY, (move % 2 == 0)
+					? EColor1 : EColor2, iPairCheck);
+			}
+		iNumMoves[position] = move;
+		}
+	CleanupStack::PopAndDestroy(candidates);
+	}
+
+eCellColor CEvaluatorCheck::RestorePositionL(TInt aPosition, CGrid* aGrid,
+		TInt* aCapturedPairs)
+	{
+	const TPoint* moves = iMoves + aPosition * KCheckMaxMoves;
+	const TInt numMoves = iNumMoves[aPosition];
+	aGrid->ResizeGridL(iGridSize);
+	aCapturedPairs[0] = 0;
+	aCapturedPairs[1] = 0;
+	for (TInt move = 0; move < numMoves; move++)
+		{
+		// Index 0 is the player to move.
+		const TInt player = (numMoves - move) % 2;
+		aCapturedPairs[1 - player] += aGrid->SetGridCell(moves[move].iX,
+				moves[move].iY, (move % 2 == 0) ? EColor1 : EColor2,
+				iPairCheck);
+		}
+	return (numMoves % 2 == 0) ? EColor1 : EColor2;
+	}
+
+void CEvaluatorCheck::CheckPersonalityL(TInt aPersonality)
+	{
+	// One AI for every color, so that the segment tables are only
+	// created once.
+	CGomokuPlayerAiSegment* ais[2];
+	TInt myWeight;
+	TInt enemyWeight;
+	const TDesC* name;
+	for (TInt i = 0; i < 2; i++)
+		{
+		switch (aPersonality)
+			{
+			case ECheckAggressive:
+				ais[i] = CGomokuPlayerAiAggressive::NewL();
+				myWeight = TGomokuAggressivePolicy::EMyWeight;
+				enemyWeight = TGomokuAggressivePolicy::EEnemyWeight;
+				name = &KAggressiveName;
+				break;
+			case ECheckDefensive:
+				ais[i] = CGomokuPlayerAiDefensive::NewL();
+				myWeight = TGomokuDefensivePolicy::EMyWeight;
+				enemyWeight = TGomokuDefensivePolicy::EEnemyWeight;
+				name = &KDefensiveName;
+				break;
+			default:
+				ais[i] = CGomokuPlayerAiReference::NewL();
+				myWeight = TGomokuReferencePolicy::EMyWeight;
+				enemyWeight = TGomokuReferencePolicy::EEnemyWeight;
+				name = &KReferenceName;
+				break;
+			}
+		CleanupStack::PushL(ais[i]);
+		ais[i]->InitL(iGrid, (i == 0) ? EColor1 : EColor2, iPairCheck,
+				KCheckNumPairsWin);
+		}
+
+	TInt compared = 0;
+	TInt tableDifferences = 0;
+	TInt64 legacyTicks = 0;
+	TInt64 tableTicks = 0;
+	TInt64 aiTicks = 0;
+	for (TInt position = 0; position < iNumPositions; position++)
+		{
+		TInt capturedPairs[2];
+		const eCellColor toMove = RestorePositionL(position, iGrid,
+				capturedPairs);
+		CGomokuPlayerAiSegment* ai = ais[(toMove == EColor1) ? 0 : 1];
+		TInt* legacy = iLegacy + position * iNumCells;
+
+		// The fast counter wraps around, the unsigned differences are still right.
+		const TUint32 start = User::FastCounter();
+		ai->RateAllCells(ERatingPathLegacy, legacy);
+		const TUint32 legacyEnd = User::FastCounter();
+		ai->RateAllCells(ERatingPathSegmentTable, iRatings);
+		const TUint32 tableEnd = User::FastCounter();
+		legacyTicks += (TUint32) (legacyEnd - start);
+		tableTicks += (TUint32) (tableEnd - legacyEnd);
+		const TInt differences = iCheckDifferences;
+		CompareGrids(KSegmentTableName, position, iRatings, legacy);
+		tableDifferences += iCheckDifferences - differences;
+		iCheckDifferences = differences;
+
+		const TUint32 aiStart = User::FastCounter();
+		ai->RateAllCells(ERatingPathAi, iRatings);
+		aiTicks += (TUint32) (User::FastCounter() - aiStart);
+		CompareGrids(*name, position, iRatings, legacy);
+		compared += iNumCells;
+		}
+	ReportCheck(*name, compared, aiTicks, legacyTicks);
+	iCheckDifferences = tableDifferences;
+	ReportCheck(KSegmentTableName, compared, tableTicks, legacyTicks);
+
+	CheckBatchL(ais, myWeight, enemyWeight);
+	if (aPersonality == ECheckReference)
+		{
+		CheckAnalysisL();
+		CheckExpertL();
+		}
+	CleanupStack::PopAndDestroy(2, ais[0]);
+	}
+
+void CEvaluatorCheck::CheckBatchL(CGomokuPlayerAiSegment** aAis,
+		TInt aMyWeight, TInt aEnemyWeight)
+	{
+	CGomokuBatchEvaluator* evaluator = CGomokuBatchEvaluator::NewL(iGridSize,
+			iPairCheck, aMyWeight, aEnemyWeight);
+	CleanupStack::PushL(evaluator);
+	const TInt packedSize = CGomokuBoard::PackedSize(iGridSize);
+	// The positions of one color to move at a time, and the boards after
+	// every move of them.
+	HBufC8* positions = HBufC8::NewLC(iNumPositions * packedSize);
+	HBufC8* moves = HBufC8::NewLC(iNumPositions * iNumCells * packedSize);
+	TInt* scores = new (ELeave) TInt[iNumPositions];
+	CleanupArrayDeletePushL(scores);
+	TInt* cellRatings = new (ELeave) TInt[iNumPositions * iNumCells];
+	CleanupArrayDeletePushL(cellRatings);
+	TInt* moveScores = new (ELeave) TInt[iNumPositions * iNumCells];
+	CleanupArrayDeletePushL(moveScores);
+	TInt* boardRatings = new (ELeave) TInt[iNumPositions];
+	CleanupArrayDeletePushL(boardRatings);
+
+	TInt comparedCells = 0;
+	TInt comparedMoves = 0;
+	TInt comparedScores = 0;
+	TInt cellDifferences = 0;
+	TInt moveDifferences = 0;
+	TInt scoreDifferences = 0;
+	const TInt threads[2] =
+		{
+		1, KBatchMaxThreads
+		};
+	for (TInt i = 0; i < 2; i++)
+		{
+		evaluator->SetThreadsL(threads[i]);
+		for (TInt color = 0; color < 2; color++)
+			{
+			const eCellColor myColor = (color == 0) ? EColor1 : EColor2;
+			TPtr8 positionsPtr = positions->Des();
+			TPtr8 movesPtr = moves->Des();
+			positionsPtr.Zero();
+			movesPtr.Zero();
+			TInt numPositions = 0;
+			for (TInt position = 0; position < iNumPositions; position++)
+				{
+				TInt capturedPairs[2];
+				if (RestorePositionL(position, iGrid, capturedPairs) != myColor)
+					{
+					continue;
+					}
+				CGomokuBoard::Pack(iGrid, positionsPtr);
+				boardRatings[numPositions++] = aAis[color]->RateBoardLegacy();
+				iWorkGrid->CopyFrom(iGrid);
+				for (TInt cell = 0; cell < iNumCells; cell++)
+					{
+					const TInt x = cell % iGridSize.iWidth;
+					const TInt y = cell / iGridSize.iWidth;
+					if (!iWorkGrid->GetGridCell(x, y)->IsFree())
+						{
+						continue;
+						}
+					if (iWorkGrid->SetGridCell(x, y, myColor, iPairCheck) > 0)
+						{
+						CGomokuBoard::Pack(iWorkGrid, movesPtr);
+						iWorkGrid->CopyFrom(iGrid);
+						}
+					else
+						{
+						CGomokuBoard::Pack(iWorkGrid, movesPtr);
+						iWorkGrid->SetGridCell(x, y, EColorNeutral, EFalse);
+						}
+					}
+				}
+			evaluator->EvaluateL(*positions, myColor, scores, cellRatings);
+			evaluator->EvaluateL(*moves, myColor, moveScores);
+
+			// Compare in the order in which the boards were packed.
+			TInt batchPosition = 0;
+			TInt move = 0;
+			for (TInt position = 0; position < iNumPositions; position++)
+				{
+				if (((iNumMoves[position] % 2 == 0) ? EColor1 : EColor2)
+						!= myColor)
+					{
+					continue;
+					}
+				const TInt* legacy = iLegacy + position * iNumCells;
+				TInt differences = iCheckDifferences;
+				CompareGrids(KBatchCellsName, position, cellRatings
+						+ batchPosition * iNumCells, legacy);
+				cellDifferences += iCheckDifferences - differences;
+				comparedCells += iNumCells;
+				for (TInt cell = 0; cell < iNumCells; cell++)
+					{
+					if (legacy[cell] != TAKEN_SPACE)
+						{
+						if (moveScores[move] != legacy[cell])
+							{
+							AddDifference(KBatchMovesName, position, cell,
+									moveScores[move], legacy[cell]);
+							moveDifferences++;
+							}
+						move++;
+						comparedMoves++;
+						}
+					}
+				if (scores[batchPosition] != boardRatings[batchPosition])
+					{
+					AddDifference(KBatchScoresName, position, -1,
+							scores[batchPosition], boardRatings[batchPosition]);
+					scoreDifferences++;
+					}
+				comparedScores++;
+				batchPosition++;
+				}
+			}
+		}
+	iCheckDifferences = cellDifferences;
+	ReportCheck(KBatchCellsName, comparedCells);
+	iCheckDifferences = moveDifferences;
+	ReportCheck(KBatchMovesName, comparedMoves);
+	iCheckDifferences = scoreDifferences;
+	ReportCheck(KBatchScoresName, comparedScores);
+	CleanupStack::PopAndDestroy(7, evaluator); // boardRatings, moveScores, cellRatings, scores, moves, positions, evaluator
+	}
+
+void CEvaluatorCheck::CheckAnalysisL()
+	{
+	CGomokuAnalysis* analysis = CGomokuAnalysis::NewL();
+	CleanupStack::PushL(analysis);
+	analysis->InitL(iGridSize, iPairCheck);
+	TInt compared = 0;
+	for (TInt position = 0; position < iNumPositions; position++)
+		{
+		TInt capturedPairs[2];
+		const eCellColor toMove = RestorePositionL(position, iGrid,
+				capturedPairs);
+		analysis->Analyse(iGrid, toMove);
+		TGomokuMoveHint hints[KMaxMoveHints];
+		const TInt numHints = analysis->GetHints(hints, KMaxMoveHints);
+		const TInt* legacy = iLegacy + position * iNumCells;
+		TInt freeCells = 0;
+		for (TInt cell = 0; cell < iNumCells; cell++)
+			{
+			if (legacy[cell] != TAKEN_SPACE)
+				{
+				freeCells++;
+				}
+			}
+		if (numHints != Min(freeCells, KMaxMoveHints))
+			{
+			AddDifference(KAnalysisName, position, -1, numHints, Min(
+					freeCells, KMaxMoveHints));
+			}
+		for (TInt i = 0; i < numHints; i++)
+			{
+			// Every hint has the original rating of its cell, and only the
+			// hints before it may be rated higher.
+			const TInt cell = hints[i].iMove.iY * iGridSize.iWidth
+					+ hints[i].iMove.iX;
+			TInt better = 0;
+			for (TInt other = 0; other < iNumCells; other++)
+				{
+				if (legacy[other] != TAKEN_SPACE && legacy[other]
+						> hints[i].iScore)
+					{
+					better++;
+					}
+				}
+			if (hints[i].iScore != legacy[cell] || better > i)
+				{
+				AddDifference(KAnalysisName, position, cell, hints[i].iScore,
+						legacy[cell]);
+				}
+			compared++;
+			}
+		}
+	ReportCheck(KAnalysisName, compared);
+	CleanupStack::PopAndDestroy(analysis);
+	}
+
+void CEvaluatorCheck::CheckExpertL()
+	{
+	CGomokuPlayerAiSegment* ais[2];
+	for (TInt i = 0; i < 2; i++)
+		{
+		ais[i] = CGomokuPlayerAiExpert::NewL();
+		CleanupStack::PushL(ais[i]);
+		ais[i]->InitL(iGrid, (i == 0) ? EColor1 : EColor2, iPairCheck,
+				KCheckNumPairsWin);
+		}
+	CGomokuQuiescence* quiescence = CGomokuQuiescence::NewL();
+	CleanupStack::PushL(quiescence);
+	quiescence->InitL(iGridSize, iPairCheck, KCheckNumPairsWin);
+	quiescence->SetLimits(TGomokuExpertPolicy::EQuiescenceDepth,
+			KQuiescenceDefaultThreeDepth, KQuiescenceDefaultNodeBudget);
+	// Same ratings as CGomokuPlayerAiSegment::CreateSegmentTable() for the
+	// weights of the expert AI.
+	TInt myRating[KSegmentCells + 1];
+	TInt enemyRating[KSegmentCells + 1];
+	for (TInt stones = 0; stones <= KSegmentCells; stones++)
+		{
+		myRating[stones] = KSegmentStoneRating[stones]
+				* TGomokuExpertPolicy::EMyWeight;
+		enemyRating[stones] = -KSegmentStoneRating[stones]
+				* KSegmentEnemyFactor * TGomokuExpertPolicy::EEnemyWeight;
+		}
+	iLineEvaluator.SetRatings(myRating, enemyRating, iPairCheck
+			? KSegmentPairPenalty : 0);
+
+	TInt compared = 0;
+	TInt quiet = 0;
+	TInt extended = 0;
+	for (TInt position = 0; position < iNumPositions; position++)
+		{
+		TInt capturedPairs[2];
+		const eCellColor toMove = RestorePositionL(position, iGrid,
+				capturedPairs);
+		CGomokuPlayerAiSegment* ai = ais[(toMove == EColor1) ? 0 : 1];
+		ai->SetCapturedPairs(capturedPairs[0], capturedPairs[1]);
+		ai->RateAllCells(ERatingPathAi, iRatings);
+		const TInt* legacy = iLegacy + position * iNumCells;
+		iWorkGrid->CopyFrom(iGrid);
+		for (TInt cell = 0; cell < iNumCells; cell++)
+			{
+			const TInt x = cell % iGridSize.iWidth;
+			const TInt y = cell / iGridSize.iWidth;
+			if (!iWorkGrid->GetGridCell(x, y)->IsFree())
+				{
+				continue;
+				}
+			const TInt removedPairs = iWorkGrid->SetGridCell(x, y, toMove,
+					iPairCheck);
+			const TInt extendedBefore = quiescence->ExtendedPositions();
+			const TInt rating = quiescence->Evaluate(iWorkGrid, toMove,
+					iLineEvaluator, capturedPairs[0] + removedPairs,
+					capturedPairs[1]);
+			if (quiescence->ExtendedPositions() != extendedBefore)
+				{
+				extended++;
+				}
+			else
+				if (rating != -KQuiescenceWin + 1)
+					{
+					// No forcing moves and no five of the opponent, the
+					// position keeps its static rating.
+					if (rating != legacy[cell])
+						{
+						AddDifference(KExpertName, position, cell, rating,
+								legacy[cell]);
+						}
+					quiet++;
+					}
+			// Like CGomokuPlayerAiSegment::RateMove()
+			const TInt reference = Max(TAKEN_SPACE + 1, Min(rating,
+					-TAKEN_SPACE - 1));
+			if (iRatings[cell] != reference)
+				{
+				AddDifference(KExpertName, position, cell, iRatings[cell],
+						reference);
+				}
+			compared++;
+			if (removedPairs > 0)
+				{
+				iWorkGrid->CopyFrom(iGrid);
+				}
+			else
+				{
+				iWorkGrid->SetGridCell(x, y, EColorNeutral, EFalse);
+				}
+			}
+		}
+	ReportCheck(KExpertName, compared + quiet);
+	iConsole.Printf(_L("  (%d quiet cells, %d cells with forcing moves)\n"),
+			quiet, extended);
+	CleanupStack::PopAndDestroy(3, ais[0]); // quiescence, ais[1], ais[0]
+	}
+
+/**
+ * Append a little endian number to the network.
+ */
+LOCAL_C void AppendNumber(TDes8& aNetwork, TInt aValue, TInt aBytes)
+	{
+	for (TInt i = 0; i < aBytes; i++)
+		{
+		aNetwork.Append((TUint8) (aValue >> (i * 8)));
+		}
+	}
+
+/**
+ * Append aCount random numbers from -aRange to aRange - 1.
+ */
+LOCAL_C void AppendRandom(TDes8& aNetwork, TGomokuRandom& aRandom,
+		TInt aCount, TInt aRange, TInt aBytes)
+	{
+	for (TInt i = 0; i < aCount; i++)
+		{
+		AppendNumber(aNetwork, aRandom.Next(2 * aRange) - aRange, aBytes);
+		}
+	}
+
+void CEvaluatorCheck::CheckNnueL()
+	{
+	// A random network in the format of the network file, see CGomokuNnue.
+	const TInt inputs = 2 * iNumCells * KCheckNnueSize;
+	HBufC8* network = HBufC8::NewLC(KNnueHeaderSize + 2 * inputs + 2
+			* KCheckNnueSize + 2 * KNnueHidden * KCheckNnueSize + 4
+			* KNnueHidden + KNnueHidden + 4);
+	TPtr8 networkPtr = network->Des();
+	AppendNumber(networkPtr, KNnueMagic, 4);
+	AppendNumber(networkPtr, KNnueVersion, 4);
+	AppendNumber(networkPtr, iGridSize.iWidth, 4);
+	AppendNumber(networkPtr, iGridSize.iHeight, 4);
+	AppendNumber(networkPtr, KCheckNnueSize, 4);
+	AppendNumber(networkPtr, KNnueHiddenShift, 4);
+	AppendRandom(networkPtr, iRandom, inputs, 32, 2);
+	AppendRandom(networkPtr, iRandom, KCheckNnueSize, 32, 2);
+	AppendRandom(networkPtr, iRandom, 2 * KNnueHidden * KCheckNnueSize, 16, 1);
+	AppendRandom(networkPtr, iRandom, KNnueHidden, 256, 4);
+	AppendRandom(networkPtr, iRandom, KNnueHidden, 16, 1);
+	AppendNumber(networkPtr, 0, 4);
+	CGomokuNnue* nnue = CGomokuNnue::NewL();
+	CleanupStack::PushL(nnue);
+	User::LeaveIfError(nnue->Load(*network));
+
+	TInt compared = 0;
+	for (TInt position = 0; position < iNumPositions; position++)
+		{
+		TInt capturedPairs[2];
+		const eCellColor toMove = RestorePositionL(position, iGrid,
+				capturedPairs);
+		const eCellColor opponent = (toMove == EColor1) ? EColor2 : EColor1;
+		iWorkGrid->CopyFrom(iGrid);
+		nnue->Refresh(iGrid);
+		const TInt before = nnue->Evaluate(toMove);
+		for (TInt cell = 0; cell < iNumCells; cell++)
+			{
+			const TInt x = cell % iGridSize.iWidth;
+			const TInt y = cell / iGridSize.iWidth;
+			if (!iWorkGrid->GetGridCell(x, y)->IsFree())
+				{
+				continue;
+				}
+			const TInt removedPairs = iWorkGrid->SetGridCell(x, y, toMove,
+					iPairCheck);
+			nnue->MakeMove(cell, toMove);
+			if (removedPairs > 0)
+				{
+				for (TInt other = 0; other < iNumCells; other++)
+					{
+					if (iGrid->GetGridCell(other % iGridSize.iWidth, other
+							/ iGridSize.iWidth)->GetColor() == opponent
+							&& iWorkGrid->GetGridCell(other % iGridSize.iWidth,
+									other / iGridSize.iWidth)->IsFree())
+						{
+						nnue->RemoveStone(other, opponent);
+						}
+					}
+				}
+			const TInt incremental = nnue->Evaluate(toMove);
+			nnue->UndoMove();
+			const TInt undone = nnue->Evaluate(toMove);
+			nnue->Refresh(iWorkGrid);
+			const TInt refreshed = nnue->Evaluate(toMove);
+			if (incremental != refreshed)
+				{
+				AddDifference(KNnueName, position, cell, incremental, refreshed);
+				}
+			if (undone != before)
+				{
+				AddDifference(KNnueName, position, -1, undone, before);
+				}
+			compared++;
+			nnue->Refresh(iGrid);
+			if (removedPairs > 0)
+				{
+				iWorkGrid->CopyFrom(iGrid);
+				}
+			else
+				{
+				iWorkGrid->SetGridCell(x, y, EColorNeutral, EFalse);
+				}
+			}
+		}
+	ReportCheck(KNnueName, compared);
+	CleanupStack::PopAndDestroy(2, network); // nnue, network
+	}
+
+void CEvaluatorCheck::AddDifference(const TDesC& aCheck, TInt aPosition,
+		TInt aCell, TInt aRating, TInt aReference)
+	{
+	iCheckDifferences++;
+	if (iCheckDifferences > KCheckMaxPrinted)
+		{
+		return;
+		}
+	if (aCell < 0)
+		{
+		iConsole.Printf(_L("  %S: position %d rated %d instead of %d\n"),
+				&aCheck, aPosition, aRating, aReference);
+		}
+	else
+		{
+		iConsole.Printf(_L("  %S: position %d, cell %d,%d rated %d instead of %d\n"),
+				&aCheck, aPosition, aCell % iGridSize.iWidth, aCell
+						/ iGridSize.iWidth, aRating, aReference);
+		}
+	}
+
+void CEvaluatorCheck::CompareGrids(const TDesC& aCheck, TInt aPosition,
+		const TInt* aRatings, const TInt* aReference)
+	{
+	for (TInt cell = 0; cell < iNumCells; cell++)
+		{
+		if (aRatings[cell] != aReference[cell])
+			{
+			AddDifference(aCheck, aPosition, cell, aRatings[cell],
+					aReference[cell]);
+			}
+		}
+	}
+
+void CEvaluatorCheck::ReportCheck(const TDesC& aCheck, TInt aCompared,
+		TInt64 aTicks, TInt64 aLegacyTicks)
+	{
+	if (aTicks > 0)
+		{
+		const TInt speedup = (TInt) (aLegacyTicks * 100 / aTicks);
+		iConsole.Printf(_L("  %S: %d of %d differ, %d.%02d times faster\n"),
+				&aCheck, iCheckDifferences, aCompared, speedup / 100, speedup
+						% 100);
+		}
+	else
+		{
+		iConsole.Printf(_L("  %S: %d of %d differ\n"), &aCheck,
+				iCheckDifferences, aCompared);
+		}
+	iDifferences += iCheckDifferences;
+	iCheckDifferences = 0;
+	}
+
+LOCAL_C TInt CheckEvaluatorsL(CConsoleBase& aConsole)
+	{
+	// Arguments
+	HBufC* commandLine = HBufC::NewLC(User::CommandLineLength());
+	TPtr arguments = commandLine->Des();
+	User::CommandLine(arguments);
+	TLex lex(arguments);
+	TInt numPositions = KCheckDefaultPositions;
+	TInt seed = KCheckDefaultSeed;
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(numPositions) != KErrNone)
+		{
+		numPositions = 0;
+		}
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(seed) != KErrNone)
+		{
+		numPositions = 0;
+		}
+	if (numPositions <= 0)
+		{
+		aConsole.Printf(KUsage);
+		CleanupStack::PopAndDestroy(commandLine);
+		return 0;
+		}
+
+	CEvaluatorCheck* check = CEvaluatorCheck::NewLC(aConsole, numPositions,
+			seed);
+	const TInt differences = check->RunL();
+	if (differences > 0)
+		{
+		aConsole.Printf(_L("FAILED: %d differences\n"), differences);
+		}
+	else
+		{
+		aConsole.Printf(_L("All checks passed\n"));
+		}
+	CleanupStack::PopAndDestroy(2, commandLine); // check, commandLine
+	return differences;
+	}
+
+GLDEF_C TInt E32Main()
+	{
+	__UHEAP_MARK;
+	CTrapCleanup* cleanup = CTrapCleanup::New();
+	CConsoleBase* console = NULL;
+	TInt differences = 0;
+	TRAPD(err, console = Console::NewL(KTitle, TSize(KConsFullScreen,
+					KConsFullScreen)));
+	if (err == KErrNone)
+		{
+		TRAP(err, differences = CheckEvaluatorsL(*console));
+		if (err != KErrNone)
+			{
+			console->Printf(_L("Failed: %d\n"), err);
+			}
+		else
+			if (differences > 0)
+				{
+				err = KErrGeneral;
+				}
+		console->Printf(_L("[press any key]\n"));
+		console->Getch();
+		delete console;
+		}
+	delete cleanup;
+	// The AIs are created without ECom, but their base class reports the
+	// destruction to it.
+	REComSession::FinalClose();
+	__UHEAP_MARKEND;
+	return err;
+	}
@@ -0,0 +1,220 @@
+/*
+ ============================================================================
+ Name		 : GomokuAiThread.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuAiThread implementation
+ ============================================================================
+ */
+
+#include "GomokuAiThread.h"
+
+CGomokuAiThread::CGomokuAiThread(MGomokuAiJob& aJob) :
+	CActive(EPriorityStandard), iJob(aJob)
+	{
+	CActiveScheduler::Add (this);
+	}
+
+CGomokuAiThread::~CGomokuAiThread()
+	{
+	Cancel ();
+	iThread.Close ();
+	iClientThread.Close ();
+	iCommandSemaphore.Close ();
+	iCancelSemaphore.Close ();
+	iQueueLock.Close ();
+	}
+
+CGomokuAiThread* CGomokuAiThread::NewL(MGomokuAiJob& aJob)
+	{
+	CGomokuAiThread* self = new (ELeave)CGomokuAiThread(aJob);
+	CleanupStack::PushL (self);
+	self->ConstructL ();
+	CleanupStack::Pop (); // self;
+	return self;
+	}
+
+void CGomokuAiThread::ConstructL()
+	{
+	User::LeaveIfError (iQueueLock.CreateLocal ());
+	User::LeaveIfError (iCommandSemaphore.CreateLocal (0));
+	User::LeaveIfError (iCancelSemaphore.CreateLocal (0));
+	User::LeaveIfError (iClientThread.Open (RThread ().Id ()));
+	// The thread shares the heap of the creating thread, so the job can use
+	// the data of the AI directly.
+	User::LeaveIfError (iThread.Create (KNullDesC, ThreadFunction,
+			KAiThreadStackSize, NULL, this));
+	// Drawing and user input of the UI thread come first.
+	iThread.SetPriority (EPriorityLess);
+	iThread.Logon (iThreadStatus);
+	iThreadCreated = ETrue;
+	iStatus = KRequestPending;
+	SetActive ();
+	iThread.Resume ();
+	}
+
+void CGomokuAiThread::StartJob()
+	{
+	CancelJob ();
+	iJobId ++;
+	iJobRunning = ETrue;
+	PostCommand (EAiCommandStartJob, iJobId);
+	}
+
+void CGomokuAiThread::CancelJob()
+	{
+	if ( iJobRunning)
+		{
+		PostCommand (EAiCommandCancelJob, iJobId);
+		iCancelSemaphore.Wait ();
+		// A result of the job that is still in the queue is ignored by RunL().
+		iJobRunning = EFalse;
+		}
+	}
+
+TBool CGomokuAiThread::IsJobRunning() const
+	{
+	return iJobRunning;
+	}
+
+void CGomokuAiThread::RunL()
+	{
+	// Wait for the next result before handling this one. The worker only
+	// completes the request again after iWakeRequested has been cleared,
+	// when the request is already active.
+	iStatus = KRequestPending;
+	SetActive ();
+	iQueueLock.Wait ();
+	iWakeRequested = EFalse;
+	iQueueLock.Signal ();
+
+	// HandleJobFinished() may start the next job, so the lock is not held
+	// while it runs.
+	TInt jobId;
+	while (PopResult (jobId))
+		{
+		if ( iJobRunning && jobId == iJobId)
+			{
+			iJobRunning = EFalse;
+			iJob.HandleJobFinished ();
+			}
+		}
+	}
+
+void CGomokuAiThread::DoCancel()
+	{
+	if ( iThreadCreated)
+		{
+		PostCommand (EAiCommandExit, 0);
+		User::WaitForRequest (iThreadStatus);
+		iThreadCreated = EFalse;
+		}
+	iJobRunning = EFalse;
+	// The worker has ended, if it hasn't completed the request, nobody will.
+	if ( !iWakeRequested)
+		{
+		TRequestStatus* status = &iStatus;
+		User::RequestComplete (status, KErrCancel);
+		}
+	}
+
+TInt CGomokuAiThread::ThreadFunction(TAny* aThread)
+	{
+	CTrapCleanup* cleanup = CTrapCleanup::New ();
+	if ( !cleanup)
+		{
+		return KErrNoMemory;
+		}
+	((CGomokuAiThread*)aThread)->Run ();
+	delete cleanup;
+	return KErrNone;
+	}
+
+void CGomokuAiThread::Run()
+	{
+	TInt jobId = 0;
+	TBool running = EFalse;
+	FOREVER
+		{
+		if ( !running)
+			{
+			// Sleep until the next command. The semaphore is signalled for
+			// every command, including the ones that were already handled
+			// during a job, so it can wake the worker with an empty queue.
+			iCommandSemaphore.Wait ();
+			}
+		TGomokuAiCommand command;
+		while (PopCommand (command))
+			{
+			if ( command.iType == EAiCommandStartJob)
+				{
+				jobId = command.iJobId;
+				running = ETrue;
+				}
+			else
+				if ( command.iType == EAiCommandCancelJob)
+					{
+					running = EFalse;
+					iCancelSemaphore.Signal ();
+					}
+				else
+					{
+					return;
+					}
+			}
+		if ( running && !iJob.RunJobStep ())
+			{
+			running = EFalse;
+			PostResult (jobId);
+			}
+		}
+	}
+
+void CGomokuAiThread::PostCommand(TGomokuAiCommandType aType, TInt aJobId)
+	{
+	TGomokuAiCommand command;
+	command.iType = aType;
+	command.iJobId = aJobId;
+	// The AI waits for every cancel, so the queue never fills up.
+	iQueueLock.Wait ();
+	iCommands.Push (command);
+	iQueueLock.Signal ();
+	iCommandSemaphore.Signal ();
+	}
+
+void CGomokuAiThread::PostResult(TInt aJobId)
+	{
+	// RunL() empties the queue before the AI starts the next job, so
+	// hardly ever more than one result is waiting.
+	iQueueLock.Wait ();
+	iResults.Push (aJobId);
+	const TBool wake = !iWakeRequested;
+	iWakeRequested = ETrue;
+	iQueueLock.Signal ();
+	if ( wake)
+		{
+		TRequestStatus* status = &iStatus;
+		iClientThread.RequestComplete (status, KErrNone);
+		}
+	}
+
+TBool CGomokuAiThread::PopCommand(TGomokuAiCommand& aCommand)
+	{
+	iQueueLock.Wait ();
+	const TBool found = iCommands.Pop (aCommand);
+	iQueueLock.Signal ();
+	return found;
+	}
+
+TBool CGomokuAiThread::PopResult(TInt& aJobId)
+	{
+	iQueueLock.Wait ();
+	const TBool found = iResults.Pop (aJobId);
+	iQueueLock.Signal ();
+	return found;
+	}
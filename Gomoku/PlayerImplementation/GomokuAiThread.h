@@ -0,0 +1,340 @@
+/*
+ ============================================================================
+ Name		 : GomokuAiThread.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Worker thread that calculates the moves of an AI, so that
+               the UI thread is free for drawing and user input.
+ ============================================================================
+ */
+
+#ifndef GOMOKUAITHREAD_H_
+#define GOMOKUAITHREAD_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+
+/**
+ * Number of entries of the command and the result queue. The AI never has
+ * more than a few commands and one result outstanding.
+ */
+const TInt KAiQueueSize = 8;
+
+/**
+ * Stack size of the worker thread. The threat solver recurses up to
+ * 2 * KThreatMaxDepth plies, the quiescence search up to its depth limit,
+ * and the neural network keeps its layers on the stack while it rates the
+ * leaves. KDefaultStackSize (8 KB) is not enough for the deepest lines.
+ */
+const TInt KAiThreadStackSize = 0x8000;
+
+/**
+ * Commands from the AI to its worker thread.
+ */
+enum TGomokuAiCommandType
+	{
+	/**
+	 * Start calculating the job.
+	 */
+	EAiCommandStartJob,
+	/**
+	 * Stop the job. The worker acknowledges through the cancel semaphore.
+	 */
+	EAiCommandCancelJob,
+	/**
+	 * Leave the thread.
+	 */
+	EAiCommandExit
+	};
+
+/**
+ * Entry of the command queue.
+ */
+class TGomokuAiCommand
+	{
+public:
+	TGomokuAiCommandType iType;
+	/**
+	 * Id of the job, every started job gets a new one.
+	 */
+	TInt iJobId;
+	};
+
+// CLASS DECLARATION
+
+/**
+ * Ring buffer of commands or results. The queue itself isn't thread safe,
+ * CGomokuAiThread only accesses it while holding its queue lock.
+ */
+template <class T, TInt S>
+class TGomokuAiQueue
+	{
+public:
+	inline TGomokuAiQueue();
+
+	/**
+	 * Add an item.
+	 * \return EFalse if the queue is full.
+	 */
+	inline TBool Push(const T& aItem);
+
+	/**
+	 * Remove the oldest item.
+	 * \return EFalse if the queue is empty.
+	 */
+	inline TBool Pop(T& aItem);
+
+private:
+	T iItems[S];
+
+	/**
+	 * Next item to read.
+	 */
+	TInt iRead;
+
+	/**
+	 * Next free entry.
+	 */
+	TInt iWrite;
+	};
+
+/**
+ * Interface of an AI whose moves are calculated by a CGomokuAiThread.
+ */
+class MGomokuAiJob
+	{
+public:
+	/**
+	 * Continue calculating the move, called repeatedly in the worker
+	 * thread. New commands are checked between two calls, so a call
+	 * should not take much longer than a time slice of the AI.
+	 *
+	 * \return ETrue if the calculation isn't finished yet.
+	 */
+	virtual TBool RunJobStep() = 0;
+
+	/**
+	 * Called in the thread of the AI (the UI thread) once the job has
+	 * finished. The move can be sent to the observer from here.
+	 */
+	virtual void HandleJobFinished() = 0;
+	};
+
+/**
+ * Worker thread that runs the jobs of an AI.
+ *
+ * The AI sends commands through a queue and wakes the worker with a
+ * semaphore. While the worker calculates, it checks the queue between
+ * the steps of the job. When a job is finished, its id is put into the
+ * result queue and this active object is completed, which hands the result
+ * back to the UI thread, where MGomokuAiJob::HandleJobFinished() is called.
+ * The worker thread runs at a lower priority than the UI, so drawing and
+ * user input always come first while the AI uses the rest of the processor.
+ *
+ * The job works on the data of the AI. While a job runs, the AI must not
+ * touch the data of the calculation; CancelJob() waits until the worker
+ * has stopped.
+ *
+ * The queues are protected by a critical section. Taking it orders the
+ * memory accesses of both threads, also on multi-core processors: the
+ * worker sees the data of the AI that was written before the job was
+ * started, and the AI sees the results of the job once it gets its id.
+ * After a cancel, the cancel semaphore has the same effect.
+ */
+class CGomokuAiThread : public CActive
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor. Stops the worker thread.
+	 */
+	~CGomokuAiThread();
+
+	/**
+	 * Two-phased constructor. Leaves if the thread can't be created, the
+	 * AI can calculate on its own thread then.
+	 *
+	 * \param aJob the AI whose moves are calculated.
+	 */
+	static CGomokuAiThread* NewL(MGomokuAiJob& aJob);
+
+public:
+	/**
+	 * Start a new job. A job that is still running is cancelled first.
+	 */
+	void StartJob();
+
+	/**
+	 * Stop the current job and wait until the worker has finished its
+	 * current step. HandleJobFinished() is not called for the job, even if
+	 * it has already finished. Does nothing if no job is running.
+	 */
+	void CancelJob();
+
+	/**
+	 * \return ETrue if a job has been started and has neither finished
+	 * nor been cancelled.
+	 */
+	TBool IsJobRunning() const;
+
+protected:
+	// from CActive
+	void RunL();
+	void DoCancel();
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuAiThread(MGomokuAiJob& aJob);
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Entry function of the worker thread.
+	 * \param aThread the object that owns the thread.
+	 */
+	static TInt ThreadFunction(TAny* aThread);
+
+	/**
+	 * Main loop of the worker thread: wait for commands and run the jobs.
+	 */
+	void Run();
+
+	/**
+	 * Add a command to the queue and wake the worker.
+	 */
+	void PostCommand(TGomokuAiCommandType aType, TInt aJobId);
+
+	/**
+	 * Add the result of a job to the queue and wake the UI thread.
+	 * Called in the worker thread.
+	 */
+	void PostResult(TInt aJobId);
+
+	/**
+	 * Remove the oldest command from the queue, called in the worker thread.
+	 * \return EFalse if there is no command.
+	 */
+	TBool PopCommand(TGomokuAiCommand& aCommand);
+
+	/**
+	 * Remove the oldest result from the queue, called in the thread of
+	 * the AI.
+	 * \return EFalse if there is no result.
+	 */
+	TBool PopResult(TInt& aJobId);
+
+private:
+	/**
+	 * The AI whose moves are calculated.
+	 */
+	MGomokuAiJob& iJob;
+
+	/**
+	 * The worker thread.
+	 */
+	RThread iThread;
+
+	/**
+	 * Completed when the worker thread has finished.
+	 */
+	TRequestStatus iThreadStatus;
+
+	/**
+	 * ETrue if the worker thread has been created.
+	 */
+	TBool iThreadCreated;
+
+	/**
+	 * Handle of the thread of the AI, for completing this active object
+	 * from the worker thread.
+	 */
+	RThread iClientThread;
+
+	/**
+	 * Commands from the AI to the worker.
+	 */
+	TGomokuAiQueue<TGomokuAiCommand, KAiQueueSize> iCommands;
+
+	/**
+	 * Ids of the finished jobs, from the worker to the AI.
+	 */
+	TGomokuAiQueue<TInt, KAiQueueSize> iResults;
+
+	/**
+	 * Protects iCommands, iResults and iWakeRequested.
+	 */
+	RCriticalSection iQueueLock;
+
+	/**
+	 * Signalled for every command, the idle worker waits for it.
+	 */
+	RSemaphore iCommandSemaphore;
+
+	/**
+	 * Signalled by the worker when it has stopped a job.
+	 */
+	RSemaphore iCancelSemaphore;
+
+	/**
+	 * Set by the worker when it completes this active object, cleared by
+	 * RunL() once the request is active again. Makes sure that the request
+	 * is completed only once, however many results are posted.
+	 */
+	TBool iWakeRequested;
+
+	/**
+	 * Id of the last started job.
+	 */
+	TInt iJobId;
+
+	/**
+	 * ETrue if the last started job has neither finished nor been
+	 * cancelled.
+	 */
+	TBool iJobRunning;
+	};
+
+template <class T, TInt S>
+inline TGomokuAiQueue<T, S>::TGomokuAiQueue() :
+	iRead(0), iWrite(0)
+	{
+	}
+
+template <class T, TInt S>
+inline TBool TGomokuAiQueue<T, S>::Push(const T& aItem)
+	{
+	const TInt next = (iWrite + 1) % S;
+	if ( next == iRead)
+		{
+		return EFalse;
+		}
+	iItems[iWrite] = aItem;
+	iWrite = next;
+	return ETrue;
+	}
+
+template <class T, TInt S>
+inline TBool TGomokuAiQueue<T, S>::Pop(T& aItem)
+	{
+	if ( iRead == iWrite)
+		{
+		return EFalse;
+		}
+	aItem = iItems[iRead];
+	iRead = (iRead + 1) % S;
+	return ETrue;
+	}
+
+#endif /*GOMOKUAITHREAD_H_*/
@@ -0,0 +1,174 @@
+/*
+ ============================================================================
+ Name		 : GomokuAnalysis.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuAnalysis implementation
+ ============================================================================
+ */
+
+#include "GomokuAnalysis.h"
+
+CGomokuAnalysis::CGomokuAnalysis()
+	{
+	// No implementation required
+	}
+
+CGomokuAnalysis::~CGomokuAnalysis()
+	{
+	// Stops the worker before the board is deleted.
+	delete iAiThread;
+	delete iBoard;
+	}
+
+CGomokuAnalysis* CGomokuAnalysis::NewL()
+	{
+	CGomokuAnalysis* self = new (ELeave) CGomokuAnalysis();
+	CleanupStack::PushL(self);
+	self->ConstructL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuAnalysis::ConstructL()
+	{
+	iBoard = CGomokuBoard::NewL();
+	}
+
+void CGomokuAnalysis::InitL(TSize aGridSize, TBool aPairCheck)
+	{
+	Cancel();
+	iPairCheck = aPairCheck;
+	iEnabled = TGomokuLineEvaluator::Supports(aGridSize);
+	if (!iEnabled)
+		{
+		return;
+		}
+	iBoard->ResizeL(aGridSize);
+
+	// Ratings of the reference AI, see CGomokuBatchEvaluator::ConstructL()
+	TInt myRating[KSegmentCells + 1];
+	TInt enemyRating[KSegmentCells + 1];
+	for (TInt stones = 0; stones <= KSegmentCells; stones++)
+		{
+		myRating[stones] = KSegmentStoneRating[stones];
+		enemyRating[stones] = -KSegmentStoneRating[stones]
+				* KSegmentEnemyFactor;
+		}
+	iLineEvaluator.SetRatings(myRating, enemyRating, iPairCheck
+			? KSegmentPairPenalty : 0);
+	}
+
+void CGomokuAnalysis::Start(const CGrid* aGrid, eCellColor aColor)
+	{
+	Cancel();
+	if (!iEnabled || !aGrid)
+		{
+		return;
+		}
+	if (!iAiThread)
+		{
+		TRAPD(err, iAiThread = CGomokuAiThread::NewL(*this));
+		if (err != KErrNone)
+			{
+			return;
+			}
+		}
+	// The worker is stopped, so its data can be set up here.
+	iBoard->CopyFrom(aGrid);
+	iColor = aColor;
+	iRow = 0;
+	iNumWorkHints = 0;
+	iAiThread->StartJob();
+	}
+
+void CGomokuAnalysis::Cancel()
+	{
+	if (iAiThread)
+		{
+		iAiThread->CancelJob();
+		}
+	iNumHints = 0;
+	}
+
+TInt CGomokuAnalysis::GetHints(TGomokuMoveHint* aHints, TInt aMaxHints) const
+	{
+	const TInt numHints = Min(iNumHints, aMaxHints);
+	for (TInt i = 0; i < numHints; i++)
+		{
+		aHints[i] = iHints[i];
+		}
+	return numHints;
+	}
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+void CGomokuAnalysis::Analyse(const CGrid* aGrid, eCellColor aColor)
+	{
+	Cancel();
+	if (!iEnabled)
+		{
+		return;
+		}
+	iBoard->CopyFrom(aGrid);
+	iColor = aColor;
+	iRow = 0;
+	iNumWorkHints = 0;
+	while (RunJobStep())
+		{
+		}
+	HandleJobFinished();
+	}
+#endif
+
+TBool CGomokuAnalysis::RunJobStep()
+	{
+	// Rate every free cell of the row by the position after moving there,
+	// like CGomokuBatchWorker::RateCells().
+	for (TInt x = 0; x < iBoard->Cols(); x++)
+		{
+		if (iBoard->Cell(x, iRow) == EColorNeutral)
+			{
+			iBoard->MakeMove(x, iRow, iColor, iPairCheck);
+			AddWorkHint(x, iRow, iLineEvaluator.Evaluate(*iBoard, iColor));
+			iBoard->UndoMove();
+			}
+		}
+	iRow++;
+	return (iRow < iBoard->Rows());
+	}
+
+void CGomokuAnalysis::HandleJobFinished()
+	{
+	for (TInt i = 0; i < iNumWorkHints; i++)
+		{
+		iHints[i] = iWorkHints[i];
+		}
+	iNumHints = iNumWorkHints;
+	}
+
+void CGomokuAnalysis::AddWorkHint(TInt aX, TInt aY, TInt aScore)
+	{
+	if (iNumWorkHints == KMaxMoveHints
+			&& aScore <= iWorkHints[KMaxMoveHints - 1].iScore)
+		{
+		return;
+		}
+	// Move the worse hints down, the last one drops out of a full list.
+	TInt pos = Min(iNumWorkHints, KMaxMoveHints - 1);
+	while (pos > 0 && iWorkHints[pos - 1].iScore < aScore)
+		{
+		iWorkHints[pos] = iWorkHints[pos - 1];
+		pos--;
+		}
+	iWorkHints[pos].iMove.SetXY(aX, aY);
+	iWorkHints[pos].iScore = aScore;
+	if (iNumWorkHints < KMaxMoveHints)
+		{
+		iNumWorkHints++;
+		}
+	}
@@ -0,0 +1,172 @@
+/*
+ ============================================================================
+ Name		 : GomokuAnalysis.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Analyses the position in the background to suggest the
+               best moves to a human player.
+ ============================================================================
+ */
+
+#ifndef GOMOKUANALYSIS_H_
+#define GOMOKUANALYSIS_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuSearchStatistics.h"
+#include "GomokuBoard.h"
+#include "GomokuLineEvaluator.h"
+#include "GomokuAiThread.h"
+
+// CLASS DECLARATION
+
+/**
+ * Rates all free cells of the position with the line evaluator of the AIs
+ * and keeps the best KMaxMoveHints of them.
+ *
+ * The analysis runs in a CGomokuAiThread, one row of the board per step,
+ * so Start() and Cancel() return after at most one row and the UI thread
+ * is never blocked. Every Start() restarts the analysis for the new
+ * position. If the thread can't be created, no hints are available.
+ */
+class CGomokuAnalysis : public CBase, public MGomokuAiJob
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuAnalysis();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuAnalysis* NewL();
+
+public:
+	/**
+	 * Prepare the analysis for a new game. Cancels a running analysis.
+	 *
+	 * \param aGridSize size of the grid of the game. The analysis is
+	 * switched off if the line evaluator doesn't support it.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 */
+	void InitL(TSize aGridSize, TBool aPairCheck);
+
+	/**
+	 * Start analysing the current position for the specified player.
+	 * A running analysis is cancelled first. The grid is copied, so
+	 * it can change during the analysis.
+	 */
+	void Start(const CGrid* aGrid, eCellColor aColor);
+
+	/**
+	 * Stop the analysis, the hints of the last position are dropped.
+	 */
+	void Cancel();
+
+	/**
+	 * Get the best moves of the analysed position, see
+	 * CGomokuPlayerInterface::GetHints().
+	 *
+	 * \return number of moves in aHints, 0 while the analysis is running.
+	 */
+	TInt GetHints(TGomokuMoveHint* aHints, TInt aMaxHints) const;
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+	/**
+	 * Analyse the position on the calling thread, for the EvaluatorCheck
+	 * tool. The hints are available when the function returns.
+	 */
+	void Analyse(const CGrid* aGrid, eCellColor aColor);
+#endif
+
+public:
+	// from MGomokuAiJob
+	TBool RunJobStep();
+	void HandleJobFinished();
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuAnalysis();
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Insert a rated move into the sorted list of the worker, if it is
+	 * good enough.
+	 */
+	void AddWorkHint(TInt aX, TInt aY, TInt aScore);
+
+private:
+	/**
+	 * Worker thread, created when the first analysis starts.
+	 */
+	CGomokuAiThread* iAiThread;
+
+	/**
+	 * Copy of the analysed position, used by the worker.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * Rates the positions, with the same ratings as the AIs.
+	 */
+	TGomokuLineEvaluator iLineEvaluator;
+
+	/**
+	 * ETrue if the line evaluator supports the grid of the game.
+	 */
+	TBool iEnabled;
+
+	/**
+	 * ETrue if pair check is activated for this game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Color of the player whose moves are analysed.
+	 */
+	eCellColor iColor;
+
+	/**
+	 * Next row to rate, used by the worker.
+	 */
+	TInt iRow;
+
+	/**
+	 * Best moves found so far, the best first. Used by the worker.
+	 */
+	TGomokuMoveHint iWorkHints[KMaxMoveHints];
+
+	/**
+	 * Number of moves in iWorkHints.
+	 */
+	TInt iNumWorkHints;
+
+	/**
+	 * Best moves of the finished analysis, the best first.
+	 */
+	TGomokuMoveHint iHints[KMaxMoveHints];
+
+	/**
+	 * Number of moves in iHints, 0 while an analysis is running.
+	 */
+	TInt iNumHints;
+	};
+
+#endif /*GOMOKUANALYSIS_H_*/
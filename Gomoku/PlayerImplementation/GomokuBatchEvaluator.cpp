@@ -0,0 +1,220 @@
+/*
+ ============================================================================
+ Name		 : GomokuBatchEvaluator.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuBatchEvaluator implementation
+ ============================================================================
+ */
+
+#include "GomokuBatchEvaluator.h"
+
+CGomokuBatchWorker::CGomokuBatchWorker(TBool aPairCheck) :
+	iPairCheck(aPairCheck)
+	{
+	// No implementation required
+	}
+
+CGomokuBatchWorker::~CGomokuBatchWorker()
+	{
+	WaitForThread();
+	delete iBoard;
+	}
+
+CGomokuBatchWorker* CGomokuBatchWorker::NewL(TSize aGridSize,
+		const TInt* aMyRating, const TInt* aEnemyRating, TBool aPairCheck)
+	{
+	CGomokuBatchWorker* self = new (ELeave) CGomokuBatchWorker(aPairCheck);
+	CleanupStack::PushL(self);
+	self->ConstructL(aGridSize, aMyRating, aEnemyRating);
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuBatchWorker::ConstructL(TSize aGridSize, const TInt* aMyRating,
+		const TInt* aEnemyRating)
+	{
+	iBoard = CGomokuBoard::NewL();
+	iBoard->ResizeL(aGridSize);
+	iLineEvaluator.SetRatings(aMyRating, aEnemyRating, iPairCheck
+			? KSegmentPairPenalty : 0);
+	}
+
+void CGomokuBatchWorker::SetRange(const TUint8* aBoards, TInt aNumBoards,
+		eCellColor aMyColor, TInt* aScores, TInt* aCellRatings)
+	{
+	iBoards = aBoards;
+	iNumBoards = aNumBoards;
+	iMyColor = aMyColor;
+	iScores = aScores;
+	iCellRatings = aCellRatings;
+	}
+
+void CGomokuBatchWorker::Run()
+	{
+	const TInt packedSize = CGomokuBoard::PackedSize(TSize(iBoard->Cols(),
+			iBoard->Rows()));
+	for (TInt i = 0; i < iNumBoards; i++)
+		{
+		iBoard->CopyFrom(iBoards + i * packedSize);
+		iScores[i] = iLineEvaluator.Evaluate(*iBoard, iMyColor);
+		if (iCellRatings)
+			{
+			RateCells(iCellRatings + i * iBoard->NumCells());
+			}
+		}
+	}
+
+void CGomokuBatchWorker::RateCells(TInt* aCellRatings)
+	{
+	for (TInt y = 0; y < iBoard->Rows(); y++)
+		{
+		for (TInt x = 0; x < iBoard->Cols(); x++)
+			{
+			TInt& rating = aCellRatings[iBoard->Index(x, y)];
+			if (iBoard->Cell(x, y) != EColorNeutral)
+				{
+				rating = KBatchTakenCell;
+				}
+			else
+				{
+				iBoard->MakeMove(x, y, iMyColor, iPairCheck);
+				rating = iLineEvaluator.Evaluate(*iBoard, iMyColor);
+				iBoard->UndoMove();
+				}
+			}
+		}
+	}
+
+void CGomokuBatchWorker::StartThreadL()
+	{
+	// The thread shares the heap of the creating thread, so it can use the
+	// arrays of the batch directly. It doesn't allocate anything itself.
+	User::LeaveIfError(iThread.Create(KNullDesC, ThreadFunction,
+			KDefaultStackSize, NULL, this));
+	iThread.Logon(iThreadStatus);
+	iThreadRunning = ETrue;
+	iThread.Resume();
+	}
+
+void CGomokuBatchWorker::WaitForThread()
+	{
+	if (iThreadRunning)
+		{
+		User::WaitForRequest(iThreadStatus);
+		iThread.Close();
+		iThreadRunning = EFalse;
+		}
+	}
+
+TInt CGomokuBatchWorker::ThreadFunction(TAny* aWorker)
+	{
+	((CGomokuBatchWorker*) aWorker)->Run();
+	return KErrNone;
+	}
+
+CGomokuBatchEvaluator::CGomokuBatchEvaluator(TSize aGridSize,
+		TBool aPairCheck) :
+	iGridSize(aGridSize), iPairCheck(aPairCheck)
+	{
+	// No implementation required
+	}
+
+CGomokuBatchEvaluator::~CGomokuBatchEvaluator()
+	{
+	for (TInt i = 0; i < iThreads; i++)
+		{
+		delete iWorkers[i];
+		}
+	}
+
+CGomokuBatchEvaluator* CGomokuBatchEvaluator::NewL(TSize aGridSize,
+		TBool aPairCheck, TInt aMyWeight, TInt aEnemyWeight)
+	{
+	CGomokuBatchEvaluator* self = new (ELeave) CGomokuBatchEvaluator(
+			aGridSize, aPairCheck);
+	CleanupStack::PushL(self);
+	self->ConstructL(aMyWeight, aEnemyWeight);
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuBatchEvaluator::ConstructL(TInt aMyWeight, TInt aEnemyWeight)
+	{
+	if (!TGomokuLineEvaluator::Supports(iGridSize))
+		{
+		User::Leave(KErrNotSupported);
+		}
+	// Same ratings as CGomokuPlayerAiSegment::CreateSegmentTable()
+	for (TInt stones = 0; stones <= KSegmentCells; stones++)
+		{
+		iMyRating[stones] = KSegmentStoneRating[stones] * aMyWeight;
+		iEnemyRating[stones] = -KSegmentStoneRating[stones]
+				* KSegmentEnemyFactor * aEnemyWeight;
+		}
+	SetThreadsL(1);
+	}
+
+void CGomokuBatchEvaluator::SetThreadsL(TInt aThreads)
+	{
+	aThreads = Max(1, Min(aThreads, KBatchMaxThreads));
+	while (iThreads > aThreads)
+		{
+		delete iWorkers[--iThreads];
+		}
+	while (iThreads < aThreads)
+		{
+		iWorkers[iThreads] = CGomokuBatchWorker::NewL(iGridSize, iMyRating,
+				iEnemyRating, iPairCheck);
+		iThreads++;
+		}
+	}
+
+void CGomokuBatchEvaluator::EvaluateL(const TDesC8& aBoards,
+		eCellColor aMyColor, TInt* aScores, TInt* aCellRatings)
+	{
+	const TInt packedSize = CGomokuBoard::PackedSize(iGridSize);
+	if (aBoards.Length() % packedSize != 0)
+		{
+		User::Leave(KErrArgument);
+		}
+	const TInt numBoards = aBoards.Length() / packedSize;
+	const TInt numCells = iGridSize.iWidth * iGridSize.iHeight;
+	const TInt workers = Max(1, Min(iThreads, numBoards
+			/ KBatchMinBoardsPerThread));
+
+	// Split the batch into ranges of (almost) the same size.
+	TInt first = 0;
+	for (TInt i = 0; i < workers; i++)
+		{
+		const TInt count = (numBoards - first) / (workers - i);
+		iWorkers[i]->SetRange(aBoards.Ptr() + first * packedSize, count,
+				aMyColor, aScores + first, aCellRatings ? aCellRatings + first
+						* numCells : NULL);
+		first += count;
+		}
+
+	TBool started[KBatchMaxThreads];
+	for (TInt i = 1; i < workers; i++)
+		{
+		TRAPD(err, iWorkers[i]->StartThreadL());
+		started[i] = (err == KErrNone);
+		}
+	iWorkers[0]->Run();
+	for (TInt i = 1; i < workers; i++)
+		{
+		if (started[i])
+			{
+			iWorkers[i]->WaitForThread();
+			}
+		else
+			{
+			iWorkers[i]->Run();
+			}
+		}
+	}
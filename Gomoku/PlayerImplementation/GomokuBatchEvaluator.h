@@ -0,0 +1,289 @@
+/*
+ ============================================================================
+ Name		 : GomokuBatchEvaluator.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Rates many boards at once with the evaluation of the
+               segment based AIs, for analysis and training tools.
+ ============================================================================
+ */
+
+#ifndef GOMOKUBATCHEVALUATOR_H_
+#define GOMOKUBATCHEVALUATOR_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuLineEvaluator.h"
+
+/**
+ * Maximum number of threads of the batch evaluator.
+ */
+const TInt KBatchMaxThreads = 4;
+
+/**
+ * A thread is only started for at least this many boards, smaller batches
+ * are rated faster by fewer threads.
+ */
+const TInt KBatchMinBoardsPerThread = 64;
+
+/**
+ * Rating of an occupied cell in the cell ratings, same as TAKEN_SPACE of
+ * the segment based AIs.
+ */
+const TInt KBatchTakenCell = -20000;
+
+// CLASS DECLARATION
+
+/**
+ * Rates a range of the boards of a batch, on the thread of the batch
+ * evaluator or in its own thread. Every worker has its own board and line
+ * evaluator (including the line cache), the workers share nothing but the
+ * arrays of the batch, and each of them only writes to its own range.
+ */
+class CGomokuBatchWorker : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor. Waits for the thread if it is still running.
+	 */
+	~CGomokuBatchWorker();
+
+	/**
+	 * Two-phased constructor.
+	 *
+	 * \param aGridSize size of the boards.
+	 * \param aMyRating rating of a segment for 0 to 5 own stones.
+	 * \param aEnemyRating rating of a segment for 0 to 5 enemy stones.
+	 * \param aPairCheck ETrue if pair check is activated.
+	 */
+	static CGomokuBatchWorker* NewL(TSize aGridSize, const TInt* aMyRating,
+			const TInt* aEnemyRating, TBool aPairCheck);
+
+public:
+	/**
+	 * Set the boards to rate.
+	 *
+	 * \param aBoards first packed board of the range.
+	 * \param aNumBoards number of boards.
+	 * \param aMyColor color of the player for whom the boards are rated.
+	 * \param aScores rating of every board of the range.
+	 * \param aCellRatings ratings of the cells of every board of the range,
+	 * NULL if they are not needed.
+	 */
+	void SetRange(const TUint8* aBoards, TInt aNumBoards, eCellColor aMyColor,
+			TInt* aScores, TInt* aCellRatings);
+
+	/**
+	 * Rate the boards of the range.
+	 */
+	void Run();
+
+	/**
+	 * Start a thread that rates the boards of the range.
+	 */
+	void StartThreadL();
+
+	/**
+	 * Wait until the thread has rated all boards. Does nothing if no
+	 * thread is running.
+	 */
+	void WaitForThread();
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuBatchWorker(TBool aPairCheck);
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL(TSize aGridSize, const TInt* aMyRating,
+			const TInt* aEnemyRating);
+
+	/**
+	 * Entry function of the worker thread.
+	 * \param aWorker the worker that runs in the thread.
+	 */
+	static TInt ThreadFunction(TAny* aWorker);
+
+	/**
+	 * Rate every free cell of the board in iBoard: the rating of the board
+	 * after an own move on that cell.
+	 */
+	void RateCells(TInt* aCellRatings);
+
+private:
+	/**
+	 * Rates the boards.
+	 */
+	TGomokuLineEvaluator iLineEvaluator;
+
+	/**
+	 * The board that is rated. Owned.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * ETrue if pair check is activated.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * First packed board of the range.
+	 */
+	const TUint8* iBoards;
+
+	/**
+	 * Number of boards of the range.
+	 */
+	TInt iNumBoards;
+
+	/**
+	 * Color of the player for whom the boards are rated.
+	 */
+	eCellColor iMyColor;
+
+	/**
+	 * Ratings of the boards of the range.
+	 */
+	TInt* iScores;
+
+	/**
+	 * Ratings of the cells of the boards of the range, may be NULL.
+	 */
+	TInt* iCellRatings;
+
+	/**
+	 * The worker thread.
+	 */
+	RThread iThread;
+
+	/**
+	 * Completed when the worker thread has finished.
+	 */
+	TRequestStatus iThreadStatus;
+
+	/**
+	 * ETrue if the thread has been started and not been waited for yet.
+	 */
+	TBool iThreadRunning;
+	};
+
+/**
+ * Rates a batch of boards with the evaluation of the segment based AIs
+ * (see CGomokuPlayerAiSegment::AnalyzeBoard()), for tools that label many
+ * positions offline. The scores are exactly the ones the AI would calculate
+ * with the same weights.
+ *
+ * The boards are packed with CGomokuBoard::Pack() and stored one after the
+ * other in a descriptor. The batch is kept as separate arrays (the packed
+ * boards, the scores and the cell ratings), each worker gets a contiguous
+ * range of all of them. The range of the first worker is rated on the
+ * calling thread, the others in their own threads. If a thread can't be
+ * started, its boards are rated on the calling thread instead.
+ *
+ * The grid size has to be supported by TGomokuLineEvaluator.
+ */
+class CGomokuBatchEvaluator : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuBatchEvaluator();
+
+	/**
+	 * Two-phased constructor. Leaves with KErrNotSupported if the line
+	 * evaluator does not support the grid size.
+	 *
+	 * \param aGridSize size of the boards.
+	 * \param aPairCheck ETrue if pair check is activated.
+	 * \param aMyWeight weight of the own rating of a segment, like the
+	 * personality of the segment based AIs.
+	 * \param aEnemyWeight weight of the enemy rating of a segment.
+	 */
+	static CGomokuBatchEvaluator* NewL(TSize aGridSize, TBool aPairCheck,
+			TInt aMyWeight, TInt aEnemyWeight);
+
+public:
+	/**
+	 * Set the number of threads.
+	 *
+	 * \param aThreads 1 to KBatchMaxThreads, default 1.
+	 */
+	void SetThreadsL(TInt aThreads);
+
+	/**
+	 * Rate a batch of boards. Leaves with KErrArgument if the length of
+	 * aBoards is not a multiple of the size of a packed board.
+	 *
+	 * \param aBoards packed boards, see CGomokuBoard::Pack().
+	 * \param aMyColor color of the player for whom the boards are rated.
+	 * The opponent moves next.
+	 * \param aScores receives the rating of every board, higher is better
+	 * for aMyColor.
+	 * \param aCellRatings NULL, or receives a rating for every cell of
+	 * every board (board by board, row by row), like the rating grid of the
+	 * AI: the rating of the board after a move of aMyColor on the cell, or
+	 * KBatchTakenCell if the cell is occupied.
+	 */
+	void EvaluateL(const TDesC8& aBoards, eCellColor aMyColor, TInt* aScores,
+			TInt* aCellRatings = NULL);
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuBatchEvaluator(TSize aGridSize, TBool aPairCheck);
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL(TInt aMyWeight, TInt aEnemyWeight);
+
+private:
+	/**
+	 * Size of the boards.
+	 */
+	TSize iGridSize;
+
+	/**
+	 * ETrue if pair check is activated.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Rating of a segment for 0 to 5 own stones.
+	 */
+	TInt iMyRating[KSegmentCells + 1];
+
+	/**
+	 * Rating of a segment for 0 to 5 enemy stones.
+	 */
+	TInt iEnemyRating[KSegmentCells + 1];
+
+	/**
+	 * The workers, iThreads of them are created. Owned.
+	 */
+	CGomokuBatchWorker* iWorkers[KBatchMaxThreads];
+
+	/**
+	 * Number of workers.
+	 */
+	TInt iThreads;
+	};
+
+#endif /*GOMOKUBATCHEVALUATOR_H_*/
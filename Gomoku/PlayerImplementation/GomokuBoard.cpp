@@ -0,0 +1,259 @@
+/*
+ ============================================================================
+ Name		 : GomokuBoard.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuBoard implementation
+ ============================================================================
+ */
+
+#include "GomokuBoard.h"
+
+CGomokuBoard::CGomokuBoard()
+	{
+	// No implementation required
+	}
+
+CGomokuBoard::~CGomokuBoard()
+	{
+	DeleteBoard();
+	}
+
+CGomokuBoard* CGomokuBoard::NewL()
+	{
+	CGomokuBoard* self = new (ELeave) CGomokuBoard();
+	return self;
+	}
+
+void CGomokuBoard::ResizeL(TSize aSize)
+	{
+	DeleteBoard();
+	iCols = aSize.iWidth;
+	iRows = aSize.iHeight;
+	const TInt numCells = iCols * iRows;
+	// Captures free cells again, so a game can have more moves than
+	// cells. Every captured pair needs two moves of the opponent, though.
+	iMaxMoves = numCells * 2;
+	iCells = new (ELeave) TUint8[numCells];
+	iMoves = new (ELeave) TMoveEntry[iMaxMoves];
+	iCapturedCells = new (ELeave) TInt16[iMaxMoves];
+	Mem::FillZ(iCells, numCells);
+	iMoveCount = 0;
+	iCapturedCount = 0;
+	iCapturedPairs[0] = 0;
+	iCapturedPairs[1] = 0;
+	iRemainingFreeCells = numCells;
+	}
+
+void CGomokuBoard::DeleteBoard()
+	{
+	delete[] iCells;
+	iCells = NULL;
+	delete[] iMoves;
+	iMoves = NULL;
+	delete[] iCapturedCells;
+	iCapturedCells = NULL;
+	}
+
+void CGomokuBoard::CopyFrom(const CGrid* aGrid)
+	{
+	__ASSERT_ALWAYS(aGrid->GetCols() == iCols && aGrid->GetRows() == iRows,
+			User::Panic(_L("Error: Board size does not match."), -101));
+	iRemainingFreeCells = 0;
+	TUint8* cell = iCells;
+	for (TInt y = 0; y < iRows; y++)
+		{
+		for (TInt x = 0; x < iCols; x++)
+			{
+			*cell = (TUint8) aGrid->GetGridCell(x, y)->GetColor();
+			if (*cell == EColorNeutral)
+				{
+				iRemainingFreeCells++;
+				}
+			cell++;
+			}
+		}
+	iMoveCount = 0;
+	iCapturedCount = 0;
+	iCapturedPairs[0] = 0;
+	iCapturedPairs[1] = 0;
+	}
+
+void CGomokuBoard::CopyFrom(const TUint8* aPacked)
+	{
+	const TInt numCells = iCols * iRows;
+	iRemainingFreeCells = 0;
+	for (TInt i = 0; i < numCells; i++)
+		{
+		const TInt shift = (i % KBoardCellsPerPackedByte) * 2;
+		iCells[i] = (TUint8) ((aPacked[i / KBoardCellsPerPackedByte] >> shift)
+				& 3);
+		__ASSERT_DEBUG(iCells[i] <= EColor2, User::Invariant());
+		if (iCells[i] == EColorNeutral)
+			{
+			iRemainingFreeCells++;
+			}
+		}
+	iMoveCount = 0;
+	iCapturedCount = 0;
+	iCapturedPairs[0] = 0;
+	iCapturedPairs[1] = 0;
+	}
+
+void CGomokuBoard::Pack(const CGrid* aGrid, TDes8& aPacked)
+	{
+	const TInt cols = aGrid->GetCols();
+	const TInt numCells = cols * aGrid->GetRows();
+	TUint8 packed = 0;
+	for (TInt i = 0; i < numCells; i++)
+		{
+		const TInt shift = (i % KBoardCellsPerPackedByte) * 2;
+		packed |= (TUint8) (aGrid->GetGridCell(i % cols, i / cols)->GetColor()
+				<< shift);
+		if (i % KBoardCellsPerPackedByte == KBoardCellsPerPackedByte - 1
+				|| i == numCells - 1)
+			{
+			aPacked.Append(packed);
+			packed = 0;
+			}
+		}
+	}
+
+TInt CGomokuBoard::PackedSize(TSize aSize)
+	{
+	return (aSize.iWidth * aSize.iHeight + KBoardCellsPerPackedByte - 1)
+			/ KBoardCellsPerPackedByte;
+	}
+
+TInt CGomokuBoard::MakeMove(TInt aX, TInt aY, eCellColor aColor,
+		TBool aPairCheck)
+	{
+	__ASSERT_DEBUG(iMoveCount < iMaxMoves && aColor != EColorNeutral,
+			User::Panic(_L("CGomokuBoard"), -102));
+	const TInt index = Index(aX, aY);
+	iCells[index] = (TUint8) aColor;
+	iRemainingFreeCells--;
+
+	TInt numPairsRemoved = 0;
+	if (aPairCheck)
+		{
+		const eCellColor enemyColor = Opponent(aColor);
+		// Go in all directions, same as CGrid::SetGridCell().
+		for (TInt dx = -1; dx <= 1; dx++)
+			{
+			for (TInt dy = -1; dy <= 1; dy++)
+				{
+				if ((dx != 0 || dy != 0) && FindPair(aX, aY, dx, dy, aColor,
+						enemyColor))
+					{
+					// Remove both enemy stones and remember where they were.
+					const TInt first = Index(aX + dx, aY + dy);
+					const TInt second = Index(aX + dx * 2, aY + dy * 2);
+					iCells[first] = EColorNeutral;
+					iCells[second] = EColorNeutral;
+					iCapturedCells[iCapturedCount++] = (TInt16) first;
+					iCapturedCells[iCapturedCount++] = (TInt16) second;
+					iRemainingFreeCells += 2;
+					numPairsRemoved++;
+					}
+				}
+			}
+		iCapturedPairs[aColor - EColor1] += numPairsRemoved;
+		}
+
+	TMoveEntry& entry = iMoves[iMoveCount++];
+	entry.iIndex = (TInt16) index;
+	entry.iCaptures = (TUint8) numPairsRemoved;
+	entry.iColor = (TUint8) aColor;
+	return numPairsRemoved;
+	}
+
+void CGomokuBoard::UndoMove()
+	{
+	__ASSERT_DEBUG(iMoveCount > 0, User::Panic(_L("CGomokuBoard"), -103));
+	const TMoveEntry& entry = iMoves[--iMoveCount];
+	const eCellColor color = (eCellColor) entry.iColor;
+	if (entry.iCaptures > 0)
+		{
+		// Put the captured enemy stones back on the board.
+		const TUint8 enemyColor = (TUint8) Opponent(color);
+		for (TInt i = 0; i < entry.iCaptures * 2; i++)
+			{
+			iCells[iCapturedCells[--iCapturedCount]] = enemyColor;
+			}
+		iRemainingFreeCells -= entry.iCaptures * 2;
+		iCapturedPairs[color - EColor1] -= entry.iCaptures;
+		}
+	iCells[entry.iIndex] = EColorNeutral;
+	iRemainingFreeCells++;
+	}
+
+TBool CGomokuBoard::FindPair(TInt aX, TInt aY, TInt aDx, TInt aDy,
+		eCellColor aMyColor, eCellColor aEnemyColor) const
+	{
+	// Only search if the enclosing stone is still in the grid.
+	if (!IsInside(aX + aDx * 3, aY + aDy * 3))
+		{
+		return EFalse;
+		}
+	return (Cell(aX + aDx, aY + aDy) == aEnemyColor
+			&& Cell(aX + aDx * 2, aY + aDy * 2) == aEnemyColor
+			&& Cell(aX + aDx * 3, aY + aDy * 3) == aMyColor);
+	}
+
+TBool CGomokuBoard::CapturesPair(TInt aX, TInt aY, eCellColor aColor) const
+	{
+	const eCellColor enemyColor = Opponent(aColor);
+	for (TInt dx = -1; dx <= 1; dx++)
+		{
+		for (TInt dy = -1; dy <= 1; dy++)
+			{
+			if ((dx != 0 || dy != 0) && FindPair(aX, aY, dx, dy, aColor,
+					enemyColor))
+				{
+				return ETrue;
+				}
+			}
+		}
+	return EFalse;
+	}
+
+TInt CGomokuBoard::CountDirection(TInt aX, TInt aY, TInt aDx, TInt aDy,
+		eCellColor aColor) const
+	{
+	TInt count = 0;
+	aX += aDx;
+	aY += aDy;
+	while (IsInside(aX, aY) && Cell(aX, aY) == aColor)
+		{
+		count++;
+		aX += aDx;
+		aY += aDy;
+		}
+	return count;
+	}
+
+TBool CGomokuBoard::IsFive(TInt aX, TInt aY, eCellColor aColor) const
+	{
+	// Horizontal, vertical and both diagonal directions.
+	const TInt KDirX[4] =
+		{1, 0, 1, 1};
+	const TInt KDirY[4] =
+		{0, 1, 1, -1};
+	for (TInt dir = 0; dir < 4; dir++)
+		{
+		const TInt inRow = 1
+				+ CountDirection(aX, aY, KDirX[dir], KDirY[dir], aColor)
+				+ CountDirection(aX, aY, -KDirX[dir], -KDirY[dir], aColor);
+		if (inRow >= 5)
+			{
+			return ETrue;
+			}
+		}
+	return EFalse;
+	}
@@ -0,0 +1,367 @@
+/*
+ ============================================================================
+ Name		 : GomokuBoard.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Lightweight game board with undo support, used by the
+               search algorithms of the AI implementations.
+ ============================================================================
+ */
+
+#ifndef GOMOKUBOARD_H_
+#define GOMOKUBOARD_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+
+/**
+ * Number of cells per byte of a packed board. Every cell is stored as its
+ * eCellColor in 2 bits, the first cell of a byte in the lowest bits.
+ */
+const TInt KBoardCellsPerPackedByte = 4;
+
+// CLASS DECLARATION
+
+/**
+ * Compact copy of the game grid that search algorithms can modify
+ * millions of times per turn.
+ *
+ * CGrid is a UI control and can only undo a move by copying the whole
+ * grid again if pairs have been captured. This board follows exactly the
+ * same rules as CGrid::SetGridCell() (pair capture) and CGrid::WinnerCheck()
+ * (five in a row), but remembers every move and every captured pair, so
+ * that UndoMove() can restore the previous state in constant time.
+ *
+ * The cells are stored row by row in one array. Use Index() to convert
+ * coordinates to the position in that array.
+ */
+class CGomokuBoard : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuBoard();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuBoard* NewL();
+
+public:
+	/**
+	 * Delete the old board and create an empty one with the specified size.
+	 * \param aSize number of columns and rows of the new board.
+	 */
+	void ResizeL(TSize aSize);
+
+	/**
+	 * Initialize this board with the contents of the provided grid.
+	 * Clears the undo history and the number of captured pairs.
+	 * The sizes of the board and the grid have to match.
+	 *
+	 * \param aGrid grid to copy from.
+	 */
+	void CopyFrom(const CGrid* aGrid);
+
+	/**
+	 * Initialize this board with a packed board, see PackedSize().
+	 * Clears the undo history and the number of captured pairs.
+	 *
+	 * \param aPacked cells of a board of the same size, row by row.
+	 */
+	void CopyFrom(const TUint8* aPacked);
+
+	/**
+	 * Append the cells of the grid to aPacked, row by row and
+	 * KBoardCellsPerPackedByte cells per byte. aPacked needs space for
+	 * PackedSize() more bytes.
+	 */
+	static void Pack(const CGrid* aGrid, TDes8& aPacked);
+
+	/**
+	 * \return number of bytes of a packed board of this size.
+	 */
+	static TInt PackedSize(TSize aSize);
+
+	/**
+	 * Set the cell at the specified position to the specified color.
+	 * Also takes care of the pair check, exactly like CGrid::SetGridCell().
+	 * The move can be taken back through UndoMove().
+	 *
+	 * \param aX column of the cell.
+	 * \param aY row of the cell.
+	 * \param aColor color of the stone to place. May not be neutral.
+	 * \param aPairCheck ETrue if captured pairs should be removed.
+	 * \return the number of pairs that were removed.
+	 */
+	TInt MakeMove(TInt aX, TInt aY, eCellColor aColor, TBool aPairCheck);
+
+	/**
+	 * Take back the last move made through MakeMove(), including
+	 * all pairs that it captured.
+	 */
+	void UndoMove();
+
+	/**
+	 * Check if the stone at the specified position is part of five
+	 * (or more) stones of the specified color in a row.
+	 * Same rule as CGrid::WinnerCheck().
+	 *
+	 * \param aX column to check.
+	 * \param aY row to check.
+	 * \param aColor color to check for.
+	 * \return ETrue if the specified color owns five cells in a row
+	 * through this position.
+	 */
+	TBool IsFive(TInt aX, TInt aY, eCellColor aColor) const;
+
+	/**
+	 * Check if placing a stone of the specified color at the specified
+	 * (free) position would capture at least one pair of the opponent.
+	 * Does not modify the board.
+	 */
+	TBool CapturesPair(TInt aX, TInt aY, eCellColor aColor) const;
+
+	/**
+	 * Number of pairs that the specified color has captured on this board
+	 * since the last call to CopyFrom().
+	 */
+	inline TInt CapturedPairs(eCellColor aColor) const;
+
+	/**
+	 * Set the number of pairs that the specified color has already captured
+	 * in the game, e.g. when the board is copied from a running game.
+	 */
+	inline void SetCapturedPairs(eCellColor aColor, TInt aPairs);
+
+	/**
+	 * Position of a stone that was captured by the last move.
+	 * The last move captured two stones for every pair returned by MakeMove().
+	 *
+	 * \param aNumber number of the captured stone, starting with 0.
+	 */
+	inline TInt LastCapturedCell(TInt aNumber) const;
+
+	/**
+	 * Number of moves that can currently be taken back.
+	 */
+	inline TInt MoveCount() const;
+
+	/**
+	 * Maximum number of moves that can be made before the history is full.
+	 */
+	inline TInt MaxMoves() const;
+
+	/**
+	 * Number of free (neutral) cells on the board.
+	 */
+	inline TInt RemainingFreeCells() const;
+
+	inline TInt Cols() const;
+	inline TInt Rows() const;
+
+	/**
+	 * Total number of cells (columns * rows).
+	 */
+	inline TInt NumCells() const;
+
+	/**
+	 * Position of the specified cell in the cell array.
+	 */
+	inline TInt Index(TInt aX, TInt aY) const;
+
+	/**
+	 * ETrue if the coordinates are inside of the board.
+	 */
+	inline TBool IsInside(TInt aX, TInt aY) const;
+
+	/**
+	 * Color of the cell at the specified coordinates.
+	 */
+	inline eCellColor Cell(TInt aX, TInt aY) const;
+
+	/**
+	 * Color of the cell at the specified position of the cell array.
+	 */
+	inline eCellColor CellAt(TInt aIndex) const;
+
+	/**
+	 * The color of the other player.
+	 */
+	static inline eCellColor Opponent(eCellColor aColor);
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuBoard();
+
+	/**
+	 * Delete all arrays owned by the board.
+	 */
+	void DeleteBoard();
+
+	/**
+	 * Check for a pair of enemy stones in the specified direction that
+	 * is enclosed by the own color. See CGrid::FindPairs().
+	 */
+	TBool FindPair(TInt aX, TInt aY, TInt aDx, TInt aDy,
+			eCellColor aMyColor, eCellColor aEnemyColor) const;
+
+	/**
+	 * Count the stones of the specified color next to the position,
+	 * going into the specified direction (not counting the position itself).
+	 */
+	TInt CountDirection(TInt aX, TInt aY, TInt aDx, TInt aDy,
+			eCellColor aColor) const;
+
+private:
+	/**
+	 * One entry in the move history.
+	 */
+	struct TMoveEntry
+		{
+		/** Position of the placed stone in the cell array. */
+		TInt16 iIndex;
+		/** Number of pairs captured by this move. */
+		TUint8 iCaptures;
+		/** Color of the placed stone. */
+		TUint8 iColor;
+		};
+
+	/**
+	 * Columns (width, x) of the board.
+	 */
+	TInt iCols;
+
+	/**
+	 * Rows (height, y) of the board.
+	 */
+	TInt iRows;
+
+	/**
+	 * Colors of all cells, stored row by row.
+	 */
+	TUint8* iCells;
+
+	/**
+	 * History of all moves, required to undo them.
+	 */
+	TMoveEntry* iMoves;
+
+	/**
+	 * Number of entries in the move history.
+	 */
+	TInt iMoveCount;
+
+	/**
+	 * Capacity of the move history.
+	 */
+	TInt iMaxMoves;
+
+	/**
+	 * Positions of all captured stones, in the order of the moves that
+	 * captured them (two entries per pair).
+	 */
+	TInt16* iCapturedCells;
+
+	/**
+	 * Number of entries in the captured cells history.
+	 */
+	TInt iCapturedCount;
+
+	/**
+	 * Captured pairs of both players, index 0 for EColor1.
+	 */
+	TInt iCapturedPairs[2];
+
+	/**
+	 * How many cells are still empty.
+	 */
+	TInt iRemainingFreeCells;
+	};
+
+// INLINE METHODS
+
+inline TInt CGomokuBoard::CapturedPairs(eCellColor aColor) const
+	{
+	return iCapturedPairs[aColor - EColor1];
+	}
+
+inline void CGomokuBoard::SetCapturedPairs(eCellColor aColor, TInt aPairs)
+	{
+	iCapturedPairs[aColor - EColor1] = aPairs;
+	}
+
+inline TInt CGomokuBoard::LastCapturedCell(TInt aNumber) const
+	{
+	return iCapturedCells[iCapturedCount - 1 - aNumber];
+	}
+
+inline TInt CGomokuBoard::MoveCount() const
+	{
+	return iMoveCount;
+	}
+
+inline TInt CGomokuBoard::MaxMoves() const
+	{
+	return iMaxMoves;
+	}
+
+inline TInt CGomokuBoard::RemainingFreeCells() const
+	{
+	return iRemainingFreeCells;
+	}
+
+inline TInt CGomokuBoard::Cols() const
+	{
+	return iCols;
+	}
+
+inline TInt CGomokuBoard::Rows() const
+	{
+	return iRows;
+	}
+
+inline TInt CGomokuBoard::NumCells() const
+	{
+	return iCols * iRows;
+	}
+
+inline TInt CGomokuBoard::Index(TInt aX, TInt aY) const
+	{
+	return aY * iCols + aX;
+	}
+
+inline TBool CGomokuBoard::IsInside(TInt aX, TInt aY) const
+	{
+	return (aX >= 0 && aX < iCols && aY >= 0 && aY < iRows);
+	}
+
+inline eCellColor CGomokuBoard::Cell(TInt aX, TInt aY) const
+	{
+	return (eCellColor) iCells[aY * iCols + aX];
+	}
+
+inline eCellColor CGomokuBoard::CellAt(TInt aIndex) const
+	{
+	return (eCellColor) iCells[aIndex];
+	}
+
+inline eCellColor CGomokuBoard::Opponent(eCellColor aColor)
+	{
+	return (aColor == EColor1) ? EColor2 : EColor1;
+	}
+
+#endif /*GOMOKUBOARD_H_*/
@@ -0,0 +1,292 @@
+/*
+ ============================================================================
+ Name		 : GomokuBookBuilder.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuBookBuilder implementation
+ ============================================================================
+ */
+
+#include "GomokuBookBuilder.h"
+
+CGomokuBookBuilder::CGomokuBookBuilder() :
+	iMinGames(KBookDefaultMinGames)
+	{
+	// No implementation required
+	}
+
+CGomokuBookBuilder::~CGomokuBookBuilder()
+	{
+	delete iGrid;
+	iRecords.Close();
+	}
+
+CGomokuBookBuilder* CGomokuBookBuilder::NewL()
+	{
+	CGomokuBookBuilder* self = new (ELeave) CGomokuBookBuilder();
+	CleanupStack::PushL(self);
+	self->ConstructL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuBookBuilder::ConstructL()
+	{
+	iGrid = CGrid::NewL();
+	}
+
+void CGomokuBookBuilder::SetMinGames(TInt aMinGames)
+	{
+	iMinGames = aMinGames;
+	}
+
+void CGomokuBookBuilder::AddGameL(TSize aGridSize, TBool aPairCheck,
+		const TPoint* aMoves, TInt aNumMoves, eCellColor aWinner)
+	{
+	iGrid->ResizeGridL(aGridSize);
+	eCellColor color = EColor1;
+	for (TInt i = 0; i < aNumMoves; i++)
+		{
+		const TPoint move = aMoves[i];
+		if (move.iX < 0 || move.iY < 0 || move.iX >= aGridSize.iWidth
+				|| move.iY >= aGridSize.iHeight || !iGrid->GetGridCell(
+				move.iX, move.iY)->IsFree())
+			{
+			User::Leave(KErrCorrupt);
+			}
+		if (TGomokuBookHash::CountStones(iGrid) > KBookMaxStones)
+			{
+			break;
+			}
+		TInt cell;
+		const TUint64 key = TGomokuBookHash::CanonicalMove(iGrid, color,
+				aPairCheck, move, cell);
+		AddMoveL(key, cell, 1, (aWinner == color) ? 1 : 0,
+				(aWinner == EColorNeutral) ? 1 : 0);
+
+		iGrid->SetGridCell(move.iX, move.iY, color, aPairCheck);
+		color = (color == EColor1) ? EColor2 : EColor1;
+		}
+	}
+
+void CGomokuBookBuilder::AddMoveL(TUint64 aKey, TInt aCell, TInt aGames,
+		TInt aWins, TInt aDraws)
+	{
+	// The records are merged when the book is written: sorting once is
+	// much faster than keeping millions of records sorted.
+	TGomokuBookRecord record;
+	record.iKey = aKey;
+	record.iCell = aCell;
+	record.iGames = aGames;
+	record.iWins = aWins;
+	record.iDraws = aDraws;
+	record.iWeight = 0;
+	iRecords.AppendL(record);
+	}
+
+void CGomokuBookBuilder::AddBookL(RFs& aFs, const TDesC& aFileName)
+	{
+	RFile file;
+	User::LeaveIfError(file.Open(aFs, aFileName, EFileRead
+			| EFileShareReadersOnly));
+	CleanupClosePushL(file);
+	TInt size;
+	User::LeaveIfError(file.Size(size));
+	HBufC8* book = HBufC8::NewLC(size);
+	TPtr8 bookPtr = book->Des();
+	User::LeaveIfError(file.Read(bookPtr));
+	if (bookPtr.Length() < KBookHeaderSize)
+		{
+		User::Leave(KErrCorrupt);
+		}
+
+	const TUint8* ptr = bookPtr.Ptr();
+	const TInt numPositions = (TInt) CGomokuOpeningBook::Get32(ptr + 8);
+	const TInt numMoves = (TInt) CGomokuOpeningBook::Get32(ptr + 12);
+	if (CGomokuOpeningBook::Get32(ptr) != KBookMagic
+			|| CGomokuOpeningBook::Get32(ptr + 4) != KBookVersion
+			|| numPositions < 0 || numMoves < 0 || bookPtr.Length()
+			!= KBookHeaderSize + numPositions * KBookPositionSize + numMoves
+					* KBookMoveSize)
+		{
+		User::Leave(KErrCorrupt);
+		}
+	const TUint8* moves = ptr + KBookHeaderSize + numPositions
+			* KBookPositionSize;
+	for (TInt i = 0; i < numPositions; i++)
+		{
+		const TUint8* position = ptr + KBookHeaderSize + i * KBookPositionSize;
+		const TUint64 key = ((TUint64) CGomokuOpeningBook::Get32(position)
+				<< 32) | CGomokuOpeningBook::Get32(position + 4);
+		const TInt firstMove = (TInt) CGomokuOpeningBook::Get32(position + 8);
+		const TInt count = (TInt) CGomokuOpeningBook::Get32(position + 12);
+		if (firstMove < 0 || count < 0 || firstMove + count > numMoves)
+			{
+			User::Leave(KErrCorrupt);
+			}
+		for (TInt j = firstMove; j < firstMove + count; j++)
+			{
+			const TUint8* move = moves + j * KBookMoveSize;
+			AddMoveL(key, (TInt) (CGomokuOpeningBook::Get32(move) & 0xFFFF),
+					(TInt) CGomokuOpeningBook::Get32(move + 4),
+					(TInt) CGomokuOpeningBook::Get32(move + 8),
+					(TInt) CGomokuOpeningBook::Get32(move + 12));
+			}
+		}
+
+	CleanupStack::PopAndDestroy(2); // book, file
+	}
+
+TInt CGomokuBookBuilder::WriteL(RFs& aFs, const TDesC& aFileName)
+	{
+	MergeRecords();
+
+	// Count the positions and moves that are stored.
+	TInt numPositions = 0;
+	TInt numMoves = 0;
+	TUint64 lastKey = 0;
+	TInt i;
+	for (i = 0; i < iRecords.Count(); i++)
+		{
+		if (iRecords[i].iGames >= iMinGames)
+			{
+			if (numMoves == 0 || iRecords[i].iKey != lastKey)
+				{
+				numPositions++;
+				lastKey = iRecords[i].iKey;
+				}
+			numMoves++;
+			}
+		}
+
+	RFile file;
+	User::LeaveIfError(file.Replace(aFs, aFileName, EFileWrite));
+	CleanupClosePushL(file);
+
+	TUint8 header[KBookHeaderSize];
+	CGomokuOpeningBook::Put32(header, KBookMagic);
+	CGomokuOpeningBook::Put32(header + 4, KBookVersion);
+	CGomokuOpeningBook::Put32(header + 8, (TUint32) numPositions);
+	CGomokuOpeningBook::Put32(header + 12, (TUint32) numMoves);
+	User::LeaveIfError(file.Write(TPtrC8(header, KBookHeaderSize)));
+
+	// Positions
+	TUint8 position[KBookPositionSize];
+	TInt firstMove = 0;
+	i = 0;
+	while (i < iRecords.Count())
+		{
+		const TUint64 key = iRecords[i].iKey;
+		TInt stored = 0;
+		for (; i < iRecords.Count() && iRecords[i].iKey == key; i++)
+			{
+			if (iRecords[i].iGames >= iMinGames)
+				{
+				stored++;
+				}
+			}
+		if (stored > 0)
+			{
+			CGomokuOpeningBook::Put32(position, (TUint32) (key >> 32));
+			CGomokuOpeningBook::Put32(position + 4, (TUint32) key);
+			CGomokuOpeningBook::Put32(position + 8, (TUint32) firstMove);
+			CGomokuOpeningBook::Put32(position + 12, (TUint32) stored);
+			User::LeaveIfError(file.Write(TPtrC8(position, KBookPositionSize)));
+			firstMove += stored;
+			}
+		}
+
+	// Moves, sorted by their weight within each position
+	TUint8 move[KBookMoveSize];
+	for (i = 0; i < iRecords.Count(); i++)
+		{
+		const TGomokuBookRecord& record = iRecords[i];
+		if (record.iGames >= iMinGames)
+			{
+			CGomokuOpeningBook::Put32(move, (TUint32) record.iCell
+					| ((TUint32) record.iWeight << 16));
+			CGomokuOpeningBook::Put32(move + 4, (TUint32) record.iGames);
+			CGomokuOpeningBook::Put32(move + 8, (TUint32) record.iWins);
+			CGomokuOpeningBook::Put32(move + 12, (TUint32) record.iDraws);
+			User::LeaveIfError(file.Write(TPtrC8(move, KBookMoveSize)));
+			}
+		}
+
+	CleanupStack::PopAndDestroy(); // file
+	return numPositions;
+	}
+
+void CGomokuBookBuilder::MergeRecords()
+	{
+	iRecords.Sort(TLinearOrder<TGomokuBookRecord> (CompareRecords));
+
+	// Merge the statistics of the same move of a position.
+	TInt count = 0;
+	TInt i;
+	for (i = 0; i < iRecords.Count(); i++)
+		{
+		if (count > 0 && iRecords[count - 1].iKey == iRecords[i].iKey
+				&& iRecords[count - 1].iCell == iRecords[i].iCell)
+			{
+			iRecords[count - 1].iGames += iRecords[i].iGames;
+			iRecords[count - 1].iWins += iRecords[i].iWins;
+			iRecords[count - 1].iDraws += iRecords[i].iDraws;
+			}
+		else
+			{
+			iRecords[count++] = iRecords[i];
+			}
+		}
+	while (iRecords.Count() > count)
+		{
+		iRecords.Remove(iRecords.Count() - 1);
+		}
+
+	// The weight is the score of the move, with one draw added so that
+	// a single won game isn't rated as a sure win.
+	for (i = 0; i < count; i++)
+		{
+		TGomokuBookRecord& record = iRecords[i];
+		record.iWeight = (TInt) ((TInt64) KBookMaxWeight * (2 * record.iWins
+				+ record.iDraws + 1) / (2 * record.iGames + 2));
+		}
+
+	// Sort the moves of each position by their weight (insertion sort,
+	// a position only has a few moves).
+	TInt start = 0;
+	while (start < count)
+		{
+		TInt end = start + 1;
+		while (end < count && iRecords[end].iKey == iRecords[start].iKey)
+			{
+			end++;
+			}
+		for (i = start + 1; i < end; i++)
+			{
+			const TGomokuBookRecord record = iRecords[i];
+			TInt j = i;
+			while (j > start && iRecords[j - 1].iWeight < record.iWeight)
+				{
+				iRecords[j] = iRecords[j - 1];
+				j--;
+				}
+			iRecords[j] = record;
+			}
+		start = end;
+		}
+	}
+
+TInt CGomokuBookBuilder::CompareRecords(const TGomokuBookRecord& aFirst,
+		const TGomokuBookRecord& aSecond)
+	{
+	if (aFirst.iKey != aSecond.iKey)
+		{
+		return (aFirst.iKey < aSecond.iKey) ? -1 : 1;
+		}
+	return aFirst.iCell - aSecond.iCell;
+	}
@@ -0,0 +1,191 @@
+/*
+ ============================================================================
+ Name		 : GomokuBookBuilder.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Compiles an opening book from the moves and results of
+               finished games.
+ ============================================================================
+ */
+
+#ifndef GOMOKUBOOKBUILDER_H_
+#define GOMOKUBOOKBUILDER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <f32file.h>
+#include "Grid.h"
+#include "GomokuOpeningBook.h"
+
+/**
+ * Default number of games in which a move has to be played to be stored
+ * in the book.
+ */
+const TInt KBookDefaultMinGames = 2;
+
+// CLASS DECLARATION
+
+/**
+ * Statistics of a move in a position, collected by the book builder.
+ */
+class TGomokuBookRecord
+	{
+public:
+	/**
+	 * Canonical key of the position.
+	 */
+	TUint64 iKey;
+
+	/**
+	 * Cell of the move in the canonical position (y * columns + x).
+	 */
+	TInt iCell;
+
+	/**
+	 * Number of games in which the move was played.
+	 */
+	TInt iGames;
+
+	/**
+	 * Number of these games that the player of the move won.
+	 */
+	TInt iWins;
+
+	/**
+	 * Number of these games that ended in a draw.
+	 */
+	TInt iDraws;
+
+	/**
+	 * Weight of the move, calculated when the book is written.
+	 */
+	TInt iWeight;
+	};
+
+/**
+ * Creates opening book files for CGomokuOpeningBook.
+ *
+ * Every game is replayed and each move of the first KBookMaxStones stones
+ * is counted for its position (in the canonical symmetry, see
+ * TGomokuBookHash), together with the result of the game. Games of all grid
+ * sizes and with and without pair check can be mixed in one book.
+ *
+ * When the book is written, the statistics of the same move are merged and
+ * every move gets a weight from its score (a win counts 1, a draw 1/2),
+ * moves that were played in fewer than the minimum number of games are left
+ * out. The positions are sorted by their key and the moves of a position
+ * by their weight.
+ */
+class CGomokuBookBuilder : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuBookBuilder();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuBookBuilder* NewL();
+
+public:
+	/**
+	 * Set the number of games in which a move has to be played to be stored
+	 * in the book. KBookDefaultMinGames by default.
+	 */
+	void SetMinGames(TInt aMinGames);
+
+	/**
+	 * Add the moves of a finished game. The first move is made by EColor1.
+	 * Leaves with KErrCorrupt if a move is not possible.
+	 *
+	 * \param aGridSize size of the grid of the game.
+	 * \param aPairCheck ETrue if pair check was activated in the game.
+	 * \param aMoves moves of the game.
+	 * \param aNumMoves number of moves.
+	 * \param aWinner color of the winner, EColorNeutral for a draw.
+	 */
+	void AddGameL(TSize aGridSize, TBool aPairCheck, const TPoint* aMoves,
+			TInt aNumMoves, eCellColor aWinner);
+
+	/**
+	 * Add statistics of a move of a position.
+	 *
+	 * \param aKey canonical key of the position.
+	 * \param aCell cell of the move in the canonical position.
+	 * \param aGames number of games in which the move was played.
+	 * \param aWins number of these games that the player of the move won.
+	 * \param aDraws number of these games that ended in a draw.
+	 */
+	void AddMoveL(TUint64 aKey, TInt aCell, TInt aGames, TInt aWins,
+			TInt aDraws);
+
+	/**
+	 * Add the statistics of all moves of an existing book, e.g. to merge new
+	 * games into it. Leaves with KErrCorrupt if the file is not a valid book.
+	 *
+	 * \param aFs session with the file server.
+	 * \param aFileName complete name of the book file.
+	 */
+	void AddBookL(RFs& aFs, const TDesC& aFileName);
+
+	/**
+	 * Write the book.
+	 *
+	 * \param aFs session with the file server.
+	 * \param aFileName complete name of the book file, an existing file
+	 * is replaced.
+	 * \return number of positions in the book.
+	 */
+	TInt WriteL(RFs& aFs, const TDesC& aFileName);
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuBookBuilder();
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Sort the records by position and move, merge the statistics of the
+	 * same moves and calculate the weights.
+	 */
+	void MergeRecords();
+
+	/**
+	 * Order of the records: by key, then by cell.
+	 */
+	static TInt CompareRecords(const TGomokuBookRecord& aFirst,
+			const TGomokuBookRecord& aSecond);
+
+private:
+	/**
+	 * Grid to replay the games.
+	 */
+	CGrid* iGrid;
+
+	/**
+	 * Statistics of the moves, not merged before MergeRecords().
+	 */
+	RArray<TGomokuBookRecord> iRecords;
+
+	/**
+	 * Number of games in which a move has to be played to be stored.
+	 */
+	TInt iMinGames;
+	};
+
+#endif /*GOMOKUBOOKBUILDER_H_*/
@@ -0,0 +1,203 @@
+/*
+ ============================================================================
+ Name		 : GomokuBookLearner.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuBookLearner implementation
+ ============================================================================
+ */
+
+#include "GomokuBookLearner.h"
+
+CGomokuBookLearner::CGomokuBookLearner()
+	{
+	// No implementation required
+	}
+
+CGomokuBookLearner::~CGomokuBookLearner()
+	{
+	// Results that can't be written are lost, they are not important enough
+	// to keep the player from being deleted.
+	if (iBatch.Count() > 0)
+		{
+		TRAP_IGNORE(FlushL());
+		}
+	iBatch.Close();
+	iFs.Close();
+	}
+
+CGomokuBookLearner* CGomokuBookLearner::NewL()
+	{
+	CGomokuBookLearner* self = new (ELeave) CGomokuBookLearner();
+	CleanupStack::PushL(self);
+	self->ConstructL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuBookLearner::ConstructL()
+	{
+	User::LeaveIfError(iFs.Connect());
+	}
+
+void CGomokuBookLearner::StartGame(TBool aPairCheck)
+	{
+	iPairCheck = aPairCheck;
+	iNumMoves = 0;
+	}
+
+void CGomokuBookLearner::AddMove(const CGrid* aGrid, eCellColor aColor,
+		TPoint aMove)
+	{
+	if (iNumMoves == KBookMaxStones || TGomokuBookHash::CountStones(aGrid)
+			> KBookMaxStones)
+		{
+		return;
+		}
+	TLearnedMove& move = iMoves[iNumMoves++];
+	move.iKey = TGomokuBookHash::CanonicalMove(aGrid, aColor, iPairCheck,
+			aMove, move.iCell);
+	move.iColor = aColor;
+	}
+
+void CGomokuBookLearner::GameOverL(eCellColor aWinner)
+	{
+	for (TInt i = 0; i < iNumMoves; i++)
+		{
+		TGomokuBookRecord record;
+		record.iKey = iMoves[i].iKey;
+		record.iCell = iMoves[i].iCell;
+		record.iGames = 1;
+		record.iWins = (aWinner == iMoves[i].iColor) ? 1 : 0;
+		record.iDraws = (aWinner == EColorNeutral) ? 1 : 0;
+		record.iWeight = 0;
+		iBatch.AppendL(record);
+		}
+	iNumMoves = 0;
+	iBatchGames++;
+
+	if (iBatchGames >= KBookLogBatchGames && FlushL() >= KBookCompactRecords)
+		{
+		CompactL();
+		}
+	}
+
+TInt CGomokuBookLearner::FlushL()
+	{
+	TFileName logName;
+	User::LeaveIfError(CGomokuOpeningBook::GetFileName(iFs, KBookLogFileName,
+			logName));
+	RFile log;
+	TInt err = log.Open(iFs, logName, EFileWrite);
+	if (err == KErrNotFound || err == KErrPathNotFound)
+		{
+		iFs.MkDirAll(logName);
+		err = log.Create(iFs, logName, EFileWrite);
+		}
+	User::LeaveIfError(err);
+	CleanupClosePushL(log);
+
+	TInt size = 0;
+	User::LeaveIfError(log.Seek(ESeekEnd, size));
+	// A record that was cut off (e.g. the battery was removed while writing)
+	// is overwritten.
+	size -= size % KBookLogRecordSize;
+	User::LeaveIfError(log.Seek(ESeekStart, size));
+
+	if (iBatch.Count() > 0)
+		{
+		HBufC8* records = HBufC8::NewLC(iBatch.Count() * KBookLogRecordSize);
+		TPtr8 recordsPtr = records->Des();
+		TUint8 record[KBookLogRecordSize];
+		for (TInt i = 0; i < iBatch.Count(); i++)
+			{
+			const TGomokuBookRecord& move = iBatch[i];
+			CGomokuOpeningBook::Put32(record, (TUint32) (move.iKey >> 32));
+			CGomokuOpeningBook::Put32(record + 4, (TUint32) move.iKey);
+			CGomokuOpeningBook::Put32(record + 8, (TUint32) move.iCell);
+			// Result: 0 lost, 1 draw, 2 won
+			CGomokuOpeningBook::Put32(record + 12, (TUint32) (2 * move.iWins
+					+ move.iDraws));
+			recordsPtr.Append(record, KBookLogRecordSize);
+			}
+		User::LeaveIfError(log.Write(*records));
+		User::LeaveIfError(log.Flush());
+		size += records->Length();
+		CleanupStack::PopAndDestroy(records);
+		}
+	CleanupStack::PopAndDestroy(); // log
+
+	iBatch.Reset();
+	iBatchGames = 0;
+	return size / KBookLogRecordSize;
+	}
+
+void CGomokuBookLearner::CompactL()
+	{
+	TFileName bookName;
+	TFileName logName;
+	TFileName tempName;
+	User::LeaveIfError(CGomokuOpeningBook::GetFileName(iFs, KBookFileName,
+			bookName));
+	User::LeaveIfError(CGomokuOpeningBook::GetFileName(iFs, KBookLogFileName,
+			logName));
+	User::LeaveIfError(CGomokuOpeningBook::GetFileName(iFs,
+			KBookTempFileName, tempName));
+
+	CGomokuBookBuilder* builder = CGomokuBookBuilder::NewL();
+	CleanupStack::PushL(builder);
+	// Every game counts, the book decides which moves are good enough
+	// to be played.
+	builder->SetMinGames(1);
+	TRAPD(err, builder->AddBookL(iFs, bookName));
+	if (err != KErrNone && err != KErrNotFound && err != KErrPathNotFound
+			&& err != KErrCorrupt)
+		{
+		User::Leave(err);
+		}
+	AddLogL(*builder, logName);
+	builder->WriteL(iFs, tempName);
+	CleanupStack::PopAndDestroy(builder);
+
+	// Fails with KErrInUse if the book is still open.
+	err = iFs.Delete(bookName);
+	if (err != KErrNone && err != KErrNotFound)
+		{
+		iFs.Delete(tempName);
+		User::Leave(err);
+		}
+	User::LeaveIfError(iFs.Rename(tempName, bookName));
+	iFs.Delete(logName);
+	}
+
+void CGomokuBookLearner::AddLogL(CGomokuBookBuilder& aBuilder,
+		const TDesC& aFileName)
+	{
+	RFile log;
+	User::LeaveIfError(log.Open(iFs, aFileName, EFileRead
+			| EFileShareReadersOnly));
+	CleanupClosePushL(log);
+	TInt size;
+	User::LeaveIfError(log.Size(size));
+	HBufC8* records = HBufC8::NewLC(size);
+	TPtr8 recordsPtr = records->Des();
+	User::LeaveIfError(log.Read(recordsPtr));
+
+	const TInt numRecords = recordsPtr.Length() / KBookLogRecordSize;
+	for (TInt i = 0; i < numRecords; i++)
+		{
+		const TUint8* record = recordsPtr.Ptr() + i * KBookLogRecordSize;
+		const TUint64 key = ((TUint64) CGomokuOpeningBook::Get32(record) << 32)
+				| CGomokuOpeningBook::Get32(record + 4);
+		const TUint32 result = CGomokuOpeningBook::Get32(record + 12);
+		aBuilder.AddMoveL(key, (TInt) CGomokuOpeningBook::Get32(record + 8), 1,
+				(result == 2) ? 1 : 0, (result == 1) ? 1 : 0);
+		}
+
+	CleanupStack::PopAndDestroy(2); // records, log
+	}
@@ -0,0 +1,180 @@
+/*
+ ============================================================================
+ Name		 : GomokuBookLearner.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Updates the opening book with the results of the games
+               that the AI plays.
+ ============================================================================
+ */
+
+#ifndef GOMOKUBOOKLEARNER_H_
+#define GOMOKUBOOKLEARNER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <f32file.h>
+#include "Grid.h"
+#include "GomokuOpeningBook.h"
+#include "GomokuBookBuilder.h"
+
+/**
+ * Name of the log with the results that are not yet in the book.
+ */
+_LIT(KBookLogFileName, "OpeningBook.log");
+
+/**
+ * Temporary name of the book while it is rewritten.
+ */
+_LIT(KBookTempFileName, "OpeningBook.tmp");
+
+/**
+ * Size of a log record in bytes: key (2 words), cell, result.
+ */
+const TInt KBookLogRecordSize = 16;
+
+/**
+ * Results of games are collected in memory and written to the log after
+ * this number of games (or when the learner is deleted).
+ */
+const TInt KBookLogBatchGames = 4;
+
+/**
+ * The log is merged into the book when it has this number of records.
+ */
+const TInt KBookCompactRecords = 1024;
+
+// CLASS DECLARATION
+
+/**
+ * Learns the opening book from the games of the AI.
+ *
+ * The AI reports its moves and the result of the game. The moves of the
+ * first KBookMaxStones stones are appended to a log file in the private
+ * directory, together with the result. Rewriting the sorted book after
+ * every game would be too slow, therefore the log is merged into the book
+ * by CGomokuBookBuilder only once it has KBookCompactRecords records.
+ *
+ * The book must not be open while it is compacted. If another player still
+ * has it open, compacting fails and is tried again after the next batch.
+ */
+class CGomokuBookLearner : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor. Writes the collected results to the log.
+	 */
+	~CGomokuBookLearner();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuBookLearner* NewL();
+
+public:
+	/**
+	 * Start recording a new game. Moves of an unfinished game are
+	 * discarded.
+	 *
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 */
+	void StartGame(TBool aPairCheck);
+
+	/**
+	 * Record a move of the AI.
+	 *
+	 * \param aGrid the position before the move.
+	 * \param aColor color of the AI.
+	 * \param aMove the move.
+	 */
+	void AddMove(const CGrid* aGrid, eCellColor aColor, TPoint aMove);
+
+	/**
+	 * The recorded game is over. Adds the moves with the result to the
+	 * batch, writes the batch if it is full and compacts the log if it is
+	 * long enough.
+	 *
+	 * \param aWinner color of the winner, EColorNeutral for a draw.
+	 */
+	void GameOverL(eCellColor aWinner);
+
+	/**
+	 * Write the collected results to the log.
+	 *
+	 * \return number of records in the log.
+	 */
+	TInt FlushL();
+
+	/**
+	 * Merge the log into the book.
+	 */
+	void CompactL();
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuBookLearner();
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Add the records of the log to the builder.
+	 */
+	void AddLogL(CGomokuBookBuilder& aBuilder, const TDesC& aFileName);
+
+private:
+	/**
+	 * A move of the current game.
+	 */
+	class TLearnedMove
+		{
+	public:
+		TUint64 iKey;
+		TInt iCell;
+		eCellColor iColor;
+		};
+
+	/**
+	 * Session with the file server.
+	 */
+	RFs iFs;
+
+	/**
+	 * Moves of the current game.
+	 */
+	TLearnedMove iMoves[KBookMaxStones];
+
+	/**
+	 * Number of moves in iMoves.
+	 */
+	TInt iNumMoves;
+
+	/**
+	 * Pair check setting of the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Log records of the finished games that are not written yet.
+	 */
+	RArray<TGomokuBookRecord> iBatch;
+
+	/**
+	 * Number of games in iBatch.
+	 */
+	TInt iBatchGames;
+	};
+
+#endif /*GOMOKUBOOKLEARNER_H_*/
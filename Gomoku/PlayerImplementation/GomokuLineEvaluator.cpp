@@ -0,0 +1,244 @@
+/*
+ ============================================================================
+ Name		 : GomokuLineEvaluator.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : TGomokuLineEvaluator implementation
+ ============================================================================
+ */
+
+#include "GomokuLineEvaluator.h"
+
+TGomokuLineEvaluator::TGomokuLineEvaluator() :
+	iPairPenalty(0), iNumLines(0), iRows(0), iFirstCol(0), iFirstDiagonal1(0),
+			iFirstDiagonal2(0), iCacheLookups(0), iCacheHits(0)
+	{
+	for (TInt i = 0; i <= KSegmentCells; i++)
+		{
+		iMyRating[i] = 0;
+		iEnemyRating[i] = 0;
+		}
+	ClearCache();
+	}
+
+void TGomokuLineEvaluator::SetRatings(const TInt* aMyRating,
+		const TInt* aEnemyRating, TInt aPairPenalty)
+	{
+	for (TInt i = 0; i <= KSegmentCells; i++)
+		{
+		iMyRating[i] = aMyRating[i];
+		iEnemyRating[i] = aEnemyRating[i];
+		}
+	iPairPenalty = aPairPenalty;
+	// The cached ratings are only valid for the old ratings
+	ClearCache();
+	}
+
+TBool TGomokuLineEvaluator::Supports(TSize aGridSize)
+	{
+	return (aGridSize.iWidth >= KSegmentCells && aGridSize.iHeight
+			>= KSegmentCells && aGridSize.iWidth <= KLineMaxCells
+			&& aGridSize.iHeight <= KLineMaxCells);
+	}
+
+TInt TGomokuLineEvaluator::Evaluate(const CGrid* aGrid, eCellColor aMyColor)
+	{
+	ReadBoard(aGrid);
+	return EvaluateLines(aMyColor);
+	}
+
+TInt TGomokuLineEvaluator::Evaluate(const CGomokuBoard& aBoard,
+		eCellColor aMyColor)
+	{
+	ReadBoard(aBoard);
+	return EvaluateLines(aMyColor);
+	}
+
+TInt TGomokuLineEvaluator::EvaluateLines(eCellColor aMyColor)
+	{
+	const TInt mine = aMyColor - EColor1;
+	const TInt enemy = 1 - mine;
+	TInt totalRating = 0;
+	for (TInt line = 0; line < iNumLines; line++)
+		{
+		// Diagonals in the corners are too short for a segment
+		if (iLength[line] >= KSegmentCells)
+			{
+			totalRating += RateLine(iStones[mine][line],
+					iStones[enemy][line], iLength[line]);
+			}
+		}
+	return totalRating;
+	}
+
+void TGomokuLineEvaluator::ClearCache()
+	{
+	for (TInt i = 0; i < KLineCacheSize; i++)
+		{
+		iCache[i].iLength = 0;
+		}
+	}
+
+void TGomokuLineEvaluator::ResetStatistics()
+	{
+	iCacheLookups = 0;
+	iCacheHits = 0;
+	}
+
+TInt TGomokuLineEvaluator::CacheLookups() const
+	{
+	return iCacheLookups;
+	}
+
+TInt TGomokuLineEvaluator::CacheHits() const
+	{
+	return iCacheHits;
+	}
+
+void TGomokuLineEvaluator::ReadBoard(const CGrid* aGrid)
+	{
+	const TInt cols = aGrid->GetCols();
+	const TInt rows = aGrid->GetRows();
+	ClearLines(cols, rows);
+	for (TInt y = 0; y < rows; y++)
+		{
+		for (TInt x = 0; x < cols; x++)
+			{
+			const eCellColor color = aGrid->GetGridCell(x, y)->GetColor();
+			if (color != EColorNeutral)
+				{
+				AddStone(x, y, color);
+				}
+			}
+		}
+	}
+
+void TGomokuLineEvaluator::ReadBoard(const CGomokuBoard& aBoard)
+	{
+	const TInt cols = aBoard.Cols();
+	const TInt rows = aBoard.Rows();
+	ClearLines(cols, rows);
+	for (TInt y = 0; y < rows; y++)
+		{
+		for (TInt x = 0; x < cols; x++)
+			{
+			const eCellColor color = aBoard.Cell(x, y);
+			if (color != EColorNeutral)
+				{
+				AddStone(x, y, color);
+				}
+			}
+		}
+	}
+
+void TGomokuLineEvaluator::ClearLines(TInt aCols, TInt aRows)
+	{
+	const TInt numDiagonals = aCols + aRows - 1;
+
+	// Lines: rows, columns, diagonals down right, diagonals up right
+	iRows = aRows;
+	iFirstCol = aRows;
+	iFirstDiagonal1 = iFirstCol + aCols;
+	iFirstDiagonal2 = iFirstDiagonal1 + numDiagonals;
+	iNumLines = iFirstDiagonal2 + numDiagonals;
+
+	for (TInt y = 0; y < aRows; y++)
+		{
+		iLength[y] = aCols;
+		}
+	for (TInt x = 0; x < aCols; x++)
+		{
+		iLength[iFirstCol + x] = aRows;
+		}
+	for (TInt i = 0; i < numDiagonals; i++)
+		{
+		// Diagonal i down right starts at (max(0, i - rows + 1), max(0, rows - 1 - i)),
+		// diagonal i up right at (max(0, i - rows + 1), min(i, rows - 1)).
+		const TInt startX = Max(0, i - aRows + 1);
+		iLength[iFirstDiagonal1 + i] = Min(aCols - startX, aRows - Max(0,
+				aRows - 1 - i));
+		iLength[iFirstDiagonal2 + i] = Min(aCols - 1, i) - startX + 1;
+		}
+	Mem::FillZ(iStones, sizeof(iStones));
+	}
+
+TInt TGomokuLineEvaluator::RateLine(TUint32 aMine, TUint32 aEnemy,
+		TInt aLength)
+	{
+	// Multiplicative hash of the stones, the highest bits are the best mixed
+	const TUint32 hash = (aMine * 0x9E3779B1u) ^ (aEnemy * 0x85EBCA77u)
+			^ (TUint32) aLength;
+	TGomokuLineCacheEntry& entry = iCache[hash >> (32 - KLineCacheBits)];
+	iCacheLookups++;
+	if (entry.iMine == aMine && entry.iEnemy == aEnemy && entry.iLength
+			== aLength)
+		{
+		iCacheHits++;
+		return entry.iRating;
+		}
+	entry.iMine = aMine;
+	entry.iEnemy = aEnemy;
+	entry.iLength = aLength;
+	entry.iRating = EvaluateLine(aMine, aEnemy, aLength);
+	return entry.iRating;
+	}
+
+TInt TGomokuLineEvaluator::EvaluateLine(TUint32 aMine, TUint32 aEnemy,
+		TInt aLength) const
+	{
+	// Bit n is the segment or pattern that ends at cell n of the line.
+	const TUint32 lineMask = (aLength == KLineMaxCells) ? KMaxTUint
+			: (((TUint32) 1 << aLength) - 1);
+	// Segments start at the first cell, i.e. end at the 5th cell or later
+	const TUint32 segments = lineMask & ~(TUint32) 0xF;
+
+	// Segments that contain a stone of the player
+	const TUint32 mineNear = aMine | (aMine << 1) | (aMine << 2)
+			| (aMine << 3) | (aMine << 4);
+	const TUint32 enemyNear = aEnemy | (aEnemy << 1) | (aEnemy << 2)
+			| (aEnemy << 3) | (aEnemy << 4);
+
+	TInt rating = RateStones(aMine, segments & ~enemyNear, iMyRating)
+			+ RateStones(aEnemy, segments & ~mineNear, iEnemyRating);
+
+	if (iPairPenalty != 0)
+		{
+		// Two own stones, with an enemy stone on one side and a free cell
+		// on the other side ("XOO." or ".OOX").
+		const TUint32 freeCells = lineMask & ~(aMine | aEnemy);
+		const TUint32 pairs = (aMine << 1) & (aMine << 2) & ((aEnemy & (freeCells
+				<< 3)) | (freeCells & (aEnemy << 3)));
+		rating -= iPairPenalty * CountBits(pairs);
+		}
+	return rating;
+	}
+
+TInt TGomokuLineEvaluator::RateStones(TUint32 aStones, TUint32 aFree,
+		const TInt* aRating)
+	{
+	// Add the 5 cells of every segment with two full adders. The number of
+	// stones is stored in three masks: bit n of ones, twos and fours are the
+	// bits of the number of stones in the segment ending at cell n.
+	const TUint32 c0 = aStones;
+	const TUint32 c1 = aStones << 1;
+	const TUint32 c2 = aStones << 2;
+	const TUint32 c3 = aStones << 3;
+	const TUint32 c4 = aStones << 4;
+	const TUint32 sum1 = c0 ^ c1 ^ c2;
+	const TUint32 carry1 = (c0 & c1) | (c2 & (c0 ^ c1));
+	const TUint32 ones = sum1 ^ c3 ^ c4;
+	const TUint32 carry2 = (sum1 & c3) | (c4 & (sum1 ^ c3));
+	const TUint32 twos = (carry1 ^ carry2) & aFree;
+	const TUint32 fours = carry1 & carry2 & aFree;
+	const TUint32 noFours = aFree & ~fours;
+
+	return aRating[1] * CountBits(ones & ~twos & noFours) + aRating[2]
+			* CountBits(~ones & twos & noFours) + aRating[3] * CountBits(ones
+			& twos & noFours) + aRating[4] * CountBits(~ones & ~twos & fours)
+			+ aRating[5] * CountBits(ones & fours);
+	}
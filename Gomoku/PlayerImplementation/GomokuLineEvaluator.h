@@ -0,0 +1,307 @@
+/*
+ ============================================================================
+ Name		 : GomokuLineEvaluator.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Rating of the whole board from bit masks of the lines,
+               all segments of a line are rated in parallel.
+ ============================================================================
+ */
+
+#ifndef GOMOKULINEEVALUATOR_H_
+#define GOMOKULINEEVALUATOR_H_
+
+// INCLUDES
+#include <e32std.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuSegmentTable.h"
+
+/**
+ * Maximum number of cells of a line, one bit per cell in a TUint32.
+ */
+const TInt KLineMaxCells = 32;
+
+/**
+ * Maximum number of lines: rows, columns and the diagonals in
+ * both directions.
+ */
+const TInt KLineMaxLines = 2 * KLineMaxCells + 2 * (2 * KLineMaxCells - 1);
+
+/**
+ * The line cache has 2^KLineCacheBits entries.
+ */
+const TInt KLineCacheBits = 10;
+
+/**
+ * Number of entries of the line cache.
+ */
+const TInt KLineCacheSize = 1 << KLineCacheBits;
+
+/**
+ * Rating of a line in the line cache.
+ */
+class TGomokuLineCacheEntry
+	{
+public:
+	/**
+	 * Own stones of the line.
+	 */
+	TUint32 iMine;
+
+	/**
+	 * Enemy stones of the line.
+	 */
+	TUint32 iEnemy;
+
+	/**
+	 * Number of cells of the line, 0 if the entry is empty.
+	 */
+	TInt iLength;
+
+	/**
+	 * Rating of the line.
+	 */
+	TInt iRating;
+	};
+
+// CLASS DECLARATION
+
+/**
+ * Rates the board like the segment based AIs (see TGomokuSegmentTable),
+ * but on bit masks instead of cell by cell.
+ *
+ * The board is read once and every line (row, column and both diagonals)
+ * is stored as two 32 bit masks with one bit per cell, one for each color.
+ * The number of stones in the 5-cell segment ending at every cell is then
+ * calculated for all cells of the line at the same time with bitwise
+ * adders on the shifted masks. The segments with a specific number of own
+ * stones and no enemy stone are counted and multiplied with the rating of
+ * that number of stones; the same is done for the enemy. The pair check
+ * penalty is a pattern of 4 cells and is found with shifted masks as well.
+ *
+ * The result is exactly the same as rating the segments one by one with
+ * the segment table. Grids with sides of less than 5 or more than
+ * KLineMaxCells cells are not supported, see Supports().
+ *
+ * Most lines don't change between the boards that are rated for the
+ * possible moves, therefore the ratings of the lines are stored in a cache
+ * with the stones of the line as key. The cache is kept for the following
+ * moves until the ratings change.
+ */
+class TGomokuLineEvaluator
+	{
+public:
+	/**
+	 * Constructor. All ratings are 0.
+	 */
+	TGomokuLineEvaluator();
+
+	/**
+	 * Set the ratings of the segments.
+	 *
+	 * \param aMyRating rating of a segment with 1 to 5 own stones and
+	 * no enemy stone, indexed by the number of stones (index 0 is not used,
+	 * empty segments are rated 0).
+	 * \param aEnemyRating rating of a segment with 1 to 5 enemy stones
+	 * and no own stone.
+	 * \param aPairPenalty subtracted for every own pair that the enemy could
+	 * capture, 0 if pair check is not activated.
+	 */
+	void SetRatings(const TInt* aMyRating, const TInt* aEnemyRating,
+			TInt aPairPenalty);
+
+	/**
+	 * \return ETrue if boards of this size can be rated.
+	 */
+	static TBool Supports(TSize aGridSize);
+
+	/**
+	 * Rate the board.
+	 *
+	 * \param aGrid the board, its size has to be supported.
+	 * \param aMyColor color of the own player.
+	 * \return the total rating of the board. The higher the better.
+	 */
+	TInt Evaluate(const CGrid* aGrid, eCellColor aMyColor);
+
+	/**
+	 * Rate the board of a search.
+	 *
+	 * \param aBoard the board, its size has to be supported.
+	 * \param aMyColor color of the own player.
+	 * \return the total rating of the board. The higher the better.
+	 */
+	TInt Evaluate(const CGomokuBoard& aBoard, eCellColor aMyColor);
+
+	/**
+	 * Remove all lines from the cache.
+	 */
+	void ClearCache();
+
+	/**
+	 * Set the number of cache lookups and hits back to 0.
+	 */
+	void ResetStatistics();
+
+	/**
+	 * Number of lines that were looked up in the cache since the last call
+	 * of ResetStatistics().
+	 */
+	TInt CacheLookups() const;
+
+	/**
+	 * Number of lines whose rating was found in the cache since the last call
+	 * of ResetStatistics().
+	 */
+	TInt CacheHits() const;
+
+private:
+	/**
+	 * Store the stones of the board in the masks of the lines.
+	 */
+	void ReadBoard(const CGrid* aGrid);
+
+	/**
+	 * Store the stones of the board in the masks of the lines.
+	 */
+	void ReadBoard(const CGomokuBoard& aBoard);
+
+	/**
+	 * Set up the lines of a board of the specified size, without stones.
+	 */
+	void ClearLines(TInt aCols, TInt aRows);
+
+	/**
+	 * Add the stone of a cell to the masks of all lines through the cell.
+	 */
+	inline void AddStone(TInt aX, TInt aY, eCellColor aColor);
+
+	/**
+	 * Rate the lines stored by ReadBoard().
+	 */
+	TInt EvaluateLines(eCellColor aMyColor);
+
+	/**
+	 * Rating of a line from the cache, rates the line if it is not
+	 * in the cache yet.
+	 *
+	 * \param aMine own stones of the line.
+	 * \param aEnemy enemy stones of the line.
+	 * \param aLength number of cells of the line.
+	 */
+	TInt RateLine(TUint32 aMine, TUint32 aEnemy, TInt aLength);
+
+	/**
+	 * Rate all segments of one line.
+	 *
+	 * \param aMine own stones of the line.
+	 * \param aEnemy enemy stones of the line.
+	 * \param aLength number of cells of the line.
+	 */
+	TInt EvaluateLine(TUint32 aMine, TUint32 aEnemy, TInt aLength) const;
+
+	/**
+	 * Number of segments with 1 to 5 stones of the player and no stone of
+	 * the other player, weighted with the ratings.
+	 *
+	 * \param aStones stones of the player.
+	 * \param aFree segments without a stone of the other player.
+	 * \param aRating rating for the number of stones.
+	 */
+	static TInt RateStones(TUint32 aStones, TUint32 aFree,
+			const TInt* aRating);
+
+	/**
+	 * Number of bits set in the mask.
+	 */
+	static inline TInt CountBits(TUint32 aMask);
+
+private:
+	/**
+	 * Rating of a segment for 1 to 5 own stones.
+	 */
+	TInt iMyRating[KSegmentCells + 1];
+
+	/**
+	 * Rating of a segment for 1 to 5 enemy stones.
+	 */
+	TInt iEnemyRating[KSegmentCells + 1];
+
+	/**
+	 * Penalty for a pair that the enemy could capture.
+	 */
+	TInt iPairPenalty;
+
+	/**
+	 * Number of lines of the last board.
+	 */
+	TInt iNumLines;
+
+	/**
+	 * Number of rows of the last board.
+	 */
+	TInt iRows;
+
+	/**
+	 * Index of the first column, the first diagonal down right and the first
+	 * diagonal up right in the line arrays. The rows come first.
+	 */
+	TInt iFirstCol;
+	TInt iFirstDiagonal1;
+	TInt iFirstDiagonal2;
+
+	/**
+	 * Number of cells of every line.
+	 */
+	TInt iLength[KLineMaxLines];
+
+	/**
+	 * Stones of both colors (EColor1 and EColor2) in every line.
+	 */
+	TUint32 iStones[2][KLineMaxLines];
+
+	/**
+	 * Ratings of recently rated lines, the position in the cache is
+	 * a hash of the stones.
+	 */
+	TGomokuLineCacheEntry iCache[KLineCacheSize];
+
+	/**
+	 * Number of cache lookups since the statistics were reset.
+	 */
+	TInt iCacheLookups;
+
+	/**
+	 * Number of cache hits since the statistics were reset.
+	 */
+	TInt iCacheHits;
+	};
+
+inline void TGomokuLineEvaluator::AddStone(TInt aX, TInt aY,
+		eCellColor aColor)
+	{
+	// The order of the cells in a line doesn't matter, as the rating of the
+	// segments is the same in both directions.
+	TUint32* stones = iStones[aColor - EColor1];
+	stones[aY] |= (TUint32) 1 << aX;
+	stones[iFirstCol + aX] |= (TUint32) 1 << aY;
+	stones[iFirstDiagonal1 + aX - aY + iRows - 1] |= (TUint32) 1 << Min(aX, aY);
+	stones[iFirstDiagonal2 + aX + aY] |= (TUint32) 1 << (aX - Max(0, aX + aY
+			- iRows + 1));
+	}
+
+inline TInt TGomokuLineEvaluator::CountBits(TUint32 aMask)
+	{
+	aMask = aMask - ((aMask >> 1) & 0x55555555);
+	aMask = (aMask & 0x33333333) + ((aMask >> 2) & 0x33333333);
+	aMask = (aMask + (aMask >> 4)) & 0x0F0F0F0F;
+	return (TInt) ((aMask * 0x01010101) >> 24);
+	}
+
+#endif /*GOMOKULINEEVALUATOR_H_*/
@@ -0,0 +1,411 @@
+/*
+ ============================================================================
+ Name		 : GomokuMctsSearch.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuMctsSearch implementation
+ ============================================================================
+ */
+
+#include "GomokuMctsSearch.h"
+
+CGomokuMctsSearch::CGomokuMctsSearch() :
+	iThreads(1), iRootToMove(EColor1)
+	{
+	// No implementation required
+	}
+
+CGomokuMctsSearch::~CGomokuMctsSearch()
+	{
+	DeleteArrays();
+	iTreeMutex.Close();
+	}
+
+CGomokuMctsSearch* CGomokuMctsSearch::NewL()
+	{
+	CGomokuMctsSearch* self = new (ELeave) CGomokuMctsSearch();
+	CleanupStack::PushL(self);
+	User::LeaveIfError(self->iTreeMutex.CreateLocal());
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuMctsSearch::InitL(TSize aGridSize, TBool aPairCheck,
+		TInt aNumPairsWin, TInt aMaxNodes)
+	{
+	iPairCheck = aPairCheck;
+	iNumPairsWin = aNumPairsWin;
+	DeleteArrays();
+	iMaxNodes = aMaxNodes;
+	iNodes = new (ELeave) TGomokuMctsNode[iMaxNodes];
+	iRemap = new (ELeave) TInt[iMaxNodes];
+	iNodesUsed = 0;
+	for (TInt i = 0; i < iThreads; i++)
+		{
+		iWorkers[i] = CGomokuMctsWorker::NewL(*this);
+		iNumWorkers++;
+		iWorkers[i]->InitL(aGridSize);
+		}
+	}
+
+void CGomokuMctsSearch::SetThreads(TInt aThreads)
+	{
+	iThreads = Max(1, Min(aThreads, KMctsMaxThreads));
+	}
+
+void CGomokuMctsSearch::DeleteArrays()
+	{
+	StopSearch();
+	for (TInt i = 0; i < iNumWorkers; i++)
+		{
+		delete iWorkers[i];
+		iWorkers[i] = NULL;
+		}
+	iNumWorkers = 0;
+	delete[] iNodes;
+	iNodes = NULL;
+	delete[] iRemap;
+	iRemap = NULL;
+	}
+
+void CGomokuMctsSearch::StartSearch(const CGrid* aGrid, eCellColor aToMove,
+		TUint64 aSeed)
+	{
+	StopSearch();
+	iRootToMove = aToMove;
+
+	// Only the root is left in the pool.
+	TGomokuMctsNode& root = iNodes[0];
+	root.iFirstChild = 0;
+	root.iVisits = 0;
+	root.iScore = 0;
+	root.iMove = -1;
+	root.iNumChildren = 0;
+	iNodesUsed = 1;
+	iTreeFull = EFalse;
+
+	// Every worker needs different random numbers.
+	TInt i;
+	for (i = 0; i < iNumWorkers; i++)
+		{
+		iWorkers[i]->StartSearch(aGrid, aSeed + i);
+		}
+	StartThreads();
+	}
+
+TBool CGomokuMctsSearch::AdvanceRoot(const TPoint& aMove)
+	{
+	StopSearch();
+	const TGomokuMctsNode& root = iNodes[0];
+	const TInt move = iWorkers[0]->PointToMove(aMove);
+	for (TInt i = 0; i < root.iNumChildren; i++)
+		{
+		const TInt index = root.iFirstChild + i;
+		if (iNodes[index].iMove == move)
+			{
+			if (iNodes[index].iNumChildren == KMctsTerminal)
+				{
+				// The game is over.
+				return EFalse;
+				}
+			for (TInt w = 0; w < iNumWorkers; w++)
+				{
+				iWorkers[w]->AdvanceRoot(move, iRootToMove);
+				}
+			CompactTree(index);
+			iRootToMove = CGomokuBoard::Opponent(iRootToMove);
+			return ETrue;
+			}
+		}
+	return EFalse;
+	}
+
+void CGomokuMctsSearch::ResumeSearch()
+	{
+	StopSearch();
+	for (TInt i = 0; i < iNumWorkers; i++)
+		{
+		iWorkers[i]->ResetPlayouts();
+		}
+	StartThreads();
+	}
+
+TBool CGomokuMctsSearch::ReuseSearch(const CGrid* aGrid, eCellColor aToMove)
+	{
+	if (!iNodes || iNumWorkers == 0)
+		{
+		return EFalse;
+		}
+	StopSearch();
+	if (iRootToMove != aToMove)
+		{
+		// The tree ends with the position before the opponent's move.
+		const TInt move = iWorkers[0]->FindNewStone(aGrid, iRootToMove);
+		if (move < 0 || !AdvanceRoot(iWorkers[0]->MoveToPoint(move)))
+			{
+			return EFalse;
+			}
+		}
+	if (!iWorkers[0]->IsSamePosition(aGrid))
+		{
+		return EFalse;
+		}
+	ResumeSearch();
+	return ETrue;
+	}
+
+void CGomokuMctsSearch::StartThreads()
+	{
+	iStopThreads = EFalse;
+	for (TInt i = 1; i < iNumWorkers; i++)
+		{
+		TRAPD(err, iWorkers[i]->StartThreadL());
+		if (err != KErrNone)
+			{
+			// Continue with the threads that could be started.
+			break;
+			}
+		}
+	}
+
+TBool CGomokuMctsSearch::RunIterations(TInt aCount)
+	{
+	for (TInt i = 0; i < aCount; i++)
+		{
+		iWorkers[0]->RunIteration();
+		}
+	// With only one move to choose from (the winning move or the only block),
+	// there is nothing left to search.
+	return (iNodes[0].iNumChildren == 1);
+	}
+
+void CGomokuMctsSearch::StopSearch()
+	{
+	iStopThreads = ETrue;
+	for (TInt i = 1; i < iNumWorkers; i++)
+		{
+		iWorkers[i]->StopThread();
+		}
+	}
+
+TPoint CGomokuMctsSearch::BestMove() const
+	{
+	const TGomokuMctsNode& root = iNodes[0];
+	TInt bestMove = -1;
+	TInt bestVisits = -1;
+	for (TInt i = 0; i < root.iNumChildren; i++)
+		{
+		const TGomokuMctsNode& child = iNodes[root.iFirstChild + i];
+		if (child.iVisits > bestVisits)
+			{
+			bestVisits = child.iVisits;
+			bestMove = child.iMove;
+			}
+		}
+	return iWorkers[0]->MoveToPoint(bestMove);
+	}
+
+TInt CGomokuMctsSearch::PrincipalVariation(
+		TGomokuSearchStatistics& aStatistics) const
+	{
+	TInt depth = 0;
+	const TGomokuMctsNode* node = &iNodes[0];
+	while (node->iFirstChild && node->iNumChildren > 0)
+		{
+		const TGomokuMctsNode* best = NULL;
+		for (TInt i = 0; i < node->iNumChildren; i++)
+			{
+			const TGomokuMctsNode& child = iNodes[node->iFirstChild + i];
+			if (!best || child.iVisits > best->iVisits)
+				{
+				best = &child;
+				}
+			}
+		if (best->iVisits == 0)
+			{
+			break;
+			}
+		aStatistics.AddPvMove(iWorkers[0]->MoveToPoint(best->iMove));
+		depth++;
+		node = best;
+		}
+	return depth;
+	}
+
+TBool CGomokuMctsSearch::BestMoveIsStable() const
+	{
+	const TGomokuMctsNode& root = iNodes[0];
+	TInt mostVisited = -1;
+	TInt bestVisits = -1;
+	TInt bestAverage = -1;
+	TReal bestResult = -1.0;
+	for (TInt i = 0; i < root.iNumChildren; i++)
+		{
+		const TGomokuMctsNode& child = iNodes[root.iFirstChild + i];
+		// Copy the values, the worker threads might change them meanwhile.
+		const TInt visits = child.iVisits;
+		const TInt score = child.iScore;
+		if (visits > bestVisits)
+			{
+			bestVisits = visits;
+			mostVisited = i;
+			}
+		if (visits > 0 && score / (TReal) visits > bestResult)
+			{
+			bestResult = score / (TReal) visits;
+			bestAverage = i;
+			}
+		}
+	return (mostVisited == bestAverage);
+	}
+
+TInt CGomokuMctsSearch::Playouts() const
+	{
+	TInt playouts = 0;
+	for (TInt i = 0; i < iNumWorkers; i++)
+		{
+		playouts += iWorkers[i]->Playouts();
+		}
+	return playouts;
+	}
+
+TInt CGomokuMctsSearch::RootVisits() const
+	{
+	return iNodes[0].iVisits;
+	}
+
+TBool CGomokuMctsSearch::TreeFull() const
+	{
+	return iTreeFull;
+	}
+
+TInt CGomokuMctsSearch::ThreadCount() const
+	{
+	return iNumWorkers;
+	}
+
+TInt CGomokuMctsSearch::ThreadPlayouts(TInt aThread) const
+	{
+	return iWorkers[aThread]->Playouts();
+	}
+
+TInt CGomokuMctsSearch::NodesUsed() const
+	{
+	return iNodesUsed;
+	}
+
+void CGomokuMctsSearch::CompactTree(TInt aRoot)
+	{
+	// Children are always added behind their parent, so going through the
+	// pool in order visits every parent before its children. As the nodes
+	// only move to lower positions, they can be moved in the same order.
+	TInt i;
+	for (i = 0; i < iNodesUsed; i++)
+		{
+		iRemap[i] = -1;
+		}
+	iRemap[aRoot] = 0;
+	TInt used = 0;
+	for (i = aRoot; i < iNodesUsed; i++)
+		{
+		if (iRemap[i] < 0)
+			{
+			continue;
+			}
+		iRemap[i] = used++;
+		const TGomokuMctsNode& node = iNodes[i];
+		for (TInt child = 0; node.iFirstChild && child < node.iNumChildren; child++)
+			{
+			// Mark the child as part of the subtree.
+			iRemap[node.iFirstChild + child] = 0;
+			}
+		}
+	for (i = aRoot; i < iNodesUsed; i++)
+		{
+		if (iRemap[i] >= 0)
+			{
+			TGomokuMctsNode node = iNodes[i];
+			if (node.iFirstChild)
+				{
+				node.iFirstChild = iRemap[node.iFirstChild];
+				}
+			iNodes[iRemap[i]] = node;
+			}
+		}
+	iNodes[0].iMove = -1;
+	iNodesUsed = used;
+	iTreeFull = EFalse;
+	}
+
+TInt CGomokuMctsSearch::SelectChild(TInt aNode)
+	{
+	const TGomokuMctsNode& parent = iNodes[aNode];
+	TReal logVisits;
+	Math::Ln(logVisits, (TReal) Max(parent.iVisits, 1));
+
+	// AddChildren() writes the children while holding the mutex. Taking
+	// it here makes them visible together with the first child.
+	iTreeMutex.Wait();
+	const TInt firstChild = parent.iFirstChild;
+	const TInt numChildren = parent.iNumChildren;
+	iTreeMutex.Signal();
+	TInt best = firstChild;
+	TReal bestValue = -1.0;
+	for (TInt i = 0; i < numChildren; i++)
+		{
+		const TInt index = firstChild + i;
+		const TGomokuMctsNode& child = iNodes[index];
+		// Copy the values, other threads might change them meanwhile.
+		const TInt visits = child.iVisits;
+		const TInt score = child.iScore;
+		if (visits == 0 || child.iNumChildren == KMctsTerminal)
+			{
+			// Try every move once, and always take a winning move.
+			return index;
+			}
+		TReal exploration;
+		Math::Sqrt(exploration, logVisits / visits);
+		const TReal value = score / (2.0 * visits) + KMctsExploration
+				* exploration;
+		if (value > bestValue)
+			{
+			bestValue = value;
+			best = index;
+			}
+		}
+	return best;
+	}
+
+void CGomokuMctsSearch::AddChildren(TInt aNode, const TInt16* aMoves,
+		TInt aNumMoves, TBool aWinning)
+	{
+	iTreeMutex.Wait();
+	TGomokuMctsNode& parent = iNodes[aNode];
+	if (parent.iFirstChild == 0 && iNodesUsed + aNumMoves > iMaxNodes)
+		{
+		iTreeFull = ETrue;
+		}
+	else if (parent.iFirstChild == 0)
+		{
+		const TInt firstChild = iNodesUsed;
+		for (TInt i = 0; i < aNumMoves; i++)
+			{
+			TGomokuMctsNode& child = iNodes[firstChild + i];
+			child.iFirstChild = 0;
+			child.iVisits = 0;
+			child.iScore = 0;
+			child.iMove = aMoves[i];
+			child.iNumChildren = (TInt16) (aWinning ? KMctsTerminal : 0);
+			}
+		iNodesUsed += aNumMoves;
+		// Other threads only look at the children once iFirstChild is set.
+		parent.iNumChildren = (TInt16) aNumMoves;
+		parent.iFirstChild = firstChild;
+		}
+	iTreeMutex.Signal();
+	}
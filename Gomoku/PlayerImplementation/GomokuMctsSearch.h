@@ -0,0 +1,389 @@
+/*
+ ============================================================================
+ Name		 : GomokuMctsSearch.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Monte-Carlo tree search with UCT selection and random
+               playouts.
+ ============================================================================
+ */
+
+#ifndef GOMOKUMCTSSEARCH_H_
+#define GOMOKUMCTSSEARCH_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <e32math.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuMctsWorker.h"
+#include "GomokuSearchStatistics.h"
+
+/**
+ * Default number of tree nodes (16 bytes each).
+ */
+const TInt KMctsDefaultMaxNodes = 16384;
+
+/**
+ * Distance of the moves in the tree to the closest stone.
+ */
+const TInt KMctsRadius = 2;
+
+/**
+ * Exploration constant of the UCT formula.
+ */
+const TReal KMctsExploration = 0.7;
+
+/**
+ * iNumChildren of a node where the move into the node won the game.
+ */
+const TInt KMctsTerminal = -1;
+
+/**
+ * Maximum number of workers (including the main thread).
+ */
+const TInt KMctsMaxThreads = 4;
+
+/**
+ * One node of the search tree.
+ */
+class TGomokuMctsNode
+	{
+public:
+	/**
+	 * Index of the first child in the pool, the children are stored in a row.
+	 * 0 as long as the node is not expanded (the root can't be a child).
+	 */
+	TInt iFirstChild;
+
+	/**
+	 * Number of iterations through this node, including the ones that are
+	 * still running.
+	 */
+	TInt iVisits;
+
+	/**
+	 * Result of the finished iterations for the player that made the move
+	 * into this node, 2 per win and 1 per draw.
+	 */
+	TInt iScore;
+
+	/**
+	 * Position of the move into this node in the cell array.
+	 */
+	TInt16 iMove;
+
+	/**
+	 * Number of children, 0 if not expanded yet or KMctsTerminal.
+	 */
+	TInt16 iNumChildren;
+	};
+
+// CLASS DECLARATION
+
+/**
+ * Monte-Carlo tree search (MCTS) for one move.
+ *
+ * Every iteration walks down the tree by choosing the child with the best
+ * UCT value (average result + exploration bonus for rarely visited moves),
+ * adds the children of the reached position to the tree and plays a
+ * random game (playout) from there. The result is added to all nodes
+ * of the path. In the end, the most visited move of the root is played.
+ * The iterations are run by CGomokuMctsWorker.
+ *
+ * All nodes are taken from a pool that is allocated once per game, so
+ * no memory is allocated while searching. When the pool is used up, the
+ * tree simply stops growing and further iterations only play out from
+ * the leaves.
+ *
+ * Playouts pick random cells from a list of free cells, captured stones
+ * are added to the list again. Only if a player has four stones in a row
+ * (checked for the lines through the last move), the playout completes or
+ * blocks the four instead. Without this, random playouts can't see that an
+ * open three is dangerous. The rules (five in a row, pair check) are the
+ * same as in CGrid, see CGomokuBoard.
+ *
+ * The moves in the tree are restricted to cells close to existing stones.
+ * If the player to move can win immediately, only that move is added. If the
+ * opponent could win with the next move, only the moves that block or
+ * capture a pair are added.
+ *
+ * Tree parallelism: additional workers can search the same tree in own
+ * threads (see SetThreads()). The visits of a node are counted when an
+ * iteration walks through it, the result is only added at the end. Until
+ * then, the visit counts as a loss (virtual loss), so the other threads
+ * prefer different moves. Visits and results are updated with atomic
+ * increments (User::LockedInc()), only adding children to a node is
+ * protected by a mutex. SelectChild() reads the first child and the number
+ * of children while holding the same mutex, so other threads either see no
+ * children or all of them, also on multi-core CPUs that reorder memory
+ * accesses.
+ *
+ * The tree can be kept for the next moves (see AdvanceRoot() and
+ * ReuseSearch()): one of the children of the root becomes the new root.
+ * Its subtree is moved to the start of the pool, the rest of the old
+ * tree is dropped.
+ */
+class CGomokuMctsSearch : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuMctsSearch();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuMctsSearch* NewL();
+
+public:
+	/**
+	 * Prepare the search for a new game.
+	 *
+	 * \param aGridSize size of the grid used in the game.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 * \param aMaxNodes size of the node pool.
+	 */
+	void InitL(TSize aGridSize, TBool aPairCheck, TInt aNumPairsWin,
+			TInt aMaxNodes = KMctsDefaultMaxNodes);
+
+	/**
+	 * Set the number of workers. Worker 0 runs on the calling thread
+	 * through RunIterations(), all others in own threads.
+	 * Takes effect with the next call to InitL().
+	 *
+	 * \param aThreads number of workers, 1 to KMctsMaxThreads.
+	 */
+	void SetThreads(TInt aThreads);
+
+	/**
+	 * Start the search for a new move. Clears the tree and starts the
+	 * worker threads. If the threads can't be created, the search
+	 * continues with the calling thread only.
+	 *
+	 * \param aGrid current game state.
+	 * \param aToMove color of the player to move.
+	 * \param aSeed seed for the random number generator.
+	 */
+	void StartSearch(const CGrid* aGrid, eCellColor aToMove, TUint64 aSeed);
+
+	/**
+	 * Make a move on the root position: the child of the root with this
+	 * move becomes the new root, all results below it are kept.
+	 * Stops the worker threads, continue with ResumeSearch().
+	 *
+	 * \param aMove the move of the player to move at the root.
+	 * \return EFalse if the move is not in the tree or wins the game.
+	 * The tree is not changed then.
+	 */
+	TBool AdvanceRoot(const TPoint& aMove);
+
+	/**
+	 * Continue the search after AdvanceRoot(). Restarts the worker threads.
+	 */
+	void ResumeSearch();
+
+	/**
+	 * Continue with the tree of the last search for a new move, if the
+	 * game has only continued with a move that is in the tree. This is the
+	 * case if the opponent's move was searched by pondering.
+	 *
+	 * \param aGrid current game state.
+	 * \param aToMove color of the player to move.
+	 * \return ETrue if the tree is reused and the search is running,
+	 * EFalse if StartSearch() has to be called.
+	 */
+	TBool ReuseSearch(const CGrid* aGrid, eCellColor aToMove);
+
+	/**
+	 * Run the specified number of iterations on the calling thread.
+	 *
+	 * \return ETrue if the search can be stopped, because a move of the
+	 * root wins immediately or there is only one sensible move.
+	 */
+	TBool RunIterations(TInt aCount);
+
+	/**
+	 * Stop all worker threads. Has to be called before the result is used.
+	 */
+	void StopSearch();
+
+	/**
+	 * The most visited move of the root.
+	 */
+	TPoint BestMove() const;
+
+	/**
+	 * Follow the most visited moves from the root down the tree and add
+	 * them to the principal variation of the statistics.
+	 *
+	 * \param aStatistics receives the moves, up to KSearchMaxPvLength.
+	 * \return number of plies of the line in the tree, which can be longer
+	 * than the principal variation.
+	 */
+	TInt PrincipalVariation(TGomokuSearchStatistics& aStatistics) const;
+
+	/**
+	 * Check if more searching is likely to change the result.
+	 * \return ETrue if the most visited move of the root also has the best
+	 * average result.
+	 */
+	TBool BestMoveIsStable() const;
+
+	/**
+	 * Number of playouts of all workers since StartSearch().
+	 */
+	TInt Playouts() const;
+
+	/**
+	 * Number of iterations through the root, including the ones of earlier
+	 * searches if the tree was reused.
+	 */
+	TInt RootVisits() const;
+
+	/**
+	 * \return ETrue if the node pool is used up, i.e. the tree can't grow
+	 * any more.
+	 */
+	TBool TreeFull() const;
+
+	/**
+	 * Number of workers.
+	 */
+	TInt ThreadCount() const;
+
+	/**
+	 * Number of playouts of one worker since StartSearch().
+	 */
+	TInt ThreadPlayouts(TInt aThread) const;
+
+	/**
+	 * Number of tree nodes in use.
+	 */
+	TInt NodesUsed() const;
+
+
+private:
+	// Used by the workers
+	friend class CGomokuMctsWorker;
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuMctsSearch();
+
+	/**
+	 * Delete the node pool and all workers.
+	 */
+	void DeleteArrays();
+
+	/**
+	 * Start the worker threads. If a thread can't be created, the search
+	 * continues with the ones that could be started.
+	 */
+	void StartThreads();
+
+	/**
+	 * Make the node the root of the tree. Moves its subtree to the start of
+	 * the pool and drops all other nodes.
+	 */
+	void CompactTree(TInt aRoot);
+
+	/**
+	 * Choose the child with the best UCT value.
+	 * \return index of the child in the node pool.
+	 */
+	TInt SelectChild(TInt aNode);
+
+	/**
+	 * Add children to the node, unless another worker was faster
+	 * or the pool is used up.
+	 *
+	 * \param aNode node to expand.
+	 * \param aMoves moves of the children.
+	 * \param aNumMoves number of moves.
+	 * \param aWinning ETrue if the (only) move wins the game.
+	 */
+	void AddChildren(TInt aNode, const TInt16* aMoves, TInt aNumMoves,
+			TBool aWinning);
+
+private:
+	/**
+	 * Pool of all tree nodes. Node 0 is the root.
+	 */
+	TGomokuMctsNode* iNodes;
+
+	/**
+	 * Size of the node pool.
+	 */
+	TInt iMaxNodes;
+
+	/**
+	 * Number of used nodes.
+	 */
+	TInt iNodesUsed;
+
+	/**
+	 * Set when children could not be added because the pool is used up.
+	 */
+	TBool iTreeFull;
+
+	/**
+	 * New position of every node when the tree is compacted,
+	 * -1 for dropped nodes.
+	 */
+	TInt* iRemap;
+
+	/**
+	 * Protects adding children to the tree and reading the children of a
+	 * node, see SelectChild().
+	 */
+	RMutex iTreeMutex;
+
+	/**
+	 * All workers, worker 0 runs on the main thread.
+	 */
+	CGomokuMctsWorker* iWorkers[KMctsMaxThreads];
+
+	/**
+	 * Number of created workers.
+	 */
+	TInt iNumWorkers;
+
+	/**
+	 * Number of workers to create in InitL().
+	 */
+	TInt iThreads;
+
+	/**
+	 * Set to stop the worker threads.
+	 */
+	volatile TBool iStopThreads;
+
+	/**
+	 * Color of the player to move at the root.
+	 */
+	eCellColor iRootToMove;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Number of captured pairs required for winning a game.
+	 */
+	TInt iNumPairsWin;
+	};
+
+#endif /*GOMOKUMCTSSEARCH_H_*/
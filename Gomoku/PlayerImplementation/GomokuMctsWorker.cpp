@@ -0,0 +1,489 @@
+/*
+ ============================================================================
+ Name		 : GomokuMctsWorker.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuMctsWorker implementation
+ ============================================================================
+ */
+
+#include "GomokuMctsWorker.h"
+#include "GomokuMctsSearch.h"
+
+CGomokuMctsWorker::CGomokuMctsWorker(CGomokuMctsSearch& aSearch) :
+	iSearch(aSearch)
+	{
+	// No implementation required
+	}
+
+CGomokuMctsWorker::~CGomokuMctsWorker()
+	{
+	StopThread();
+	delete iBoard;
+	DeleteArrays();
+	}
+
+CGomokuMctsWorker* CGomokuMctsWorker::NewL(CGomokuMctsSearch& aSearch)
+	{
+	CGomokuMctsWorker* self = new (ELeave) CGomokuMctsWorker(aSearch);
+	CleanupStack::PushL(self);
+	self->iBoard = CGomokuBoard::NewL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuMctsWorker::InitL(TSize aGridSize)
+	{
+	iBoard->ResizeL(aGridSize);
+	DeleteArrays();
+	const TInt numCells = iBoard->NumCells();
+	// The path can't be longer than the move history of the board.
+	iPath = new (ELeave) TInt[iBoard->MaxMoves() + 1];
+	iFreeCells = new (ELeave) TInt16[numCells];
+	iFreePos = new (ELeave) TInt16[numCells];
+	iCandidates = new (ELeave) TInt16[numCells];
+	iMarks = new (ELeave) TUint32[numCells];
+	Mem::FillZ(iMarks, numCells * sizeof(TUint32));
+	iMarkGeneration = 0;
+	}
+
+void CGomokuMctsWorker::DeleteArrays()
+	{
+	delete[] iPath;
+	iPath = NULL;
+	delete[] iFreeCells;
+	iFreeCells = NULL;
+	delete[] iFreePos;
+	iFreePos = NULL;
+	delete[] iCandidates;
+	iCandidates = NULL;
+	delete[] iMarks;
+	iMarks = NULL;
+	}
+
+void CGomokuMctsWorker::StartSearch(const CGrid* aGrid, TUint64 aSeed)
+	{
+	iBoard->CopyFrom(aGrid);
+	iRootMoves = 0;
+	iRandom.SetSeed(aSeed);
+	iPlayouts = 0;
+	}
+
+void CGomokuMctsWorker::AdvanceRoot(TInt aIndex, eCellColor aColor)
+	{
+	Play(aIndex, aColor);
+	iRootMoves = iBoard->MoveCount();
+	}
+
+void CGomokuMctsWorker::ResetPlayouts()
+	{
+	iPlayouts = 0;
+	}
+
+TInt CGomokuMctsWorker::FindNewStone(const CGrid* aGrid, eCellColor aColor) const
+	{
+	TInt newStone = -1;
+	for (TInt y = 0; y < iBoard->Rows(); y++)
+		{
+		for (TInt x = 0; x < iBoard->Cols(); x++)
+			{
+			const eCellColor color = aGrid->GetGridCell(x, y)->GetColor();
+			if (color == aColor && iBoard->Cell(x, y) != aColor)
+				{
+				if (newStone >= 0)
+					{
+					return -1;
+					}
+				newStone = iBoard->Index(x, y);
+				}
+			}
+		}
+	return newStone;
+	}
+
+TBool CGomokuMctsWorker::IsSamePosition(const CGrid* aGrid) const
+	{
+	for (TInt y = 0; y < iBoard->Rows(); y++)
+		{
+		for (TInt x = 0; x < iBoard->Cols(); x++)
+			{
+			if (aGrid->GetGridCell(x, y)->GetColor() != iBoard->Cell(x, y))
+				{
+				return EFalse;
+				}
+			}
+		}
+	return ETrue;
+	}
+
+void CGomokuMctsWorker::StartThreadL()
+	{
+	// The thread shares the heap of the creating thread, so it can use the
+	// tree and the buffers of this worker directly.
+	User::LeaveIfError(iThread.Create(KNullDesC, ThreadFunction,
+			KDefaultStackSize, NULL, this));
+	// Keep the UI responsive, the main thread searches as well.
+	iThread.SetPriority(EPriorityLess);
+	iThread.Logon(iThreadStatus);
+	iThreadRunning = ETrue;
+	iThread.Resume();
+	}
+
+void CGomokuMctsWorker::StopThread()
+	{
+	if (iThreadRunning)
+		{
+		// CGomokuMctsSearch::StopSearch() has set the stop flag.
+		User::WaitForRequest(iThreadStatus);
+		iThread.Close();
+		iThreadRunning = EFalse;
+		}
+	}
+
+TInt CGomokuMctsWorker::ThreadFunction(TAny* aWorker)
+	{
+	CTrapCleanup* cleanup = CTrapCleanup::New();
+	if (!cleanup)
+		{
+		return KErrNoMemory;
+		}
+	CGomokuMctsWorker* worker = (CGomokuMctsWorker*) aWorker;
+	while (!worker->iSearch.iStopThreads)
+		{
+		worker->RunIteration();
+		}
+	delete cleanup;
+	return KErrNone;
+	}
+
+TPoint CGomokuMctsWorker::MoveToPoint(TInt aIndex) const
+	{
+	TInt index = aIndex;
+	if (index < 0)
+		{
+		// Nothing searched yet, take any free cell.
+		for (TInt pos = 0; pos < iBoard->NumCells() && index < 0; pos++)
+			{
+			if (iBoard->CellAt(pos) == EColorNeutral)
+				{
+				index = pos;
+				}
+			}
+		}
+	return TPoint(index % iBoard->Cols(), index / iBoard->Cols());
+	}
+
+TInt CGomokuMctsWorker::PointToMove(const TPoint& aPoint) const
+	{
+	return iBoard->Index(aPoint.iX, aPoint.iY);
+	}
+
+TInt CGomokuMctsWorker::Playouts() const
+	{
+	return iPlayouts;
+	}
+
+void CGomokuMctsWorker::RunIteration()
+	{
+	TGomokuMctsNode* nodes = iSearch.iNodes;
+	const eCellColor rootToMove = iSearch.iRootToMove;
+	TInt depth = 0;
+	TInt node = 0;
+	eCellColor toMove = rootToMove;
+	eCellColor winner = EColorNeutral;
+	TBool finished = EFalse;
+	iPath[0] = 0;
+	User::LockedInc(nodes[0].iVisits);
+
+	// Selection: walk down the tree until a leaf is reached. The visits are
+	// counted on the way down (virtual loss), see CGomokuMctsSearch.
+	FOREVER
+		{
+		if (nodes[node].iFirstChild == 0)
+			{
+			// Expansion: a leaf is only expanded after it was visited once,
+			// otherwise the pool would be full of nodes with one playout.
+			if (node == 0 || nodes[node].iVisits > 1)
+				{
+				Expand(node, toMove);
+				}
+			if (nodes[node].iFirstChild == 0)
+				{
+				break;
+				}
+			}
+		node = iSearch.SelectChild(node);
+		User::LockedInc(nodes[node].iVisits);
+		Play(nodes[node].iMove, toMove);
+		iPath[++depth] = node;
+		if (nodes[node].iNumChildren == KMctsTerminal)
+			{
+			winner = toMove;
+			finished = ETrue;
+			break;
+			}
+		toMove = CGomokuBoard::Opponent(toMove);
+		}
+
+	if (!finished)
+		{
+		winner = Playout(toMove);
+		}
+
+	// Backpropagation: the node at depth 1 was reached through a move of
+	// the player at the root, the next one through a move of the opponent, ...
+	const eCellColor rootEnemy = CGomokuBoard::Opponent(rootToMove);
+	for (TInt i = depth; i >= 0; i--)
+		{
+		TGomokuMctsNode& pathNode = nodes[iPath[i]];
+		const eCellColor mover = (i & 1) ? rootToMove : rootEnemy;
+		if (winner == mover)
+			{
+			User::LockedInc(pathNode.iScore);
+			User::LockedInc(pathNode.iScore);
+			}
+		else if (winner == EColorNeutral)
+			{
+			User::LockedInc(pathNode.iScore);
+			}
+		}
+
+	// Go back to the root position.
+	while (iBoard->MoveCount() > iRootMoves)
+		{
+		iBoard->UndoMove();
+		}
+	iPlayouts++;
+	}
+
+void CGomokuMctsWorker::Expand(TInt aNode, eCellColor aToMove)
+	{
+	const TInt numCells = iBoard->NumCells();
+	TInt numCandidates = 0;
+	if (iSearch.iTreeFull)
+		{
+		// The tree doesn't grow any more, no need to collect the moves.
+		return;
+		}
+	if (iBoard->RemainingFreeCells() == numCells)
+		{
+		// Empty board: only the center is interesting.
+		iCandidates[numCandidates++] = (TInt16) iBoard->Index(
+				iBoard->Cols() / 2, iBoard->Rows() / 2);
+		}
+	else
+		{
+		// Collect all free cells close to any stone.
+		ResetMarks();
+		for (TInt pos = 0; pos < numCells; pos++)
+			{
+			if (iBoard->CellAt(pos) == EColorNeutral)
+				{
+				continue;
+				}
+			const TInt stoneX = pos % iBoard->Cols();
+			const TInt stoneY = pos / iBoard->Cols();
+			for (TInt y = stoneY - KMctsRadius; y <= stoneY + KMctsRadius; y++)
+				{
+				for (TInt x = stoneX - KMctsRadius; x <= stoneX + KMctsRadius; x++)
+					{
+					if (iBoard->IsInside(x, y) && iBoard->Cell(x, y)
+							== EColorNeutral && Mark(iBoard->Index(x, y)))
+						{
+						iCandidates[numCandidates++] = (TInt16) iBoard->Index(x, y);
+						}
+					}
+				}
+			}
+		}
+	if (numCandidates == 0)
+		{
+		return;
+		}
+
+	TInt i;
+	TBool winning = EFalse;
+	for (i = 0; i < numCandidates && !winning; i++)
+		{
+		winning = Play(iCandidates[i], aToMove);
+		iBoard->UndoMove();
+		if (winning)
+			{
+			// Only the winning move is interesting.
+			iCandidates[0] = iCandidates[i];
+			numCandidates = 1;
+			}
+		}
+
+	if (!winning)
+		{
+		// If the opponent could win with the next move, only blocking that move
+		// or capturing a pair can help.
+		const eCellColor enemyColor = CGomokuBoard::Opponent(aToMove);
+		ResetMarks();
+		TInt numThreats = 0;
+		for (i = 0; i < numCandidates; i++)
+			{
+			const TBool threat = Play(iCandidates[i], enemyColor);
+			iBoard->UndoMove();
+			if (threat)
+				{
+				Mark(iCandidates[i]);
+				numThreats++;
+				}
+			}
+		if (numThreats > 0)
+			{
+			TInt numDefences = 0;
+			for (i = 0; i < numCandidates; i++)
+				{
+				const TInt index = iCandidates[i];
+				if (!Mark(index) || (iSearch.iPairCheck && iBoard->CapturesPair(
+						index % iBoard->Cols(), index / iBoard->Cols(), aToMove)))
+					{
+					iCandidates[numDefences++] = (TInt16) index;
+					}
+				}
+			// If nothing helps, the game is lost anyway - keep all moves.
+			if (numDefences > 0)
+				{
+				numCandidates = numDefences;
+				}
+			}
+		}
+
+	iSearch.AddChildren(aNode, iCandidates, numCandidates, winning);
+	}
+
+eCellColor CGomokuMctsWorker::Playout(eCellColor aToMove)
+	{
+	const TInt numCells = iBoard->NumCells();
+	const TBool pairCheck = iSearch.iPairCheck;
+	const TInt numPairsWin = iSearch.iNumPairsWin;
+	iNumFree = 0;
+	for (TInt pos = 0; pos < numCells; pos++)
+		{
+		if (iBoard->CellAt(pos) == EColorNeutral)
+			{
+			AddFreeCell(pos);
+			}
+		else
+			{
+			iFreePos[pos] = -1;
+			}
+		}
+
+	// Cell that completes a four of the player, index 0 for EColor1.
+	TInt fourCell[2] =
+		{-1, -1};
+	eCellColor toMove = aToMove;
+	while (iNumFree > 0 && iBoard->MoveCount() < iBoard->MaxMoves())
+		{
+		const eCellColor enemyColor = CGomokuBoard::Opponent(toMove);
+		TInt index = fourCell[toMove - EColor1];
+		if (index < 0 || iFreePos[index] < 0)
+			{
+			// Block the four of the opponent
+			index = fourCell[enemyColor - EColor1];
+			if (index < 0 || iFreePos[index] < 0)
+				{
+				// Nothing forced, take a random free cell.
+				index = iFreeCells[iRandom.Next(iNumFree)];
+				}
+			}
+		RemoveFreeCell(index);
+
+		const TInt x = index % iBoard->Cols();
+		const TInt y = index / iBoard->Cols();
+		const TInt numPairs = iBoard->MakeMove(x, y, toMove, pairCheck);
+		if (numPairs > 0)
+			{
+			// The captured cells are free again.
+			for (TInt i = 0; i < numPairs * 2; i++)
+				{
+				AddFreeCell(iBoard->LastCapturedCell(i));
+				}
+			if (iBoard->CapturedPairs(toMove) >= numPairsWin)
+				{
+				return toMove;
+				}
+			}
+		if (iBoard->IsFive(x, y, toMove))
+			{
+			return toMove;
+			}
+		fourCell[toMove - EColor1] = FindFourCell(x, y, toMove);
+		toMove = enemyColor;
+		}
+	// Full board - draw.
+	return EColorNeutral;
+	}
+
+TInt CGomokuMctsWorker::FindFourCell(TInt aX, TInt aY, eCellColor aColor) const
+	{
+	// Horizontal, vertical and both diagonal directions.
+	const TInt KDirX[4] =
+		{1, 0, 1, 1};
+	const TInt KDirY[4] =
+		{0, 1, 1, -1};
+	for (TInt dir = 0; dir < 4; dir++)
+		{
+		// All segments of 5 cells that contain the stone.
+		for (TInt start = -4; start <= 0; start++)
+			{
+			const TInt startX = aX + start * KDirX[dir];
+			const TInt startY = aY + start * KDirY[dir];
+			if (!iBoard->IsInside(startX, startY) || !iBoard->IsInside(startX
+					+ 4 * KDirX[dir], startY + 4 * KDirY[dir]))
+				{
+				continue;
+				}
+			TInt stones = 0;
+			TInt freeCell = -1;
+			for (TInt i = 0; i < 5; i++)
+				{
+				const TInt x = startX + i * KDirX[dir];
+				const TInt y = startY + i * KDirY[dir];
+				const eCellColor color = iBoard->Cell(x, y);
+				if (color == aColor)
+					{
+					stones++;
+					}
+				else if (color == EColorNeutral)
+					{
+					freeCell = iBoard->Index(x, y);
+					}
+				}
+			if (stones == 4 && freeCell >= 0)
+				{
+				return freeCell;
+				}
+			}
+		}
+	return -1;
+	}
+
+TBool CGomokuMctsWorker::Play(TInt aIndex, eCellColor aColor)
+	{
+	const TInt x = aIndex % iBoard->Cols();
+	const TInt y = aIndex / iBoard->Cols();
+	iBoard->MakeMove(x, y, aColor, iSearch.iPairCheck);
+	return iBoard->IsFive(x, y, aColor) || (iSearch.iPairCheck
+			&& iBoard->CapturedPairs(aColor) >= iSearch.iNumPairsWin);
+	}
+
+void CGomokuMctsWorker::ResetMarks()
+	{
+	iMarkGeneration++;
+	if (iMarkGeneration == 0)
+		{
+		// Overflow - clear all marks of earlier generations.
+		Mem::FillZ(iMarks, iBoard->NumCells() * sizeof(TUint32));
+		iMarkGeneration = 1;
+		}
+	}
@@ -0,0 +1,294 @@
+/*
+ ============================================================================
+ Name		 : GomokuMctsWorker.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Runs iterations of the Monte-Carlo tree search, either on
+               the main thread or in its own worker thread.
+ ============================================================================
+ */
+
+#ifndef GOMOKUMCTSWORKER_H_
+#define GOMOKUMCTSWORKER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuRandom.h"
+
+// FORWARD DECLARATIONS
+class CGomokuMctsSearch;
+
+// CLASS DECLARATION
+
+/**
+ * One worker of the Monte-Carlo tree search.
+ *
+ * The tree is shared by all workers and owned by CGomokuMctsSearch.
+ * Everything that is modified during an iteration (the board, the path,
+ * the free cells of the playout and the random numbers) belongs to the
+ * worker, so several workers can search the same tree at the same time.
+ */
+class CGomokuMctsWorker : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor. Stops the thread if it is still running.
+	 */
+	~CGomokuMctsWorker();
+
+	/**
+	 * Two-phased constructor.
+	 * \param aSearch the search that owns the tree.
+	 */
+	static CGomokuMctsWorker* NewL(CGomokuMctsSearch& aSearch);
+
+public:
+	/**
+	 * Create the board and the buffers for a new game.
+	 */
+	void InitL(TSize aGridSize);
+
+	/**
+	 * Prepare a new search.
+	 *
+	 * \param aGrid position of the root.
+	 * \param aSeed seed for the random number generator.
+	 */
+	void StartSearch(const CGrid* aGrid, TUint64 aSeed);
+
+	/**
+	 * Make a move on the root position.
+	 * \param aIndex position of the move in the cell array.
+	 * \param aColor color of the player that makes the move.
+	 */
+	void AdvanceRoot(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Start counting the playouts again.
+	 */
+	void ResetPlayouts();
+
+	/**
+	 * Find the move that leads from the root position to the grid.
+	 * \return position of the only new stone of the color in the grid,
+	 * -1 if there is none or more than one.
+	 */
+	TInt FindNewStone(const CGrid* aGrid, eCellColor aColor) const;
+
+	/**
+	 * \return ETrue if the root position has the same stones as the grid.
+	 */
+	TBool IsSamePosition(const CGrid* aGrid) const;
+
+	/**
+	 * Walk down the tree, expand the leaf, play out and update the path.
+	 */
+	void RunIteration();
+
+	/**
+	 * Start a thread that runs iterations until StopThread() is called.
+	 */
+	void StartThreadL();
+
+	/**
+	 * Stop the thread and wait until it has finished the current iteration.
+	 * Does nothing if no thread is running.
+	 */
+	void StopThread();
+
+	/**
+	 * Convert a position in the cell array to coordinates.
+	 * \param aIndex position, or -1 to get any free cell of the root position.
+	 */
+	TPoint MoveToPoint(TInt aIndex) const;
+
+	/**
+	 * Convert coordinates to a position in the cell array.
+	 */
+	TInt PointToMove(const TPoint& aPoint) const;
+
+	/**
+	 * Number of playouts of this worker since StartSearch().
+	 */
+	TInt Playouts() const;
+
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuMctsWorker(CGomokuMctsSearch& aSearch);
+
+	/**
+	 * Delete all arrays owned by the worker.
+	 */
+	void DeleteArrays();
+
+	/**
+	 * Entry function of the worker thread.
+	 * \param aWorker the worker that runs in the thread.
+	 */
+	static TInt ThreadFunction(TAny* aWorker);
+
+	/**
+	 * Collect the sensible moves of the current board position and add them
+	 * to the tree as children of the node.
+	 */
+	void Expand(TInt aNode, eCellColor aToMove);
+
+	/**
+	 * Play random moves until the game has ended.
+	 * \return color of the winner, EColorNeutral for a draw.
+	 */
+	eCellColor Playout(eCellColor aToMove);
+
+	/**
+	 * Search the lines through the stone for a segment of 5 cells with
+	 * 4 stones of its color and one free cell.
+	 * \return the position of the free cell, -1 if there is no such segment.
+	 */
+	TInt FindFourCell(TInt aX, TInt aY, eCellColor aColor) const;
+
+	/**
+	 * Remove the cell from the list of free cells of the playout.
+	 */
+	inline void RemoveFreeCell(TInt aIndex);
+
+	/**
+	 * Add the cell to the list of free cells of the playout.
+	 */
+	inline void AddFreeCell(TInt aIndex);
+
+	/**
+	 * Place a stone on the board.
+	 * \return ETrue if this move wins the game for aColor.
+	 */
+	TBool Play(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Start a new set of collected cells, every cell can be added once.
+	 */
+	void ResetMarks();
+
+	/**
+	 * Mark the cell as collected.
+	 * \return ETrue if the cell was not marked before.
+	 */
+	inline TBool Mark(TInt aIndex);
+
+private:
+	/**
+	 * The search that owns the tree.
+	 */
+	CGomokuMctsSearch& iSearch;
+
+	/**
+	 * Board that the iterations are played on. Contains the root position
+	 * between two iterations.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * Number of moves on iBoard that lead to the root position.
+	 */
+	TInt iRootMoves;
+
+	/**
+	 * Nodes of the path of the current iteration.
+	 */
+	TInt* iPath;
+
+	/**
+	 * Free cells during a playout.
+	 */
+	TInt16* iFreeCells;
+
+	/**
+	 * Position of every cell in iFreeCells, -1 if the cell is taken.
+	 */
+	TInt16* iFreePos;
+
+	/**
+	 * Number of entries in iFreeCells.
+	 */
+	TInt iNumFree;
+
+	/**
+	 * Candidate moves when expanding a node.
+	 */
+	TInt16* iCandidates;
+
+	/**
+	 * Generation number for every cell, used to collect each cell only once.
+	 */
+	TUint32* iMarks;
+
+	/**
+	 * Current generation of iMarks.
+	 */
+	TUint32 iMarkGeneration;
+
+	/**
+	 * Number of playouts since StartSearch().
+	 */
+	TInt iPlayouts;
+
+	/**
+	 * Random number generator of the playouts.
+	 */
+	TGomokuRandom iRandom;
+
+	/**
+	 * Worker thread, only open while the thread is running.
+	 */
+	RThread iThread;
+
+	/**
+	 * Completed when the worker thread has ended.
+	 */
+	TRequestStatus iThreadStatus;
+
+	/**
+	 * ETrue while the worker thread is running.
+	 */
+	TBool iThreadRunning;
+	};
+
+inline void CGomokuMctsWorker::RemoveFreeCell(TInt aIndex)
+	{
+	// Move the last entry into the gap.
+	const TInt pos = iFreePos[aIndex];
+	const TInt last = iFreeCells[--iNumFree];
+	iFreeCells[pos] = (TInt16) last;
+	iFreePos[last] = (TInt16) pos;
+	iFreePos[aIndex] = -1;
+	}
+
+inline void CGomokuMctsWorker::AddFreeCell(TInt aIndex)
+	{
+	iFreePos[aIndex] = (TInt16) iNumFree;
+	iFreeCells[iNumFree++] = (TInt16) aIndex;
+	}
+
+inline TBool CGomokuMctsWorker::Mark(TInt aIndex)
+	{
+	if (iMarks[aIndex] == iMarkGeneration)
+		{
+		return EFalse;
+		}
+	iMarks[aIndex] = iMarkGeneration;
+	return ETrue;
+	}
+
+#endif /*GOMOKUMCTSWORKER_H_*/
@@ -0,0 +1,218 @@
+/*
+ ============================================================================
+ Name		 : GomokuMoveOrdering.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuMoveOrdering implementation
+ ============================================================================
+ */
+
+#include "GomokuMoveOrdering.h"
+
+CGomokuMoveOrdering::CGomokuMoveOrdering()
+	{
+	// No implementation required
+	}
+
+CGomokuMoveOrdering::~CGomokuMoveOrdering()
+	{
+	delete[] iHistory;
+	delete[] iScores;
+	}
+
+CGomokuMoveOrdering* CGomokuMoveOrdering::NewL()
+	{
+	CGomokuMoveOrdering* self = new (ELeave) CGomokuMoveOrdering();
+	return self;
+	}
+
+void CGomokuMoveOrdering::InitL(TInt aNumCells, TBool aPairCheck)
+	{
+	delete[] iHistory;
+	iHistory = NULL;
+	delete[] iScores;
+	iScores = NULL;
+	iNumCells = aNumCells;
+	iPairCheck = aPairCheck;
+	iHistory = new (ELeave) TInt[aNumCells * 2];
+	Mem::FillZ(iHistory, aNumCells * 2 * sizeof(TInt));
+	iScores = new (ELeave) TInt[aNumCells];
+	NewSearch();
+	ResetStatistics();
+	}
+
+void CGomokuMoveOrdering::NewSearch()
+	{
+	for (TInt ply = 0; ply < KOrderMaxPly; ply++)
+		{
+		for (TInt i = 0; i < KOrderKillers; i++)
+			{
+			iKillers[ply][i] = -1;
+			}
+		}
+	for (TInt i = 0; i < iNumCells * 2; i++)
+		{
+		iHistory[i] /= 2;
+		}
+	}
+
+void CGomokuMoveOrdering::OrderMoves(const CGomokuBoard& aBoard, TInt aPly,
+		eCellColor aToMove, TInt aHashMove, TInt* aMoves, TInt aNumMoves)
+	{
+	for (TInt i = 0; i < aNumMoves; i++)
+		{
+		iScores[i] = ScoreMove(aBoard, aPly, aToMove, aHashMove, aMoves[i]);
+		}
+	// Insertion sort: stable, and the lists are short and often
+	// almost sorted (most moves only have a history score).
+	for (TInt i = 1; i < aNumMoves; i++)
+		{
+		const TInt move = aMoves[i];
+		const TInt score = iScores[i];
+		TInt j = i;
+		while (j > 0 && iScores[j - 1] < score)
+			{
+			aMoves[j] = aMoves[j - 1];
+			iScores[j] = iScores[j - 1];
+			j--;
+			}
+		aMoves[j] = move;
+		iScores[j] = score;
+		}
+	}
+
+TInt CGomokuMoveOrdering::ScoreMove(const CGomokuBoard& aBoard, TInt aPly,
+		eCellColor aToMove, TInt aHashMove, TInt aMove) const
+	{
+	if (aMove == aHashMove)
+		{
+		return KOrderHashMove;
+		}
+	const TInt x = aMove % aBoard.Cols();
+	const TInt y = aMove / aBoard.Cols();
+	TInt score = ScoreLines(aBoard, x, y, aToMove, KOrderWin, KOrderFour,
+			KOrderOpenThree);
+	score = Max(score, ScoreLines(aBoard, x, y, CGomokuBoard::Opponent(
+			aToMove), KOrderBlockWin, KOrderBlockFour, KOrderBlockOpenThree));
+	if (iPairCheck && score < KOrderCapture && aBoard.CapturesPair(x, y,
+			aToMove))
+		{
+		score = KOrderCapture;
+		}
+	if (score > 0)
+		{
+		return score;
+		}
+
+	if (aPly < KOrderMaxPly)
+		{
+		if (iKillers[aPly][0] == aMove)
+			{
+			return KOrderKiller;
+			}
+		if (iKillers[aPly][1] == aMove)
+			{
+			return KOrderKiller / 2;
+			}
+		}
+	return iHistory[HistoryIndex(aToMove, aMove)];
+	}
+
+void CGomokuMoveOrdering::RecordCutoff(TInt aPly, eCellColor aToMove,
+		TInt aMove, TInt aOrder, TInt aDepth)
+	{
+	iCutoffs++;
+	if (aOrder == 0)
+		{
+		iFirstMoveCutoffs++;
+		}
+	if (aPly < KOrderMaxPly && iKillers[aPly][0] != aMove)
+		{
+		iKillers[aPly][1] = iKillers[aPly][0];
+		iKillers[aPly][0] = aMove;
+		}
+	TInt& history = iHistory[HistoryIndex(aToMove, aMove)];
+	history = Min(history + aDepth * aDepth, KOrderMaxHistory);
+	}
+
+void CGomokuMoveOrdering::ResetStatistics()
+	{
+	iCutoffs = 0;
+	iFirstMoveCutoffs = 0;
+	}
+
+TInt CGomokuMoveOrdering::Cutoffs() const
+	{
+	return iCutoffs;
+	}
+
+TInt CGomokuMoveOrdering::FirstMoveCutoffs() const
+	{
+	return iFirstMoveCutoffs;
+	}
+
+TInt CGomokuMoveOrdering::FirstMoveCutoffRate() const
+	{
+	if (iCutoffs == 0)
+		{
+		return 0;
+		}
+	return (TInt) ((TInt64) iFirstMoveCutoffs * 100 / iCutoffs);
+	}
+
+TInt CGomokuMoveOrdering::ScoreLines(const CGomokuBoard& aBoard, TInt aX,
+		TInt aY, eCellColor aColor, TInt aFive, TInt aFour, TInt aOpenThree)
+	{
+	// Directions: right, down, down right, up right
+	const TInt dx[] =
+		{
+		1, 0, 1, 1
+		};
+	const TInt dy[] =
+		{
+		0, 1, 1, -1
+		};
+	TInt score = 0;
+	for (TInt dir = 0; dir < 4; dir++)
+		{
+		TBool openForward = EFalse;
+		TBool openBackward = EFalse;
+		const TInt length = 1 + CountStones(aBoard, aX, aY, dx[dir], dy[dir],
+				aColor, openForward) + CountStones(aBoard, aX, aY, -dx[dir],
+				-dy[dir], aColor, openBackward);
+		if (length >= 5)
+			{
+			return aFive;
+			}
+		if (length == 4)
+			{
+			score = aFour;
+			}
+		else if (length == 3 && openForward && openBackward)
+			{
+			score = Max(score, aOpenThree);
+			}
+		}
+	return score;
+	}
+
+TInt CGomokuMoveOrdering::CountStones(const CGomokuBoard& aBoard, TInt aX,
+		TInt aY, TInt aDx, TInt aDy, eCellColor aColor, TBool& aOpen)
+	{
+	TInt count = 0;
+	aX += aDx;
+	aY += aDy;
+	while (aBoard.IsInside(aX, aY) && aBoard.Cell(aX, aY) == aColor)
+		{
+		count++;
+		aX += aDx;
+		aY += aDy;
+		}
+	aOpen = aBoard.IsInside(aX, aY) && aBoard.Cell(aX, aY) == EColorNeutral;
+	return count;
+	}
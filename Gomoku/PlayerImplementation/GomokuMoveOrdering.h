@@ -0,0 +1,274 @@
+/*
+ ============================================================================
+ Name		 : GomokuMoveOrdering.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Orders the moves of a search: hash move, wins and blocks,
+               threats, killer moves and history heuristic.
+ ============================================================================
+ */
+
+#ifndef GOMOKUMOVEORDERING_H_
+#define GOMOKUMOVEORDERING_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "GomokuBoard.h"
+
+/**
+ * Maximum search depth that has own killer moves.
+ */
+const TInt KOrderMaxPly = 64;
+
+/**
+ * Number of killer moves per ply.
+ */
+const TInt KOrderKillers = 2;
+
+/**
+ * Order score of the move from the hash table.
+ */
+const TInt KOrderHashMove = 1 << 30;
+
+/**
+ * Order score of a move that makes five in a row.
+ */
+const TInt KOrderWin = 1 << 29;
+
+/**
+ * Order score of a move that blocks five in a row of the opponent.
+ */
+const TInt KOrderBlockWin = 1 << 28;
+
+/**
+ * Order score of a move that makes four in a row.
+ */
+const TInt KOrderFour = 1 << 27;
+
+/**
+ * Order score of a move that blocks four in a row of the opponent.
+ */
+const TInt KOrderBlockFour = 1 << 26;
+
+/**
+ * Order score of a move that makes an open three.
+ */
+const TInt KOrderOpenThree = 1 << 25;
+
+/**
+ * Order score of a move that captures a pair (only with pair check).
+ */
+const TInt KOrderCapture = 1 << 24;
+
+/**
+ * Order score of a move that blocks an open three of the opponent.
+ */
+const TInt KOrderBlockOpenThree = 1 << 23;
+
+/**
+ * Order score of the first killer move, the second one gets half of it.
+ */
+const TInt KOrderKiller = 1 << 22;
+
+/**
+ * Maximum history score of a move, so that the history never outweighs
+ * a killer move.
+ */
+const TInt KOrderMaxHistory = (1 << 21) - 1;
+
+// CLASS DECLARATION
+
+/**
+ * Move ordering for search algorithms.
+ *
+ * Searches are much faster if the best move is tried first: alpha-beta
+ * can cut off the other moves, proof-number search proves a position with
+ * fewer nodes. With 200 and more free cells per position, the order of the
+ * moves matters more than almost anything else.
+ *
+ * OrderMoves() sorts the moves of a position by these criteria, from the
+ * most to the least important one:
+ * - the move stored in the hash table for this position,
+ * - moves that win immediately, then moves that block a win of the opponent,
+ * - moves that make a four, block a four, make an open three, capture a
+ *   pair or block an open three,
+ * - the killer moves of the ply: moves that caused a cutoff in a sibling
+ *   position,
+ * - the history score: how often (and how close to the root) a move
+ *   caused a cutoff anywhere in the search.
+ * Moves with the same score keep their original order.
+ *
+ * The search reports each cutoff with RecordCutoff(). Besides updating the
+ * killer moves and the history, this counts how often the first move of
+ * the ordered list caused the cutoff. This first-move cutoff rate shows how
+ * good the ordering is: ideally, it is close to 100%.
+ */
+class CGomokuMoveOrdering : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuMoveOrdering();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuMoveOrdering* NewL();
+
+public:
+	/**
+	 * Prepare the ordering for a new game.
+	 *
+	 * \param aNumCells number of cells of the board.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 */
+	void InitL(TInt aNumCells, TBool aPairCheck);
+
+	/**
+	 * Start a new search. Clears the killer moves and reduces the history
+	 * scores, so that recent cutoffs are more important.
+	 */
+	void NewSearch();
+
+	/**
+	 * Sort the moves of a position, the most promising move first.
+	 *
+	 * \param aBoard the position.
+	 * \param aPly distance of the position to the root of the search.
+	 * \param aToMove color of the player to move.
+	 * \param aHashMove move from the hash table, -1 if none.
+	 * \param aMoves positions of the moves in the cell array, sorted in place.
+	 * \param aNumMoves number of moves.
+	 */
+	void OrderMoves(const CGomokuBoard& aBoard, TInt aPly, eCellColor aToMove,
+			TInt aHashMove, TInt* aMoves, TInt aNumMoves);
+
+	/**
+	 * Score of a move, used by OrderMoves(). Higher is better.
+	 *
+	 * \param aBoard the position.
+	 * \param aPly distance of the position to the root of the search.
+	 * \param aToMove color of the player to move.
+	 * \param aHashMove move from the hash table, -1 if none.
+	 * \param aMove position of the move in the cell array.
+	 */
+	TInt ScoreMove(const CGomokuBoard& aBoard, TInt aPly, eCellColor aToMove,
+			TInt aHashMove, TInt aMove) const;
+
+	/**
+	 * A move caused a cutoff (or proved the position).
+	 *
+	 * \param aPly distance of the position to the root of the search.
+	 * \param aToMove color of the player that made the move.
+	 * \param aMove position of the move in the cell array.
+	 * \param aOrder position of the move in the ordered list, 0 for the first.
+	 * \param aDepth remaining search depth; cutoffs close to the root get
+	 * a higher history score.
+	 */
+	void RecordCutoff(TInt aPly, eCellColor aToMove, TInt aMove, TInt aOrder,
+			TInt aDepth);
+
+	/**
+	 * Set the number of cutoffs back to 0.
+	 */
+	void ResetStatistics();
+
+	/**
+	 * Number of cutoffs since the statistics were reset.
+	 */
+	TInt Cutoffs() const;
+
+	/**
+	 * Number of cutoffs by the first move of the ordered list since the
+	 * statistics were reset.
+	 */
+	TInt FirstMoveCutoffs() const;
+
+	/**
+	 * First-move cutoff rate in percent, 0 if there was no cutoff.
+	 */
+	TInt FirstMoveCutoffRate() const;
+
+	/**
+	 * Score for the lines that a stone of the color would make on the cell.
+	 * Only counts stones in a row, without gaps.
+	 *
+	 * \param aFive score for five in a row.
+	 * \param aFour score for four in a row.
+	 * \param aOpenThree score for three in a row with free cells on both ends.
+	 */
+	static TInt ScoreLines(const CGomokuBoard& aBoard, TInt aX, TInt aY,
+			eCellColor aColor, TInt aFive, TInt aFour, TInt aOpenThree);
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuMoveOrdering();
+
+	/**
+	 * Number of stones of the color next to the cell in one direction.
+	 *
+	 * \param aOpen set to ETrue if the cell after the stones is free.
+	 */
+	static TInt CountStones(const CGomokuBoard& aBoard, TInt aX, TInt aY,
+			TInt aDx, TInt aDy, eCellColor aColor, TBool& aOpen);
+
+	/**
+	 * Position of the history score of a move in iHistory.
+	 */
+	inline TInt HistoryIndex(eCellColor aColor, TInt aMove) const;
+
+private:
+	/**
+	 * History score of every cell for both colors.
+	 */
+	TInt* iHistory;
+
+	/**
+	 * Number of cells of the board.
+	 */
+	TInt iNumCells;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Killer moves of every ply, -1 if not set.
+	 */
+	TInt iKillers[KOrderMaxPly][KOrderKillers];
+
+	/**
+	 * Scores of the moves while sorting, one per cell.
+	 */
+	TInt* iScores;
+
+	/**
+	 * Number of cutoffs since the statistics were reset.
+	 */
+	TInt iCutoffs;
+
+	/**
+	 * Number of cutoffs by the first move.
+	 */
+	TInt iFirstMoveCutoffs;
+	};
+
+inline TInt CGomokuMoveOrdering::HistoryIndex(eCellColor aColor,
+		TInt aMove) const
+	{
+	return (aColor - EColor1) * iNumCells + aMove;
+	}
+
+#endif /*GOMOKUMOVEORDERING_H_*/
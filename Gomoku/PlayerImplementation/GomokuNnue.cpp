@@ -0,0 +1,352 @@
+/*
+ ============================================================================
+ Name		 : GomokuNnue.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuNnue implementation
+ ============================================================================
+ */
+
+#include "GomokuNnue.h"
+#include "GomokuOpeningBook.h"
+
+#if defined(__ARM_NEON__) && !defined(GOMOKU_NNUE_SCALAR)
+#define GOMOKU_NNUE_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * Read a 16 bit little endian number.
+ */
+LOCAL_C inline TInt16 Get16(const TUint8* aPtr)
+	{
+	return (TInt16) (aPtr[0] | (aPtr[1] << 8));
+	}
+
+/**
+ * Read a 32 bit little endian number.
+ */
+LOCAL_C inline TInt32 Get32(const TUint8* aPtr)
+	{
+	return (TInt32) ((TUint32) aPtr[0] | ((TUint32) aPtr[1] << 8)
+			| ((TUint32) aPtr[2] << 16) | ((TUint32) aPtr[3] << 24));
+	}
+
+CGomokuNnue::CGomokuNnue()
+	{
+	// No implementation required
+	}
+
+CGomokuNnue::~CGomokuNnue()
+	{
+	Unload();
+	}
+
+CGomokuNnue* CGomokuNnue::NewL()
+	{
+	CGomokuNnue* self = new (ELeave) CGomokuNnue();
+	return self;
+	}
+
+TInt CGomokuNnue::Load(const TDesC& aFileName)
+	{
+	Unload();
+
+	RFs fs;
+	TInt err = fs.Connect();
+	if (err != KErrNone)
+		{
+		return err;
+		}
+	TFileName fileName;
+	err = CGomokuOpeningBook::GetFileName(fs, aFileName, fileName);
+	RFile file;
+	if (err == KErrNone)
+		{
+		err = file.Open(fs, fileName, EFileRead | EFileShareReadersOnly);
+		if (err == KErrPathNotFound)
+			{
+			err = KErrNotFound;
+			}
+		}
+	if (err == KErrNone)
+		{
+		TInt size = 0;
+		err = file.Size(size);
+		HBufC8* network = NULL;
+		if (err == KErrNone)
+			{
+			network = HBufC8::New(size);
+			err = network ? KErrNone : KErrNoMemory;
+			}
+		if (err == KErrNone)
+			{
+			TPtr8 networkPtr = network->Des();
+			err = file.Read(networkPtr);
+			}
+		if (err == KErrNone)
+			{
+			err = Load(*network);
+			}
+		delete network;
+		file.Close();
+		}
+	fs.Close();
+	return err;
+	}
+
+TInt CGomokuNnue::Load(const TDesC8& aNetwork)
+	{
+	Unload();
+
+	const TUint8* ptr = aNetwork.Ptr();
+	if (aNetwork.Length() < KNnueHeaderSize || (TUint32) Get32(ptr)
+			!= KNnueMagic || (TUint32) Get32(ptr + 4) != KNnueVersion)
+		{
+		return KErrCorrupt;
+		}
+	const TInt cols = Get32(ptr + 8);
+	const TInt rows = Get32(ptr + 12);
+	const TInt size = Get32(ptr + 16);
+	const TInt outputShift = Get32(ptr + 20);
+	// Sizes far beyond any grid are rejected before they can overflow.
+	if (cols <= 0 || rows <= 0 || cols > 0xFF || rows > 0xFF
+			|| size <= 0 || size > KNnueMaxAccumulator || size % 8 != 0
+			|| outputShift < 0 || outputShift > 30)
+		{
+		return KErrCorrupt;
+		}
+	const TInt numCells = cols * rows;
+	const TInt numInputWeights = 2 * numCells * size;
+	const TInt numHiddenWeights = KNnueHidden * 2 * size;
+	if (aNetwork.Length() != KNnueHeaderSize + 2 * numInputWeights + 2 * size
+			+ numHiddenWeights + 4 * KNnueHidden + KNnueHidden + 4)
+		{
+		return KErrCorrupt;
+		}
+
+	iInputWeights = new TInt16[numInputWeights];
+	iInputBias = new TInt16[size];
+	iHiddenWeights = new TInt8[numHiddenWeights];
+	iAccumulators = new TInt16[(KNnueMaxPly + 1) * 2 * size];
+	if (!iInputWeights || !iInputBias || !iHiddenWeights || !iAccumulators)
+		{
+		Unload();
+		return KErrNoMemory;
+		}
+
+	ptr += KNnueHeaderSize;
+	TInt i;
+	for (i = 0; i < numInputWeights; i++, ptr += 2)
+		{
+		iInputWeights[i] = Get16(ptr);
+		}
+	for (i = 0; i < size; i++, ptr += 2)
+		{
+		iInputBias[i] = Get16(ptr);
+		}
+	for (i = 0; i < numHiddenWeights; i++, ptr++)
+		{
+		iHiddenWeights[i] = (TInt8) *ptr;
+		}
+	for (i = 0; i < KNnueHidden; i++, ptr += 4)
+		{
+		iHiddenBias[i] = Get32(ptr);
+		}
+	for (i = 0; i < KNnueHidden; i++, ptr++)
+		{
+		iOutputWeights[i] = (TInt8) *ptr;
+		}
+	iOutputBias = Get32(ptr);
+
+	iGridSize.SetSize(cols, rows);
+	iNumCells = numCells;
+	iSize = size;
+	iOutputShift = outputShift;
+	iPly = 0;
+	return KErrNone;
+	}
+
+TBool CGomokuNnue::Supports(TSize aGridSize) const
+	{
+	return iNumCells > 0 && aGridSize == iGridSize;
+	}
+
+void CGomokuNnue::Refresh(const CGrid* aGrid)
+	{
+	iPly = 0;
+	Mem::Copy(Accumulator(EColor1), iInputBias, iSize * sizeof(TInt16));
+	Mem::Copy(Accumulator(EColor2), iInputBias, iSize * sizeof(TInt16));
+	for (TInt y = 0; y < iGridSize.iHeight; y++)
+		{
+		for (TInt x = 0; x < iGridSize.iWidth; x++)
+			{
+			const eCellColor color = aGrid->GetGridCell(x, y)->GetColor();
+			if (color != EColorNeutral)
+				{
+				UpdateStone(y * iGridSize.iWidth + x, color, 1);
+				}
+			}
+		}
+	}
+
+void CGomokuNnue::MakeMove(TInt aIndex, eCellColor aColor)
+	{
+	__ASSERT_DEBUG(iPly < KNnueMaxPly, User::Invariant());
+	// The accumulators of the previous ply stay as they are, so that the
+	// move can be taken back without any calculation.
+	Mem::Copy(Accumulator(EColor1) + 2 * iSize, Accumulator(EColor1), 2
+			* iSize * sizeof(TInt16));
+	iPly++;
+	UpdateStone(aIndex, aColor, 1);
+	}
+
+void CGomokuNnue::RemoveStone(TInt aIndex, eCellColor aColor)
+	{
+	UpdateStone(aIndex, aColor, -1);
+	}
+
+void CGomokuNnue::UndoMove()
+	{
+	iPly--;
+	}
+
+TInt CGomokuNnue::Evaluate(eCellColor aMyColor) const
+	{
+	// Clipped ReLU of the accumulators, own point of view first.
+	TInt8 inputs[2 * KNnueMaxAccumulator];
+	const TInt16* mine = Accumulator(aMyColor);
+	const TInt16* enemy = Accumulator(CGomokuBoard::Opponent(aMyColor));
+	TInt i;
+#ifdef GOMOKU_NNUE_NEON
+	const int16x8_t zero = vdupq_n_s16(0);
+	const int16x8_t activationMax = vdupq_n_s16(KNnueActivationMax);
+	for (i = 0; i < iSize; i += 8)
+		{
+		vst1_s8(inputs + i, vmovn_s16(vmaxq_s16(vminq_s16(vld1q_s16(mine
+				+ i), activationMax), zero)));
+		vst1_s8(inputs + iSize + i, vmovn_s16(vmaxq_s16(vminq_s16(vld1q_s16(
+				enemy + i), activationMax), zero)));
+		}
+#else
+	for (i = 0; i < iSize; i++)
+		{
+		inputs[i] = (TInt8) Max(0, Min((TInt) mine[i], KNnueActivationMax));
+		inputs[iSize + i] = (TInt8) Max(0, Min((TInt) enemy[i],
+				KNnueActivationMax));
+		}
+#endif
+
+	TInt8 hidden[KNnueHidden];
+	for (i = 0; i < KNnueHidden; i++)
+		{
+		const TInt sum = iHiddenBias[i] + DotProduct(inputs, iHiddenWeights
+				+ i * 2 * iSize, 2 * iSize);
+		hidden[i] = (TInt8) Min(Max(sum, 0) >> KNnueHiddenShift,
+				KNnueActivationMax);
+		}
+
+	const TInt output = iOutputBias + DotProduct(hidden, iOutputWeights,
+			KNnueHidden);
+	// Round towards zero, so that the rating is symmetric.
+	return (output >= 0) ? (output >> iOutputShift) : -((-output)
+			>> iOutputShift);
+	}
+
+void CGomokuNnue::Unload()
+	{
+	delete[] iInputWeights;
+	iInputWeights = NULL;
+	delete[] iInputBias;
+	iInputBias = NULL;
+	delete[] iHiddenWeights;
+	iHiddenWeights = NULL;
+	delete[] iAccumulators;
+	iAccumulators = NULL;
+	iGridSize.SetSize(0, 0);
+	iNumCells = 0;
+	iSize = 0;
+	iPly = 0;
+	}
+
+void CGomokuNnue::UpdateStone(TInt aIndex, eCellColor aColor, TInt aSign)
+	{
+	// The stone is an own stone for the accumulator of its player and an
+	// enemy stone for the other one.
+	TInt16* own = Accumulator(aColor);
+	TInt16* enemy = Accumulator(CGomokuBoard::Opponent(aColor));
+	const TInt16* ownWeights = iInputWeights + aIndex * iSize;
+	const TInt16* enemyWeights = iInputWeights + (iNumCells + aIndex) * iSize;
+	if (aSign > 0)
+		{
+		AddWeights(own, ownWeights);
+		AddWeights(enemy, enemyWeights);
+		}
+	else
+		{
+		SubtractWeights(own, ownWeights);
+		SubtractWeights(enemy, enemyWeights);
+		}
+	}
+
+void CGomokuNnue::AddWeights(TInt16* aAccumulator, const TInt16* aWeights) const
+	{
+#ifdef GOMOKU_NNUE_NEON
+	for (TInt i = 0; i < iSize; i += 8)
+		{
+		vst1q_s16(aAccumulator + i, vaddq_s16(vld1q_s16(aAccumulator + i),
+				vld1q_s16(aWeights + i)));
+		}
+#else
+	for (TInt i = 0; i < iSize; i++)
+		{
+		aAccumulator[i] = (TInt16) (aAccumulator[i] + aWeights[i]);
+		}
+#endif
+	}
+
+void CGomokuNnue::SubtractWeights(TInt16* aAccumulator,
+		const TInt16* aWeights) const
+	{
+#ifdef GOMOKU_NNUE_NEON
+	for (TInt i = 0; i < iSize; i += 8)
+		{
+		vst1q_s16(aAccumulator + i, vsubq_s16(vld1q_s16(aAccumulator + i),
+				vld1q_s16(aWeights + i)));
+		}
+#else
+	for (TInt i = 0; i < iSize; i++)
+		{
+		aAccumulator[i] = (TInt16) (aAccumulator[i] - aWeights[i]);
+		}
+#endif
+	}
+
+TInt CGomokuNnue::DotProduct(const TInt8* aInputs, const TInt8* aWeights,
+		TInt aLength)
+	{
+#ifdef GOMOKU_NNUE_NEON
+	// The products of 8 bit numbers fit into 16 bits, pairs of them are
+	// added to the 32 bit sums.
+	int32x4_t sums = vdupq_n_s32(0);
+	for (TInt i = 0; i < aLength; i += 8)
+		{
+		sums = vpadalq_s16(sums, vmull_s8(vld1_s8(aInputs + i), vld1_s8(
+				aWeights + i)));
+		}
+	const int32x2_t pairs = vadd_s32(vget_low_s32(sums), vget_high_s32(sums));
+	return vget_lane_s32(vpadd_s32(pairs, pairs), 0);
+#else
+	TInt sum = 0;
+	for (TInt i = 0; i < aLength; i++)
+		{
+		sum += aInputs[i] * aWeights[i];
+		}
+	return sum;
+#endif
+	}
@@ -0,0 +1,295 @@
+/*
+ ============================================================================
+ Name		 : GomokuNnue.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Board evaluation by a small quantized neural network whose
+               first layer is updated incrementally.
+ ============================================================================
+ */
+
+#ifndef GOMOKUNNUE_H_
+#define GOMOKUNNUE_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <f32file.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+
+/**
+ * Name of the network in the private directory of the application.
+ */
+_LIT(KNnueFileName, "Evaluator.nnue");
+
+/**
+ * First word of a network file ("GNN1").
+ */
+const TUint32 KNnueMagic = 0x314E4E47;
+
+/**
+ * Version of the file format.
+ */
+const TUint32 KNnueVersion = 1;
+
+/**
+ * Size of the file header in bytes: magic, version, columns, rows, number
+ * of accumulator neurons, output shift.
+ */
+const TInt KNnueHeaderSize = 24;
+
+/**
+ * Maximum number of neurons of the accumulator (per perspective).
+ * The number must be a multiple of 8.
+ */
+const TInt KNnueMaxAccumulator = 256;
+
+/**
+ * Number of neurons of the hidden layer.
+ */
+const TInt KNnueHidden = 32;
+
+/**
+ * Highest output of a neuron (clipped ReLU), which stands for 1.0.
+ */
+const TInt KNnueActivationMax = 127;
+
+/**
+ * The sums of the hidden layer are divided by 2^KNnueHiddenShift.
+ */
+const TInt KNnueHiddenShift = 6;
+
+/**
+ * Number of moves that can be made on top of the refreshed position.
+ */
+const TInt KNnueMaxPly = 16;
+
+// CLASS DECLARATION
+
+/**
+ * Efficiently updatable neural network (NNUE) for rating boards.
+ *
+ * The network has three layers:
+ * - accumulator: every stone is an input (its cell, and whether it belongs
+ *   to the rated player or the opponent). The accumulator is the sum of the
+ *   16 bit weights of all stones plus the bias. It is kept for both players
+ *   and only changes by the weights of the placed and captured stones when
+ *   a move is made, instead of being calculated from the whole board.
+ * - hidden layer: KNnueHidden neurons with 8 bit weights on the clipped
+ *   accumulators of the rated player and the opponent.
+ * - output: one neuron with 8 bit weights, divided by 2^output shift.
+ *
+ * Like TGomokuLineEvaluator, the board is rated for a player whose opponent
+ * moves next. The network is trained for one grid size, it is only used
+ * for games on this size (see Supports()). Without a network file, the AIs
+ * use their own evaluation.
+ *
+ * File format (all numbers little endian):
+ * - header: KNnueMagic, KNnueVersion, columns, rows, accumulator size N,
+ *   output shift (32 bit each).
+ * - accumulator weights: 16 bit, N for every input. Input c is a stone of
+ *   the rated player on cell c (y * columns + x), input cells + c a stone
+ *   of the opponent.
+ * - accumulator bias: 16 bit, N.
+ * - hidden weights: 8 bit, 2 * N for every hidden neuron, first for the
+ *   accumulator of the rated player, then for the opponent.
+ * - hidden bias: 32 bit, KNnueHidden.
+ * - output weights: 8 bit, KNnueHidden.
+ * - output bias: 32 bit.
+ *
+ * The accumulator and the dot products use NEON instructions on processors
+ * that have them, and plain C++ otherwise (or if GOMOKU_NNUE_SCALAR is
+ * defined). Both give exactly the same results.
+ */
+class CGomokuNnue : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuNnue();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuNnue* NewL();
+
+public:
+	/**
+	 * Load a network file from the private directory of the application.
+	 * A previously loaded network is removed.
+	 *
+	 * \param aFileName name of the file.
+	 * \return KErrNone, KErrNotFound if there is no network, KErrCorrupt if
+	 * the file is not a valid network or KErrNoMemory.
+	 */
+	TInt Load(const TDesC& aFileName);
+
+	/**
+	 * Load a network from memory, in the format of the file.
+	 *
+	 * \return KErrNone, KErrCorrupt or KErrNoMemory.
+	 */
+	TInt Load(const TDesC8& aNetwork);
+
+	/**
+	 * \return ETrue if a network for this grid size is loaded.
+	 */
+	TBool Supports(TSize aGridSize) const;
+
+	/**
+	 * Calculate the accumulators for a position. Moves made before are
+	 * forgotten.
+	 */
+	void Refresh(const CGrid* aGrid);
+
+	/**
+	 * Update the accumulators for a move. Can be taken back with
+	 * UndoMove(). At most KNnueMaxPly moves can be made on top of the
+	 * refreshed position.
+	 *
+	 * \param aIndex cell of the move (y * columns + x).
+	 * \param aColor color of the stone.
+	 */
+	void MakeMove(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Remove a captured stone from the accumulators. Captured stones belong
+	 * to the last move made through MakeMove() and are restored with it by
+	 * UndoMove().
+	 *
+	 * \param aIndex cell of the stone.
+	 * \param aColor color of the stone.
+	 */
+	void RemoveStone(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Take back the last move made through MakeMove().
+	 */
+	void UndoMove();
+
+	/**
+	 * Rate the current position.
+	 *
+	 * \param aMyColor color of the player for whom the board is rated.
+	 * The opponent moves next.
+	 * \return rating, higher is better for aMyColor.
+	 */
+	TInt Evaluate(eCellColor aMyColor) const;
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuNnue();
+
+	/**
+	 * Remove the network.
+	 */
+	void Unload();
+
+	/**
+	 * Add (aSign 1) or remove (aSign -1) a stone in the accumulators of
+	 * the current ply.
+	 */
+	void UpdateStone(TInt aIndex, eCellColor aColor, TInt aSign);
+
+	/**
+	 * Accumulator of the current ply for the point of view of a player.
+	 */
+	inline TInt16* Accumulator(eCellColor aColor) const;
+
+	/**
+	 * aAccumulator += aWeights, for iSize neurons.
+	 */
+	void AddWeights(TInt16* aAccumulator, const TInt16* aWeights) const;
+
+	/**
+	 * aAccumulator -= aWeights, for iSize neurons.
+	 */
+	void SubtractWeights(TInt16* aAccumulator, const TInt16* aWeights) const;
+
+	/**
+	 * Sum of aInputs[i] * aWeights[i] for aLength inputs (a multiple of 8).
+	 */
+	static TInt DotProduct(const TInt8* aInputs, const TInt8* aWeights,
+			TInt aLength);
+
+private:
+	/**
+	 * Size of the grid the network is trained for, 0 if no network is
+	 * loaded.
+	 */
+	TSize iGridSize;
+
+	/**
+	 * Number of cells of the grid.
+	 */
+	TInt iNumCells;
+
+	/**
+	 * Number of neurons of the accumulator.
+	 */
+	TInt iSize;
+
+	/**
+	 * Shift of the output.
+	 */
+	TInt iOutputShift;
+
+	/**
+	 * Weights of the accumulator, iSize for every input. Owned.
+	 */
+	TInt16* iInputWeights;
+
+	/**
+	 * Bias of the accumulator. Owned.
+	 */
+	TInt16* iInputBias;
+
+	/**
+	 * Weights of the hidden layer, 2 * iSize for every neuron. Owned.
+	 */
+	TInt8* iHiddenWeights;
+
+	/**
+	 * Bias of the hidden layer.
+	 */
+	TInt32 iHiddenBias[KNnueHidden];
+
+	/**
+	 * Weights of the output.
+	 */
+	TInt8 iOutputWeights[KNnueHidden];
+
+	/**
+	 * Bias of the output.
+	 */
+	TInt32 iOutputBias;
+
+	/**
+	 * Accumulators of both players for every ply, iSize neurons each.
+	 * Owned.
+	 */
+	TInt16* iAccumulators;
+
+	/**
+	 * Current ply: number of moves made since the last refresh.
+	 */
+	TInt iPly;
+	};
+
+inline TInt16* CGomokuNnue::Accumulator(eCellColor aColor) const
+	{
+	return iAccumulators + (2 * iPly + (aColor == EColor2 ? 1 : 0)) * iSize;
+	}
+
+#endif /*GOMOKUNNUE_H_*/
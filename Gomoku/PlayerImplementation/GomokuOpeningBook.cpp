@@ -0,0 +1,422 @@
+/*
+ ============================================================================
+ Name		 : GomokuOpeningBook.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : TGomokuBookHash and CGomokuOpeningBook implementation
+ ============================================================================
+ */
+
+#include "GomokuOpeningBook.h"
+
+// ---------------------------------------------------------------------------
+// TGomokuBookHash
+// ---------------------------------------------------------------------------
+
+TUint64 TGomokuBookHash::CanonicalKey(const CGrid* aGrid, eCellColor aToMove,
+		TBool aPairCheck, TInt& aSymmetry)
+	{
+	TUint64 keys[8];
+	const TInt numSymmetries = SymmetryKeys(aGrid, aToMove, aPairCheck, keys);
+	aSymmetry = 0;
+	for (TInt s = 1; s < numSymmetries; s++)
+		{
+		if (keys[s] < keys[aSymmetry])
+			{
+			aSymmetry = s;
+			}
+		}
+	return keys[aSymmetry];
+	}
+
+TUint64 TGomokuBookHash::CanonicalMove(const CGrid* aGrid,
+		eCellColor aToMove, TBool aPairCheck, TPoint aMove, TInt& aCell)
+	{
+	// A symmetric position (like the first stone in the middle) has the
+	// canonical key in several symmetries. Equal moves are stored as one
+	// move by using the smallest cell of all these symmetries.
+	const TSize size = aGrid->GetSize();
+	TUint64 keys[8];
+	const TInt numSymmetries = SymmetryKeys(aGrid, aToMove, aPairCheck, keys);
+	TUint64 key = keys[0];
+	TInt s;
+	for (s = 1; s < numSymmetries; s++)
+		{
+		key = Min(key, keys[s]);
+		}
+	aCell = KMaxTInt;
+	for (s = 0; s < numSymmetries; s++)
+		{
+		if (keys[s] == key)
+			{
+			const TPoint cell = Transform(s, size, aMove);
+			aCell = Min(aCell, cell.iY * size.iWidth + cell.iX);
+			}
+		}
+	return key;
+	}
+
+TInt TGomokuBookHash::SymmetryKeys(const CGrid* aGrid, eCellColor aToMove,
+		TBool aPairCheck, TUint64* aKeys)
+	{
+	const TSize size = aGrid->GetSize();
+	const TInt numSymmetries = NumSymmetries(size);
+	// The settings are part of every key, so that a book can contain the
+	// positions of different grid sizes.
+	const TUint64 settings = Mix(((TUint64) size.iWidth << 12)
+			| ((TUint64) size.iHeight << 2) | (aPairCheck ? 2 : 0)
+			| (aToMove == EColor2 ? 1 : 0));
+	TInt s;
+	for (s = 0; s < numSymmetries; s++)
+		{
+		aKeys[s] = settings;
+		}
+	for (TInt y = 0; y < size.iHeight; y++)
+		{
+		for (TInt x = 0; x < size.iWidth; x++)
+			{
+			const eCellColor color = aGrid->GetGridCell(x, y)->GetColor();
+			if (color == EColorNeutral)
+				{
+				continue;
+				}
+			for (s = 0; s < numSymmetries; s++)
+				{
+				const TPoint cell = Transform(s, size, TPoint(x, y));
+				aKeys[s] ^= Mix(((TUint64) color << 32) | ((TUint64) cell.iY
+						<< 16) | (TUint64) cell.iX);
+				}
+			}
+		}
+	return numSymmetries;
+	}
+
+TInt TGomokuBookHash::NumSymmetries(TSize aGridSize)
+	{
+	// Swapping the rows and the columns only works for a square grid.
+	return (aGridSize.iWidth == aGridSize.iHeight) ? 8 : 4;
+	}
+
+TPoint TGomokuBookHash::Transform(TInt aSymmetry, TSize aGridSize,
+		TPoint aCell)
+	{
+	// Bit 2: swap rows and columns, bit 0: mirror horizontally,
+	// bit 1: mirror vertically.
+	if (aSymmetry & 4)
+		{
+		const TInt x = aCell.iX;
+		aCell.iX = aCell.iY;
+		aCell.iY = x;
+		}
+	if (aSymmetry & 1)
+		{
+		aCell.iX = aGridSize.iWidth - 1 - aCell.iX;
+		}
+	if (aSymmetry & 2)
+		{
+		aCell.iY = aGridSize.iHeight - 1 - aCell.iY;
+		}
+	return aCell;
+	}
+
+TPoint TGomokuBookHash::InverseTransform(TInt aSymmetry, TSize aGridSize,
+		TPoint aCell)
+	{
+	if (aSymmetry & 1)
+		{
+		aCell.iX = aGridSize.iWidth - 1 - aCell.iX;
+		}
+	if (aSymmetry & 2)
+		{
+		aCell.iY = aGridSize.iHeight - 1 - aCell.iY;
+		}
+	if (aSymmetry & 4)
+		{
+		const TInt x = aCell.iX;
+		aCell.iX = aCell.iY;
+		aCell.iY = x;
+		}
+	return aCell;
+	}
+
+TInt TGomokuBookHash::CountStones(const CGrid* aGrid)
+	{
+	TInt stones = 0;
+	for (TInt y = 0; y < aGrid->GetRows(); y++)
+		{
+		for (TInt x = 0; x < aGrid->GetCols(); x++)
+			{
+			if (!aGrid->GetGridCell(x, y)->IsFree())
+				{
+				stones++;
+				}
+			}
+		}
+	return stones;
+	}
+
+TUint64 TGomokuBookHash::Mix(TUint64 aValue)
+	{
+	// Finalizer of SplitMix64: every input bit changes about half of the
+	// output bits.
+	aValue += UI64LIT(0x9E3779B97F4A7C15);
+	aValue = (aValue ^ (aValue >> 30)) * UI64LIT(0xBF58476D1CE4E5B9);
+	aValue = (aValue ^ (aValue >> 27)) * UI64LIT(0x94D049BB133111EB);
+	return aValue ^ (aValue >> 31);
+	}
+
+// ---------------------------------------------------------------------------
+// CGomokuOpeningBook
+// ---------------------------------------------------------------------------
+
+CGomokuOpeningBook::CGomokuOpeningBook()
+	{
+	// No implementation required
+	}
+
+CGomokuOpeningBook::~CGomokuOpeningBook()
+	{
+	Close();
+	iFs.Close();
+	}
+
+CGomokuOpeningBook* CGomokuOpeningBook::NewL()
+	{
+	CGomokuOpeningBook* self = new (ELeave) CGomokuOpeningBook();
+	CleanupStack::PushL(self);
+	self->ConstructL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuOpeningBook::ConstructL()
+	{
+	User::LeaveIfError(iFs.Connect());
+	}
+
+TInt CGomokuOpeningBook::Open(const TDesC& aFileName)
+	{
+	Close();
+
+	TFileName fileName;
+	TInt err = GetFileName(iFs, aFileName, fileName);
+	if (err != KErrNone)
+		{
+		return err;
+		}
+	err = iFile.Open(iFs, fileName, EFileRead | EFileShareReadersOnly);
+	if (err != KErrNone)
+		{
+		return (err == KErrPathNotFound) ? KErrNotFound : err;
+		}
+	iIsOpen = ETrue;
+
+	TBuf8<KBookHeaderSize> header;
+	TInt size = 0;
+	err = iFile.Read(0, header, KBookHeaderSize);
+	if (err == KErrNone)
+		{
+		err = iFile.Size(size);
+		}
+	if (err == KErrNone && header.Length() == KBookHeaderSize)
+		{
+		const TUint8* ptr = header.Ptr();
+		iNumPositions = (TInt) Get32(ptr + 8);
+		iNumMoves = (TInt) Get32(ptr + 12);
+		if (Get32(ptr) != KBookMagic || Get32(ptr + 4) != KBookVersion
+				|| iNumPositions < 0 || iNumMoves < 0 || size
+				!= KBookHeaderSize + iNumPositions * KBookPositionSize
+						+ iNumMoves * KBookMoveSize)
+			{
+			err = KErrCorrupt;
+			}
+		}
+	else if (err == KErrNone)
+		{
+		err = KErrCorrupt;
+		}
+	if (err != KErrNone)
+		{
+		Close();
+		}
+	return err;
+	}
+
+void CGomokuOpeningBook::Close()
+	{
+	if (iIsOpen)
+		{
+		iFile.Close();
+		iIsOpen = EFalse;
+		}
+	iNumPositions = 0;
+	iNumMoves = 0;
+	}
+
+TBool CGomokuOpeningBook::IsOpen() const
+	{
+	return iIsOpen;
+	}
+
+void CGomokuOpeningBook::SetPairCheck(TBool aPairCheck)
+	{
+	iPairCheck = aPairCheck;
+	}
+
+TInt CGomokuOpeningBook::FindMoves(const CGrid* aGrid, eCellColor aToMove,
+		TGomokuBookMove* aMoves, TInt aMaxMoves)
+	{
+	if (!iIsOpen || TGomokuBookHash::CountStones(aGrid) > KBookMaxStones)
+		{
+		return 0;
+		}
+	TInt symmetry;
+	const TUint64 key = TGomokuBookHash::CanonicalKey(aGrid, aToMove,
+			iPairCheck, symmetry);
+	TInt firstMove;
+	TInt numMoves = Min(FindPosition(key, firstMove), Min(aMaxMoves,
+			KBookMaxMoves));
+	if (numMoves == 0)
+		{
+		return 0;
+		}
+
+	TBuf8<KBookMaxMoves * KBookMoveSize> moves;
+	if (iFile.Read(KBookHeaderSize + iNumPositions * KBookPositionSize
+			+ firstMove * KBookMoveSize, moves, numMoves * KBookMoveSize)
+			!= KErrNone || moves.Length() != numMoves * KBookMoveSize)
+		{
+		return 0;
+		}
+	const TSize size = aGrid->GetSize();
+	TInt found = 0;
+	for (TInt i = 0; i < numMoves; i++)
+		{
+		const TUint8* ptr = moves.Ptr() + i * KBookMoveSize;
+		const TUint32 cellAndWeight = Get32(ptr);
+		const TInt cell = (TInt) (cellAndWeight & 0xFFFF);
+		const TPoint move = TGomokuBookHash::InverseTransform(symmetry, size,
+				TPoint(cell % size.iWidth, cell / size.iWidth));
+		// Two different positions might have the same key - only use moves
+		// that are possible.
+		if (cell >= size.iWidth * size.iHeight || !aGrid->GetGridCell(
+				move.iX, move.iY)->IsFree())
+			{
+			continue;
+			}
+		aMoves[found].iMove = move;
+		aMoves[found].iWeight = (TInt) (cellAndWeight >> 16);
+		aMoves[found].iGames = (TInt) Get32(ptr + 4);
+		aMoves[found].iWins = (TInt) Get32(ptr + 8);
+		aMoves[found].iDraws = (TInt) Get32(ptr + 12);
+		found++;
+		}
+	return found;
+	}
+
+TBool CGomokuOpeningBook::ChooseMove(const CGrid* aGrid, eCellColor aToMove,
+		TGomokuRandom& aRandom, TPoint& aMove)
+	{
+	TGomokuBookMove moves[KBookMaxMoves];
+	const TInt numFound = FindMoves(aGrid, aToMove, moves, KBookMaxMoves);
+	TInt numMoves = 0;
+	TInt bestWeight = 0;
+	TInt i;
+	for (i = 0; i < numFound; i++)
+		{
+		if (moves[i].iGames >= KBookMinPlayGames && moves[i].iWeight
+				>= KBookMinPlayWeight)
+			{
+			moves[numMoves++] = moves[i];
+			bestWeight = Max(bestWeight, moves[i].iWeight);
+			}
+		}
+	if (bestWeight == 0)
+		{
+		return EFalse;
+		}
+
+	// Only choose between the good moves.
+	TInt totalWeight = 0;
+	for (i = 0; i < numMoves; i++)
+		{
+		if (moves[i].iWeight * 2 >= bestWeight)
+			{
+			totalWeight += moves[i].iWeight;
+			}
+		}
+	TInt choice = aRandom.Next(totalWeight);
+	for (i = 0; i < numMoves; i++)
+		{
+		if (moves[i].iWeight * 2 >= bestWeight)
+			{
+			choice -= moves[i].iWeight;
+			if (choice < 0)
+				{
+				aMove = moves[i].iMove;
+				return ETrue;
+				}
+			}
+		}
+	return EFalse;
+	}
+
+TInt CGomokuOpeningBook::GetFileName(RFs& aFs, const TDesC& aFileName,
+		TFileName& aFullName)
+	{
+	// The book is installed with the application, on the drive of this DLL.
+	TInt err = aFs.PrivatePath(aFullName);
+	if (err != KErrNone)
+		{
+		return err;
+		}
+	TFileName dllName;
+	Dll::FileName(dllName);
+	aFullName.Insert(0, dllName.Left(2));
+	aFullName.Append(aFileName);
+	return KErrNone;
+	}
+
+TInt CGomokuOpeningBook::FindPosition(TUint64 aKey, TInt& aFirstMove)
+	{
+	TBuf8<KBookPositionSize> position;
+	TInt low = 0;
+	TInt high = iNumPositions - 1;
+	while (low <= high)
+		{
+		const TInt middle = (low + high) / 2;
+		if (iFile.Read(KBookHeaderSize + middle * KBookPositionSize, position,
+				KBookPositionSize) != KErrNone || position.Length()
+				!= KBookPositionSize)
+			{
+			return 0;
+			}
+		const TUint8* ptr = position.Ptr();
+		const TUint64 key = ((TUint64) Get32(ptr) << 32) | Get32(ptr + 4);
+		if (key < aKey)
+			{
+			low = middle + 1;
+			}
+		else if (key > aKey)
+			{
+			high = middle - 1;
+			}
+		else
+			{
+			aFirstMove = (TInt) Get32(ptr + 8);
+			const TInt numMoves = (TInt) Get32(ptr + 12);
+			if (aFirstMove < 0 || numMoves < 0 || aFirstMove + numMoves
+					> iNumMoves)
+				{
+				return 0;
+				}
+			return numMoves;
+			}
+		}
+	return 0;
+	}
@@ -0,0 +1,372 @@
+/*
+ ============================================================================
+ Name		 : GomokuOpeningBook.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Opening book: known good moves for the first positions of
+               a game, stored in a sorted binary file.
+ ============================================================================
+ */
+
+#ifndef GOMOKUOPENINGBOOK_H_
+#define GOMOKUOPENINGBOOK_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <f32file.h>
+#include "Grid.h"
+#include "GomokuRandom.h"
+
+/**
+ * Name of the opening book in the private directory of the application.
+ */
+_LIT(KBookFileName, "OpeningBook.dat");
+
+/**
+ * First word of an opening book file ("GBK1").
+ */
+const TUint32 KBookMagic = 0x314B4247;
+
+/**
+ * Version of the file format.
+ */
+const TUint32 KBookVersion = 1;
+
+/**
+ * Size of the file header in bytes: magic, version, number of positions,
+ * number of moves.
+ */
+const TInt KBookHeaderSize = 16;
+
+/**
+ * Size of a position in the file in bytes: key (2 words), index of the
+ * first move, number of moves.
+ */
+const TInt KBookPositionSize = 16;
+
+/**
+ * Size of a move in the file in bytes: cell and weight (16 bits each),
+ * games, wins and draws.
+ */
+const TInt KBookMoveSize = 16;
+
+/**
+ * Only positions with at most this number of stones are stored in the book.
+ */
+const TInt KBookMaxStones = 12;
+
+/**
+ * Maximum number of moves that are read for a position.
+ */
+const TInt KBookMaxMoves = 16;
+
+/**
+ * Maximum weight of a move.
+ */
+const TInt KBookMaxWeight = 0xFFFF;
+
+/**
+ * A move is only played from the book if it was played in at least this
+ * number of games ...
+ */
+const TInt KBookMinPlayGames = 2;
+
+/**
+ * ... and scored at least half of the points. Other moves are left to the
+ * search, so that a learned book doesn't repeat lost games.
+ */
+const TInt KBookMinPlayWeight = KBookMaxWeight / 2;
+
+// CLASS DECLARATION
+
+/**
+ * A move of the opening book with its statistics.
+ */
+class TGomokuBookMove
+	{
+public:
+	/**
+	 * The move.
+	 */
+	TPoint iMove;
+
+	/**
+	 * Weight for choosing the move, up to KBookMaxWeight.
+	 */
+	TInt iWeight;
+
+	/**
+	 * Number of games in which the move was played.
+	 */
+	TInt iGames;
+
+	/**
+	 * Number of these games that the player of the move won.
+	 */
+	TInt iWins;
+
+	/**
+	 * Number of these games that ended in a draw.
+	 */
+	TInt iDraws;
+	};
+
+/**
+ * Keys of the positions of the opening book.
+ *
+ * The key is a Zobrist hash of the stones, the player to move, the size of
+ * the grid and the pair check setting. The board looks the same after
+ * mirroring or rotating it, therefore the key is calculated for all
+ * symmetries of the grid (8 for a square grid, 4 otherwise) and the
+ * smallest one is used. The book stores the moves in the coordinates of
+ * this canonical symmetry.
+ *
+ * The random numbers of the hash are calculated from the cell and the color
+ * instead of being stored in a table, so that the keys are the same for
+ * every grid size and on every device.
+ */
+class TGomokuBookHash
+	{
+public:
+	/**
+	 * Canonical key of a position.
+	 *
+	 * \param aGrid the position.
+	 * \param aToMove color of the player to move.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aSymmetry receives the symmetry that transforms the grid to
+	 * the canonical position.
+	 */
+	static TUint64 CanonicalKey(const CGrid* aGrid, eCellColor aToMove,
+			TBool aPairCheck, TInt& aSymmetry);
+
+	/**
+	 * Canonical key of a position and cell of a move in the canonical
+	 * position, as stored in the book.
+	 *
+	 * \param aGrid the position.
+	 * \param aToMove color of the player to move.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aMove the move.
+	 * \param aCell receives the cell of the move (y * columns + x).
+	 */
+	static TUint64 CanonicalMove(const CGrid* aGrid, eCellColor aToMove,
+			TBool aPairCheck, TPoint aMove, TInt& aCell);
+
+	/**
+	 * Keys of a position in all symmetries of the grid.
+	 *
+	 * \param aKeys receives the keys, must have room for 8 keys.
+	 * \return number of symmetries.
+	 */
+	static TInt SymmetryKeys(const CGrid* aGrid, eCellColor aToMove,
+			TBool aPairCheck, TUint64* aKeys);
+
+	/**
+	 * Number of symmetries of a grid of this size.
+	 */
+	static TInt NumSymmetries(TSize aGridSize);
+
+	/**
+	 * Transform a cell to the canonical position.
+	 */
+	static TPoint Transform(TInt aSymmetry, TSize aGridSize, TPoint aCell);
+
+	/**
+	 * Transform a cell of the canonical position back to the grid.
+	 */
+	static TPoint InverseTransform(TInt aSymmetry, TSize aGridSize,
+			TPoint aCell);
+
+	/**
+	 * Number of stones on the grid.
+	 */
+	static TInt CountStones(const CGrid* aGrid);
+
+private:
+	/**
+	 * Random number for the key, calculated from the input.
+	 */
+	static TUint64 Mix(TUint64 aValue);
+	};
+
+/**
+ * Reads moves for the first positions of a game from an opening book file.
+ *
+ * The board is mostly empty at the start of a game, every cell is
+ * a candidate and the ratings hardly differ. The book provides good moves
+ * for these positions without any search.
+ *
+ * File format (all numbers are 32 bit little endian):
+ * - header: KBookMagic, KBookVersion, number of positions, number of moves.
+ * - positions, sorted by key: key (high word, low word), index of the first
+ *   move, number of moves.
+ * - moves of all positions: cell (y * columns + x, in the canonical position)
+ *   in the lower and weight in the upper 16 bits, games, wins, draws.
+ *
+ * The file is not loaded into memory. A lookup is a binary search on the
+ * positions with a few short reads from the file, which only happens for
+ * the first moves of a game. Books are created by CGomokuBookBuilder.
+ */
+class CGomokuOpeningBook : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuOpeningBook();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuOpeningBook* NewL();
+
+public:
+	/**
+	 * Open a book file in the private directory of the application.
+	 * A previously opened book is closed.
+	 *
+	 * \param aFileName name of the file.
+	 * \return KErrNone, KErrNotFound if there is no book or KErrCorrupt if
+	 * the file is not a valid book.
+	 */
+	TInt Open(const TDesC& aFileName);
+
+	/**
+	 * Close the book file.
+	 */
+	void Close();
+
+	/**
+	 * \return ETrue if a book is open.
+	 */
+	TBool IsOpen() const;
+
+	/**
+	 * Set the pair check setting of the games, which is part of the key.
+	 */
+	void SetPairCheck(TBool aPairCheck);
+
+	/**
+	 * Get the moves of the book for the position.
+	 *
+	 * \param aGrid the position.
+	 * \param aToMove color of the player to move.
+	 * \param aMoves receives the moves, in the coordinates of the grid.
+	 * \param aMaxMoves maximum number of moves to store in aMoves.
+	 * \return number of moves, 0 if the position is not in the book.
+	 */
+	TInt FindMoves(const CGrid* aGrid, eCellColor aToMove,
+			TGomokuBookMove* aMoves, TInt aMaxMoves);
+
+	/**
+	 * Choose a move of the book for the position. The moves are chosen
+	 * randomly according to their weight, moves with less than half the
+	 * weight of the best move are never played, neither are moves below
+	 * KBookMinPlayGames and KBookMinPlayWeight.
+	 *
+	 * \param aGrid the position.
+	 * \param aToMove color of the player to move.
+	 * \param aRandom random number generator.
+	 * \param aMove receives the move.
+	 * \return ETrue if the book has a move for the position.
+	 */
+	TBool ChooseMove(const CGrid* aGrid, eCellColor aToMove,
+			TGomokuRandom& aRandom, TPoint& aMove);
+
+	/**
+	 * Complete name of a file in the private directory of the application,
+	 * on the drive of this DLL.
+	 *
+	 * \param aFs session with the file server.
+	 * \param aFileName name of the file.
+	 * \param aFullName receives the complete name.
+	 */
+	static TInt GetFileName(RFs& aFs, const TDesC& aFileName,
+			TFileName& aFullName);
+
+	/**
+	 * Read a 32 bit little endian number.
+	 */
+	static inline TUint32 Get32(const TUint8* aPtr);
+
+	/**
+	 * Write a 32 bit little endian number.
+	 */
+	static inline void Put32(TUint8* aPtr, TUint32 aValue);
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuOpeningBook();
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Binary search for the position.
+	 *
+	 * \param aKey key of the position.
+	 * \param aFirstMove receives the index of the first move.
+	 * \return number of moves, 0 if the position is not in the book.
+	 */
+	TInt FindPosition(TUint64 aKey, TInt& aFirstMove);
+
+private:
+	/**
+	 * Session with the file server.
+	 */
+	RFs iFs;
+
+	/**
+	 * The book file.
+	 */
+	RFile iFile;
+
+	/**
+	 * ETrue if iFile is open.
+	 */
+	TBool iIsOpen;
+
+	/**
+	 * Number of positions in the book.
+	 */
+	TInt iNumPositions;
+
+	/**
+	 * Number of moves in the book.
+	 */
+	TInt iNumMoves;
+
+	/**
+	 * Pair check setting of the current game.
+	 */
+	TBool iPairCheck;
+	};
+
+inline TUint32 CGomokuOpeningBook::Get32(const TUint8* aPtr)
+	{
+	return (TUint32) aPtr[0] | ((TUint32) aPtr[1] << 8) | ((TUint32) aPtr[2]
+			<< 16) | ((TUint32) aPtr[3] << 24);
+	}
+
+inline void CGomokuOpeningBook::Put32(TUint8* aPtr, TUint32 aValue)
+	{
+	aPtr[0] = (TUint8) aValue;
+	aPtr[1] = (TUint8) (aValue >> 8);
+	aPtr[2] = (TUint8) (aValue >> 16);
+	aPtr[3] = (TUint8) (aValue >> 24);
+	}
+
+#endif /*GOMOKUOPENINGBOOK_H_*/
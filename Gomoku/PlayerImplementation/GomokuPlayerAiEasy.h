@@ -0,0 +1,49 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiEasy.h
+ Copyright   : Andreas Jakl, 2007-2009
+ 
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+ 
+ Description : Beginner level of the reference AI. It only rates the 3 most
+               promising cells for each move.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPLAYERAIEASY_H_
+#define GOMOKUPLAYERAIEASY_H_
+
+// INCLUDES
+#include "GomokuPlayerAiSegment.h"
+
+// CLASS DECLARATION
+
+/**
+ * Strength of the easy AI: the personality of the reference AI, but the
+ * search stops after 3 rated cells. As the moves that make or block
+ * threats are rated first, it still answers the threats of the opponent,
+ * but often overlooks the best quiet move. Uses a fraction of the
+ * processor time of the reference AI.
+ */
+class TGomokuEasyPolicy
+	{
+public:
+	enum
+		{
+		EMyWeight = 1,
+		EEnemyWeight = 1,
+		ETieBreakOdds = 5,
+		ENodeBudget = 3,
+		EQuiescenceDepth = 0
+		};
+	};
+
+/**
+ * Easy AI, see CGomokuPlayerAiSegment.
+ */
+typedef CGomokuPlayerAiSegmentT<TGomokuEasyPolicy> CGomokuPlayerAiEasy;
+
+#endif /*GOMOKUPLAYERAIEASY_H_*/
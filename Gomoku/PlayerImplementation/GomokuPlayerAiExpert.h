@@ -0,0 +1,47 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiExpert.h
+ Copyright   : Andreas Jakl, 2007-2009
+ 
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+ 
+ Description : Strongest level of the reference AI. It rates every cell after
+               the forcing moves that follow it.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPLAYERAIEXPERT_H_
+#define GOMOKUPLAYERAIEXPERT_H_
+
+// INCLUDES
+#include "GomokuPlayerAiSegment.h"
+
+// CLASS DECLARATION
+
+/**
+ * Strength of the expert AI: the personality of the reference AI, but every
+ * cell is rated after the forcing moves that follow it, see
+ * CGomokuQuiescence. Needs a lot more processor time than the reference AI.
+ */
+class TGomokuExpertPolicy
+	{
+public:
+	enum
+		{
+		EMyWeight = 1,
+		EEnemyWeight = 1,
+		ETieBreakOdds = 5,
+		ENodeBudget = KNodesUnlimited,
+		EQuiescenceDepth = KQuiescenceDefaultDepth
+		};
+	};
+
+/**
+ * Expert AI, see CGomokuPlayerAiSegment.
+ */
+typedef CGomokuPlayerAiSegmentT<TGomokuExpertPolicy> CGomokuPlayerAiExpert;
+
+#endif /*GOMOKUPLAYERAIEXPERT_H_*/
@@ -0,0 +1,297 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiMcts.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuPlayerAiMcts implementation
+ ============================================================================
+ */
+
+#include "GomokuPlayerAiMcts.h"
+
+CGomokuPlayerAiMcts::CGomokuPlayerAiMcts() :
+	iCurrentPlayer(EColor1), iPlayoutBudget(KMctsDefaultPlayouts),
+			iPonderEnabled(ETrue)
+	{
+	iTimeManager.SetLimits(KMctsDefaultTimeMs);
+	}
+
+CGomokuPlayerAiMcts::~CGomokuPlayerAiMcts()
+	{
+	if (iIdleAO)
+		{
+		iIdleAO->Cancel();
+		delete iIdleAO;
+		}
+	delete iSearch;
+	delete iThreatSolver;
+	delete iOpeningBook;
+	delete iBookLearner;
+	}
+
+CGomokuPlayerAiMcts* CGomokuPlayerAiMcts::NewL()
+	{
+	CGomokuPlayerAiMcts* self = new (ELeave) CGomokuPlayerAiMcts();
+	CleanupStack::PushL(self);
+	self->ConstructL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuPlayerAiMcts::ConstructL()
+	{
+	iSearch = CGomokuMctsSearch::NewL();
+	iThreatSolver = CGomokuThreatSolver::NewL();
+	iOpeningBook = CGomokuOpeningBook::NewL();
+	iBookLearner = CGomokuBookLearner::NewL();
+	}
+
+void CGomokuPlayerAiMcts::HandleSelectedCellL(TInt /*aCol*/, TInt /*aRow*/)
+	{
+	// The AI does not need to consider user inputs
+	}
+
+void CGomokuPlayerAiMcts::InitL(CGrid* aGrid, eCellColor aYourColor,
+		TBool aPairCheck, TInt aNumPairsWin)
+	{
+	StopPondering();
+	iGrid = aGrid;
+	iCurrentPlayer = aYourColor;
+	iCapturedPairs = 0;
+	iOpponentCapturedPairs = 0;
+	iSearch->InitL(iGrid->GetSize(), aPairCheck, aNumPairsWin);
+	iThreatSolver->InitL(iGrid->GetSize(), aPairCheck, aNumPairsWin);
+	// Without a book file, all moves are searched.
+	iOpeningBook->SetPairCheck(aPairCheck);
+	iOpeningBook->Open(KBookFileName);
+	iBookLearner->StartGame(aPairCheck);
+	}
+
+void CGomokuPlayerAiMcts::SetBudget(TInt aPlayouts, TInt aTimeMs)
+	{
+	iPlayoutBudget = aPlayouts;
+	iTimeManager.SetLimits(aTimeMs);
+	}
+
+void CGomokuPlayerAiMcts::SetTimeLimits(TInt aMoveTimeMs, TInt aClockMs)
+	{
+	iTimeManager.SetLimits(aMoveTimeMs, aClockMs);
+	}
+
+void CGomokuPlayerAiMcts::SetThreads(TInt aThreads)
+	{
+	iSearch->SetThreads(aThreads);
+	}
+
+void CGomokuPlayerAiMcts::SetReportStatistics(TBool aReport)
+	{
+	iReportStatistics = aReport;
+	}
+
+TBool CGomokuPlayerAiMcts::GetStatistics(
+		TGomokuSearchStatistics& aStatistics) const
+	{
+	aStatistics = iStatistics;
+	// No statistics before the first move.
+	return (iStatistics.iPvLength > 0);
+	}
+
+void CGomokuPlayerAiMcts::SetCapturedPairs(TInt aYourPairs,
+		TInt aOpponentPairs)
+	{
+	iCapturedPairs = aYourPairs;
+	iOpponentCapturedPairs = aOpponentPairs;
+	}
+
+void CGomokuPlayerAiMcts::SetRandomSeed(TUint64 aSeed)
+	{
+	iRandom.SetSeed(aSeed);
+	}
+
+void CGomokuPlayerAiMcts::SetPondering(TBool aPondering)
+	{
+	iPonderEnabled = aPondering;
+	if (!iPonderEnabled)
+		{
+		StopPondering();
+		}
+	}
+
+void CGomokuPlayerAiMcts::StartTurn()
+	{
+	StopPondering();
+	iIsActive = ETrue;
+	iTimeManager.StartMove();
+	iStatistics.Reset();
+	TPoint winningMove;
+	if (iThreatSolver->FindWin(iGrid, iCurrentPlayer, winningMove,
+			iCapturedPairs, iOpponentCapturedPairs))
+		{
+		// No need to search, a sequence of fours wins.
+		iIsActive = EFalse;
+		iTimeManager.FinishMove();
+		iStatistics.iTimeMs = iTimeManager.ElapsedMs();
+		iStatistics.AddPvMove(winningMove);
+		iBookLearner->AddMove(iGrid, iCurrentPlayer, winningMove);
+		iObserver->HandleFinishedTurn(winningMove.iX, winningMove.iY);
+		return;
+		}
+	TPoint bookMove;
+	if (iOpeningBook->ChooseMove(iGrid, iCurrentPlayer, iRandom, bookMove))
+		{
+		iIsActive = EFalse;
+		iTimeManager.FinishMove();
+		iStatistics.iTimeMs = iTimeManager.ElapsedMs();
+		iStatistics.AddPvMove(bookMove);
+		iBookLearner->AddMove(iGrid, iCurrentPlayer, bookMove);
+		iObserver->HandleFinishedTurn(bookMove.iX, bookMove.iY);
+		return;
+		}
+	if (!(iIdleAO))
+		{
+		TRAPD(err, iIdleAO = CIdle::NewL(CActive::EPriorityIdle));
+		}
+	if (!iSearch->ReuseSearch(iGrid, iCurrentPlayer))
+		{
+		iSearch->StartSearch(iGrid, iCurrentPlayer, iRandom.NextSeed());
+		}
+	if (iIdleAO)
+		{
+		iIdleAO->Start(TCallBack(BackgroundCalcMove, this));
+		}
+	}
+
+void CGomokuPlayerAiMcts::GameOver(eCellColor aWinnerColor)
+	{
+	StopPondering();
+	// The book is not needed until the next game and can't be updated
+	// while it is open.
+	iOpeningBook->Close();
+	// Learning is optional - the game continues if the book can't be written.
+	TRAP_IGNORE(iBookLearner->GameOverL(aWinnerColor));
+	}
+
+void CGomokuPlayerAiMcts::CancelTurn()
+	{
+	StopPondering();
+	if (iIsActive)
+		{
+		if (iIdleAO)
+			{
+			iIdleAO->Cancel();
+			}
+		// Waits until the worker threads have finished their iteration.
+		iSearch->StopSearch();
+		iIsActive = EFalse;
+		}
+	}
+
+TInt CGomokuPlayerAiMcts::BackgroundCalcMove(TAny* aAi)
+	{
+	return ((CGomokuPlayerAiMcts*) aAi)->DoBackgroundCalcMove();
+	}
+
+TInt CGomokuPlayerAiMcts::DoBackgroundCalcMove()
+	{
+	if (iPondering)
+		{
+		return DoBackgroundPonder();
+		}
+	iTimeManager.StartSlice();
+	TBool finished = EFalse;
+	FOREVER
+		{
+		// The playouts of a reused tree count as well.
+		finished = iSearch->RunIterations(KMctsIterationsPerPoll)
+				|| iSearch->RootVisits() >= iPlayoutBudget;
+		if (finished || iTimeManager.Poll())
+			{
+			// After the soft limit, only continue while the search is
+			// still undecided between two moves.
+			finished = finished || iTimeManager.HardLimitReached()
+					|| (iTimeManager.SoftLimitReached()
+							&& iSearch->BestMoveIsStable());
+			break;
+			}
+		}
+	if (!finished)
+		{
+		// Continue searching
+		return ETrue;
+		}
+
+	// The worker threads must not change the tree while it is evaluated.
+	iSearch->StopSearch();
+	iStatistics.iNodes = iSearch->Playouts();
+	iStatistics.iDepth = iSearch->PrincipalVariation(iStatistics);
+	if (iReportStatistics)
+		{
+		ReportStatistics(iTimeManager.ElapsedMs());
+		}
+
+	iIsActive = EFalse;
+	iTimeManager.FinishMove();
+	iStatistics.iTimeMs = iTimeManager.ElapsedMs();
+	const TPoint move = iSearch->BestMove();
+	iBookLearner->AddMove(iGrid, iCurrentPlayer, move);
+	iObserver->HandleFinishedTurn(move.iX, move.iY);
+
+	// Keep searching while the opponent thinks about the reply.
+	if (iPonderEnabled && iSearch->AdvanceRoot(move))
+		{
+		iPondering = ETrue;
+		iSearch->ResumeSearch();
+		return ETrue;
+		}
+	return EFalse;
+	}
+
+TInt CGomokuPlayerAiMcts::DoBackgroundPonder()
+	{
+	iTimeManager.StartSlice();
+	do
+		{
+		iSearch->RunIterations(KMctsIterationsPerPoll);
+		}
+	while (!iTimeManager.Poll());
+
+	if (iSearch->TreeFull() || iSearch->RootVisits() / KMctsPonderBudgetFactor
+			>= iPlayoutBudget)
+		{
+		// Enough for the next move, don't waste the battery.
+		StopPondering();
+		return EFalse;
+		}
+	return ETrue;
+	}
+
+void CGomokuPlayerAiMcts::StopPondering()
+	{
+	if (iPondering)
+		{
+		iPondering = EFalse;
+		if (iIdleAO)
+			{
+			iIdleAO->Cancel();
+			}
+		iSearch->StopSearch();
+		}
+	}
+
+void CGomokuPlayerAiMcts::ReportStatistics(TInt aElapsedMs) const
+	{
+	const TInt elapsedMs = Max(aElapsedMs, 1);
+	for (TInt i = 0; i < iSearch->ThreadCount(); i++)
+		{
+		const TInt playouts = iSearch->ThreadPlayouts(i);
+		RDebug::Print(_L("MCTS thread %d: %d playouts, %d per second"), i,
+				playouts, (TInt) ((TInt64) playouts * 1000 / elapsedMs));
+		}
+	RDebug::Print(_L("MCTS total: %d playouts in %d ms, %d nodes"),
+			iSearch->Playouts(), elapsedMs, iSearch->NodesUsed());
+	}
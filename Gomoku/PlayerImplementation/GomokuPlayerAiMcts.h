@@ -0,0 +1,337 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiMcts.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Artificial intelligence based on Monte-Carlo tree search.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPLAYERAIMCTS_H_
+#define GOMOKUPLAYERAIMCTS_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <e32debug.h>
+#include "GomokuPlayerInterface.h"
+#include "GomokuMctsSearch.h"
+#include "GomokuThreatSolver.h"
+#include "GomokuOpeningBook.h"
+#include "GomokuBookLearner.h"
+#include "GomokuTimeManager.h"
+#include "GomokuRandom.h"
+
+/**
+ * Default maximum number of playouts per move.
+ */
+const TInt KMctsDefaultPlayouts = 20000;
+
+/**
+ * Default deadline per move in milliseconds.
+ */
+const TInt KMctsDefaultTimeMs = 5000;
+
+/**
+ * Number of iterations between two checks of the time manager.
+ */
+const TInt KMctsIterationsPerPoll = 10;
+
+/**
+ * Pondering stops after this many times the playout budget, even if the
+ * tree could still grow.
+ */
+const TInt KMctsPonderBudgetFactor = 4;
+
+// CLASS DECLARATION
+
+/**
+ * AI player that uses Monte-Carlo tree search (see CGomokuMctsSearch).
+ *
+ * Instead of rating patterns on the board, this player plays lots of random
+ * games and chooses the move that leads to the best results. It therefore
+ * behaves very differently from the segment based AIs (Reference, Defensive,
+ * Aggressive) and is a good second opponent to compare them to.
+ *
+ * The search runs in slices of a CIdle active object, until either the
+ * maximum number of playouts or the time limit is reached. At the soft
+ * limit of the time manager, the search stops if the most visited move is
+ * also the one with the best results, otherwise it continues until the
+ * hard limit.
+ * Additional worker threads can search the same tree meanwhile
+ * (see SetThreads()).
+ *
+ * Pondering: after the move has been sent to the game engine, the search
+ * continues on the opponent's turn with the position after the own move,
+ * i.e. all replies of the opponent are searched. When the next turn starts,
+ * the subtree of the opponent's actual move is kept, so the time the
+ * opponent needs for the move is not wasted.
+ */
+class CGomokuPlayerAiMcts : public CGomokuPlayerInterface
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuPlayerAiMcts();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuPlayerAiMcts* NewL();
+
+public:
+	/**
+	 * Initialize the player implementation. This method is called by
+	 * the game engine before the game is started and provides
+	 * the necessary parameters to the implementation.
+	 *
+	 * \param aGrid a reference of the grid that will be valid for the
+	 * whole game. The implementation should save a pointer to this
+	 * grid to be able to read the current grid state during the game.
+	 * \param aYourColor the color this implementation is assigned with for
+	 * this game.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 */
+	void InitL(CGrid* aGrid, eCellColor aYourColor, TBool aPairCheck, TInt aNumPairsWin);
+
+	/**
+	 * Called when the turn of this player is started. Starts the search
+	 * in the background, the move is sent to the observer when the
+	 * budget is used up.
+	 */
+	void StartTurn();
+
+	/**
+	 * The AI does not need to consider user inputs.
+	 */
+	void HandleSelectedCellL(TInt aCol, TInt aRow);
+
+	/**
+	 * This method is called by the game engine when the game is over,
+	 * the parameter provides the color of the winning player. The AI adds
+	 * the result to the opening book.
+	 *
+	 * \param aWinnerColor color of the winning player.
+	 */
+	void GameOver(eCellColor aWinnerColor);
+
+	/**
+	 * Stop the search of the current turn, including the worker threads.
+	 * The move of the turn is not sent to the observer. The tree is kept,
+	 * like after pondering.
+	 */
+	void CancelTurn();
+
+	/**
+	 * Configure how long the AI may think about a move. The search stops
+	 * as soon as one of the limits is reached.
+	 *
+	 * \param aPlayouts maximum number of playouts per move.
+	 * \param aTimeMs deadline per move in milliseconds.
+	 */
+	void SetBudget(TInt aPlayouts, TInt aTimeMs);
+
+	/**
+	 * Configure the thinking time of the AI.
+	 *
+	 * \param aMoveTimeMs deadline per move in milliseconds,
+	 * KTimeUnlimited for no deadline.
+	 * \param aClockMs remaining time on the game clock of this player in
+	 * milliseconds, KTimeUnlimited if the game is played without a clock.
+	 */
+	void SetTimeLimits(TInt aMoveTimeMs, TInt aClockMs = KTimeUnlimited);
+
+	/**
+	 * Set the number of threads that search the tree, including the
+	 * main thread. Takes effect with the next call to InitL().
+	 *
+	 * \param aThreads number of threads, 1 to KMctsMaxThreads.
+	 */
+	void SetThreads(TInt aThreads);
+
+	/**
+	 * Print the number of playouts and playouts per second of every
+	 * thread to the debug output after each move.
+	 */
+	void SetReportStatistics(TBool aReport);
+
+	/**
+	 * Enable or disable searching on the opponent's turn. Enabled by default.
+	 */
+	void SetPondering(TBool aPondering);
+
+	/**
+	 * Seed the random number generator, so that the moves of the AI can
+	 * be reproduced with the same budget of playouts and one thread. By
+	 * default, it is seeded with TGomokuRandom::DefaultSeed().
+	 */
+	void SetRandomSeed(TUint64 aSeed);
+
+	/**
+	 * Get the statistics of the last move. The nodes are the playouts of
+	 * all threads, the principal variation follows the most visited moves
+	 * of the tree and the depth is the length of this line in the tree.
+	 * The search has no transposition table.
+	 *
+	 * \param aStatistics receives the statistics.
+	 * \return ETrue if the AI has already made a move.
+	 */
+	TBool GetStatistics(TGomokuSearchStatistics& aStatistics) const;
+
+	/**
+	 * Store the pairs captured so far, for recognising wins by capturing
+	 * in the threat search.
+	 */
+	void SetCapturedPairs(TInt aYourPairs, TInt aOpponentPairs);
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuPlayerAiMcts();
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+	/**
+	 * Static callback function for the CIdle active object.
+	 *
+	 * \param aAi pointer to an instance of the implementation.
+	 * \return ETrue if the search isn't finished yet.
+	 */
+	static TInt BackgroundCalcMove(TAny* aAi);
+
+	/**
+	 * Run the search for one time slice, send the move to the observer
+	 * once the budget is used up.
+	 *
+	 * \return ETrue if the search isn't finished yet.
+	 */
+	TInt DoBackgroundCalcMove();
+
+	/**
+	 * Continue the search on the opponent's turn, until the tree can't grow
+	 * any more or KMctsPonderBudgetFactor times the playout budget is used.
+	 *
+	 * \return ETrue if pondering isn't finished yet.
+	 */
+	TInt DoBackgroundPonder();
+
+	/**
+	 * Stop searching on the opponent's turn.
+	 */
+	void StopPondering();
+
+	/**
+	 * Print the playouts of every thread to the debug output.
+	 *
+	 * \param aElapsedMs thinking time of the move in milliseconds.
+	 */
+	void ReportStatistics(TInt aElapsedMs) const;
+
+private:
+	/**
+	 * The active object that runs the search in small steps.
+	 */
+	CIdle* iIdleAO;
+
+	/**
+	 * Pointer to the grid, owned by the game engine.
+	 * This grid always contains the current game state and should not
+	 * be modified by this implementation.
+	 */
+	CGrid* iGrid;
+
+	/**
+	 * The tree search. Owned by this class.
+	 */
+	CGomokuMctsSearch* iSearch;
+
+	/**
+	 * Searches for forced wins through continuous fours, which random
+	 * playouts hardly ever find. Owned by this class.
+	 */
+	CGomokuThreatSolver* iThreatSolver;
+
+	/**
+	 * Moves for the first positions of a game, if the book file exists.
+	 * Owned by this class.
+	 */
+	CGomokuOpeningBook* iOpeningBook;
+
+	/**
+	 * Adds the moves and results of the games to the opening book.
+	 * Owned by this class.
+	 */
+	CGomokuBookLearner* iBookLearner;
+
+	/**
+	 * True if this implementation is currently active.
+	 */
+	TBool iIsActive;
+
+	/**
+	 * Color of this player.
+	 */
+	eCellColor iCurrentPlayer;
+
+	/**
+	 * Pairs captured by this player so far, see SetCapturedPairs().
+	 */
+	TInt iCapturedPairs;
+
+	/**
+	 * Pairs captured by the opponent so far.
+	 */
+	TInt iOpponentCapturedPairs;
+
+	/**
+	 * Maximum number of playouts per move.
+	 */
+	TInt iPlayoutBudget;
+
+	/**
+	 * Thinking time of the current turn.
+	 */
+	TGomokuTimeManager iTimeManager;
+
+	/**
+	 * ETrue if the statistics are printed after each move.
+	 */
+	TBool iReportStatistics;
+
+	/**
+	 * Statistics of the last move, see GetStatistics().
+	 */
+	TGomokuSearchStatistics iStatistics;
+
+	/**
+	 * ETrue if the AI may search on the opponent's turn.
+	 */
+	TBool iPonderEnabled;
+
+	/**
+	 * ETrue while the AI searches on the opponent's turn.
+	 */
+	TBool iPondering;
+
+	/**
+	 * Random number generator, seeded with TGomokuRandom::DefaultSeed()
+	 * when this object is instantiated.
+	 */
+	TGomokuRandom iRandom;
+	};
+
+#endif /*GOMOKUPLAYERAIMCTS_H_*/
@@ -0,0 +1,47 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiMedium.h
+ Copyright   : Andreas Jakl, 2007-2009
+ 
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+ 
+ Description : Intermediate level of the reference AI. It rates the 4 most
+               promising cells for each move.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPLAYERAIMEDIUM_H_
+#define GOMOKUPLAYERAIMEDIUM_H_
+
+// INCLUDES
+#include "GomokuPlayerAiSegment.h"
+
+// CLASS DECLARATION
+
+/**
+ * Strength of the medium AI: the personality of the reference AI, but the
+ * search stops after 4 rated cells. The ordered cells make every rated cell
+ * count, so a few more cells than the easy AI make a clear difference.
+ */
+class TGomokuMediumPolicy
+	{
+public:
+	enum
+		{
+		EMyWeight = 1,
+		EEnemyWeight = 1,
+		ETieBreakOdds = 5,
+		ENodeBudget = 4,
+		EQuiescenceDepth = 0
+		};
+	};
+
+/**
+ * Medium AI, see CGomokuPlayerAiSegment.
+ */
+typedef CGomokuPlayerAiSegmentT<TGomokuMediumPolicy> CGomokuPlayerAiMedium;
+
+#endif /*GOMOKUPLAYERAIMEDIUM_H_*/
@@ -34,10 +34,12 @@ CGomokuPlayerAiRandom* CGomokuPlayerAiRandom::NewL()
 
 void CGomokuPlayerAiRandom::ConstructL()
 	{
-	// Initialize the random number generator with the current time
-	TTime time;
-	time.HomeTime ();
-	iSeed = time.Int64 ();
+	// The random number generator seeds itself with the current time
+	}
+
+void CGomokuPlayerAiRandom::SetRandomSeed(TUint64 aSeed)
+	{
+	iRandom.SetSeed (aSeed);
 	}
 
 
@@ -58,8 +60,8 @@ void CGomokuPlayerAiRandom::StartTurn()
 	// increasingly long time the more cells are already taken...
 	do
 		{
-		computerMoveX = Math::Rand(iSeed) % iGridSize.iWidth;
-		computerMoveY = Math::Rand(iSeed) % iGridSize.iHeight;
+		computerMoveX = iRandom.Next(iGridSize.iWidth);
+		computerMoveY = iRandom.Next(iGridSize.iHeight);
 		foundFreeCell = (iGrid->GetGridCell(computerMoveX, computerMoveY))->IsFree();
 		} while (!foundFreeCell);
 
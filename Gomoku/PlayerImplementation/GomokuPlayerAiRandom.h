@@ -20,8 +20,8 @@
 #include <e32std.h>
 #include <e32base.h>
 #include <e32debug.h>
-#include <e32math.h>
 #include "GomokuPlayerInterface.h"
+#include "GomokuRandom.h"
 
 // CLASS DECLARATION
 
@@ -104,6 +104,13 @@ public:
 	 */
 	void GameOver(eCellColor aWinnerColor);
 
+	/**
+	 * Seed the random number generator, so that the moves of the AI can
+	 * be reproduced. By default, it is seeded with
+	 * TGomokuRandom::DefaultSeed().
+	 */
+	void SetRandomSeed(TUint64 aSeed);
+
 private:
 
 	/**
@@ -151,10 +158,10 @@ private:
 	TSize iGridSize;
 
 	/**
-	 * Seed for the random number generator, initialized when this
-	 * object is instantiated.
+	 * Random number generator, seeded with TGomokuRandom::DefaultSeed()
+	 * when this object is instantiated.
 	 */
-	TInt64 iSeed;
+	TGomokuRandom iRandom;
 	};
 
 #endif // GOMOKUPLAYERAIRANDOM_H
@@ -0,0 +1,1088 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiSegment.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+ 
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+ 
+ Description : CGomokuPlayerAiSegment implementation
+ ============================================================================
+ */
+
+#include "GomokuPlayerAiSegment.h"
+
+CGomokuPlayerAiSegment::CGomokuPlayerAiSegment(TInt aMyWeight,
+		TInt aEnemyWeight, TInt aTieBreakOdds, TInt aNodeBudget,
+		TInt aQuiescenceDepth) :
+	iQuiescenceDepth(aQuiescenceDepth), iNodeBudget(aNodeBudget),
+			iCurrentPlayer(EColor1), iEnemyPlayer(EColor2), iMyWeight(aMyWeight),
+			iEnemyWeight(aEnemyWeight), iTieBreakOdds(aTieBreakOdds)
+	{
+	// No implementation required
+	}
+
+CGomokuPlayerAiSegment::~CGomokuPlayerAiSegment()
+	{
+	// Stop the worker thread before the data of the calculation is deleted.
+	delete iAiThread;
+	if ( iIdleAO)
+		{
+		iIdleAO->Cancel ();
+		delete iIdleAO;
+		}
+	delete iWorkingGrid;
+	delete iThreatSolver;
+	delete iQuiescence;
+	delete iMoveOrdering;
+	delete iOrderBoard;
+	delete iOpeningBook;
+	delete iBookLearner;
+	delete iNnue;
+	DeleteRatingGrid ();
+	}
+
+void CGomokuPlayerAiSegment::ConstructL()
+	{
+	iWorkingGrid = CGrid::NewL ();
+	iThreatSolver = CGomokuThreatSolver::NewL ();
+	iQuiescence = CGomokuQuiescence::NewL ();
+	SetQuiescenceDepth (iQuiescenceDepth);
+	iMoveOrdering = CGomokuMoveOrdering::NewL ();
+	iOrderBoard = CGomokuBoard::NewL ();
+	iOpeningBook = CGomokuOpeningBook::NewL ();
+	iBookLearner = CGomokuBookLearner::NewL ();
+	iNnue = CGomokuNnue::NewL ();
+	}
+
+void CGomokuPlayerAiSegment::HandleSelectedCellL(TInt /*aCol*/, TInt /*aRow*/)
+	{
+	// The AI does not need to consider user inputs
+	}
+
+void CGomokuPlayerAiSegment::InitL(CGrid* aGrid, eCellColor aYourColor,
+		TBool aPairCheck, TInt aNumPairsWin)
+	{
+	// The rating grid is created again, the worker must not use it anymore.
+	if ( iAiThread)
+		{
+		iAiThread->CancelJob ();
+		}
+	iGrid = aGrid;
+	iWorkingGrid->ResizeGridL (iGrid->GetSize ());
+	iGridSize.SetSize (iGrid->GetCols (), iGrid->GetRows ());
+	CreateRatingGridL ();
+	iCurrentPlayer = aYourColor;
+	iEnemyPlayer = (aYourColor == EColor1) ? EColor2 : EColor1;
+	iPairCheck = aPairCheck;
+	iNumPairsWin = aNumPairsWin;
+	iCapturedPairs = 0;
+	iOpponentCapturedPairs = 0;
+	CreateSegmentTable ();
+	iThreatSolver->InitL (iGrid->GetSize (), aPairCheck, aNumPairsWin);
+	iQuiescence->InitL (iGrid->GetSize (), aPairCheck, aNumPairsWin);
+	iMoveOrdering->InitL (iGridSize.iWidth * iGridSize.iHeight, aPairCheck);
+	iOrderBoard->ResizeL (iGridSize);
+	// Without a book file, all moves are calculated.
+	iOpeningBook->SetPairCheck (aPairCheck);
+	iOpeningBook->Open (KBookFileName);
+	iBookLearner->StartGame (aPairCheck);
+	// Without a network file (or for another grid size), the segments
+	// are rated.
+	iNnue->Load (KNnueFileName);
+	iQuiescence->SetNnue (iNnue->Supports (iGridSize) ? iNnue : NULL);
+	}
+
+void CGomokuPlayerAiSegment::StartTurn()
+	{
+	iIsActive = ETrue;
+
+	// If the move is forced (complete five or block five of the enemy) or
+	// the position is in the opening book, answer right away instead of
+	// rating the whole board in the background.
+	if ( iThreatSolver->FindForcedMove (iGrid, iCurrentPlayer, iMove,
+			iCapturedPairs, iOpponentCapturedPairs)
+			|| iOpeningBook->ChooseMove (iGrid, iCurrentPlayer, iRandom, iMove))
+		{
+		iTimeManager.StartMove ();
+		iTimeManager.FinishMove ();
+		iStatistics.Reset ();
+		iStatistics.AddPvMove (iMove);
+		SendMove ();
+		return;
+		}
+
+	// Indicate that we have to process a new turn
+	iProcessingActive = EFalse;
+
+	// Calculate the AI move in the worker thread, so that the UI thread
+	// stays responsive and the AI can use all the remaining processor time.
+	if ( !iAiThread && !iIdleAO)
+		{
+		TRAP_IGNORE(iAiThread = CGomokuAiThread::NewL (*this));
+		}
+	if ( iAiThread)
+		{
+		iAiThread->StartJob ();
+		return;
+		}
+
+	// Without a worker thread, calculate in small steps on the UI thread.
+	if ( !(iIdleAO))
+		{
+		TRAPD(err, iIdleAO = CIdle::NewL (CActive::EPriorityIdle))
+		;
+		}
+	if ( iIdleAO)
+		{
+		iIdleAO->Start (TCallBack (BackgroundCalcMove, this));
+		}
+	}
+
+void CGomokuPlayerAiSegment::GameOver(eCellColor aWinnerColor)
+	{
+	// The book is not needed until the next game and can't be updated
+	// while it is open.
+	iOpeningBook->Close ();
+	// Learning is optional - the game continues if the book can't be written.
+	TRAP_IGNORE(iBookLearner->GameOverL (aWinnerColor));
+	}
+
+void CGomokuPlayerAiSegment::CancelTurn()
+	{
+	// Waits until the worker thread has finished its current time slice.
+	if ( iAiThread)
+		{
+		iAiThread->CancelJob ();
+		}
+	// Without a worker thread, the calculation only runs in the callbacks
+	// of the active object, so it is stopped as soon as the active object
+	// is cancelled.
+	if ( iIdleAO)
+		{
+		iIdleAO->Cancel ();
+		}
+	iIsActive = EFalse;
+	iProcessingActive = EFalse;
+	}
+
+void CGomokuPlayerAiSegment::SetTimeLimits(TInt aMoveTimeMs, TInt aClockMs)
+	{
+	iTimeManager.SetLimits (aMoveTimeMs, aClockMs);
+	}
+
+void CGomokuPlayerAiSegment::SetReportStatistics(TBool aReport)
+	{
+	iReportStatistics = aReport;
+	}
+
+void CGomokuPlayerAiSegment::SetQuiescenceDepth(TInt aDepth)
+	{
+	iQuiescenceDepth = aDepth;
+	iQuiescence->SetLimits (aDepth, KQuiescenceDefaultThreeDepth,
+			KQuiescenceDefaultNodeBudget);
+	}
+
+void CGomokuPlayerAiSegment::SetNodeBudget(TInt aNodes)
+	{
+	iNodeBudget = aNodes;
+	}
+
+void CGomokuPlayerAiSegment::SetCapturedPairs(TInt aYourPairs,
+		TInt aOpponentPairs)
+	{
+	iCapturedPairs = aYourPairs;
+	iOpponentCapturedPairs = aOpponentPairs;
+	}
+
+void CGomokuPlayerAiSegment::SetRandomSeed(TUint64 aSeed)
+	{
+	iRandom.SetSeed (aSeed);
+	}
+
+TBool CGomokuPlayerAiSegment::GetStatistics(
+		TGomokuSearchStatistics& aStatistics) const
+	{
+	aStatistics = iStatistics;
+	// No statistics before the first move.
+	return (iStatistics.iPvLength > 0);
+	}
+
+TInt CGomokuPlayerAiSegment::BackgroundCalcMove(TAny* aAi)
+	{
+	CGomokuPlayerAiSegment* ai = (CGomokuPlayerAiSegment*)aAi;
+	if ( ai->DoBackgroundCalcMove ())
+		{
+		return ETrue;
+		}
+	ai->SendMove ();
+	return EFalse;
+	}
+
+TBool CGomokuPlayerAiSegment::RunJobStep()
+	{
+	return DoBackgroundCalcMove ();
+	}
+
+void CGomokuPlayerAiSegment::HandleJobFinished()
+	{
+	SendMove ();
+	}
+
+void CGomokuPlayerAiSegment::SendMove()
+	{
+	iIsActive = EFalse;
+	iBookLearner->AddMove (iGrid, iCurrentPlayer, iMove);
+	iObserver->HandleFinishedTurn (iMove.iX, iMove.iY);
+	}
+
+TInt CGomokuPlayerAiSegment::DoBackgroundCalcMove()
+	{
+	if ( !iProcessingActive)
+		{
+		iProcessingActive = ETrue;
+		// Start a new processing task
+		iTimeManager.StartMove ();
+		iLineEvaluator.ResetStatistics ();
+		iQuiescence->ResetStatistics ();
+		iProcessingCol = 0;
+		iProcessingRow = 0;
+		iProcessingPass = 0;
+		iRatedCells = 0;
+		iNumCandidates = 0;
+		// Cells that are not rated when the time is up must not be chosen.
+		for (TInt x = 0; x < iGridSize.iWidth; x++)
+			{
+			for (TInt y = 0; y < iGridSize.iHeight; y++)
+				{
+				iRatingGrid[x][y] = TAKEN_SPACE;
+				}
+			}
+		// Make a backup of the grid. The AI will work on the backup and not the live data
+		CopyToWorkingGrid ();
+		if ( iNnue->Supports (iGridSize))
+			{
+			iNnue->Refresh (iWorkingGrid);
+			}
+		// A row by row scan would spend a small budget on the top rows.
+		if ( iNodeBudget != KNodesUnlimited)
+			{
+			OrderCandidates ();
+			}
+
+		// Before rating the whole board, check if a sequence of fours
+		// forces a win. The rating of the segments can't see those.
+		if ( iThreatSolver->FindWin (iGrid, iCurrentPlayer, iMove,
+				iCapturedPairs, iOpponentCapturedPairs))
+			{
+			iProcessingActive = EFalse;
+			iTimeManager.FinishMove ();
+			UpdateStatistics ();
+			return EFalse;
+			}
+		}
+
+	// Stop early if the time or the node budget is up, but only once there
+	// is a move to choose.
+	if ( iProcessingPass == 2 || (iRatedCells > 0
+			&& (iTimeManager.HardLimitReached () || NodeBudgetReached ())))
+		{
+		// Processed all fields (or ran out of time) - search the best turn
+		// and send it back to the game
+		// Search for best move in the rating field
+		TInt bestMoveX = 0;
+		TInt bestMoveY = 0;
+		TInt bestRating=  TAKEN_SPACE;
+		// Surround rating - if two fields with equal rating are found, the AI takes a look
+		// at the rating of their surrounding fields. The field with the better surround rating
+		// will be chosen. If there are more than one fields with the same surround rating, a random
+		// one is chosen.
+		TSurroundRating bestSurroundRating;
+		bestSurroundRating.iSum = TAKEN_SPACE;
+		bestSurroundRating.iCells = 1;
+		TSurroundRating tempSurroundRating;
+		CreateSurroundTables ();
+		TInt x, y;
+		for (y=0; y < iWorkingGrid->GetRows (); y++)
+			{
+			for (x=0; x < iWorkingGrid->GetCols (); x++)
+				{
+				if ( iRatingGrid[x][y] > bestRating)
+					{
+					// We found a better move than the previous best -> Save the coordinates
+					// and calculate the surround rating (which is automatically the new best
+					// as the move is the best).
+					bestMoveX = x;
+					bestMoveY = y;
+					bestRating = iRatingGrid[x][y];
+					bestSurroundRating = CalcSurroundRating (x, y);
+					}
+				else
+					if ( iRatingGrid[x][y] == bestRating)
+						{
+						// We already found another cell with the same rating as this one. Instead of
+						// simply using the first move that we find, we choose the cell where the surrounding
+						// cells are better.
+						tempSurroundRating = CalcSurroundRating (x, y);
+						TBool useNewCell = EFalse;
+						const TInt order = CompareSurroundRatings (
+								tempSurroundRating, bestSurroundRating);
+						if ( order > 0)
+							{
+							useNewCell = ETrue;
+							}
+						else
+							{
+							if ( order == 0)
+								{
+								// If two cells are equally good, use some randomness so
+								// that not all games are the same.
+								// Accept new cell with 1/iTieBreakOdds propability
+								if ( iRandom.Next (iTieBreakOdds)== 1)
+									{
+									useNewCell = ETrue;
+									}
+								}
+							}
+						// Decided to use the new cell instead of the previous best - save the coordinates
+						// and its surround rating
+						if ( useNewCell)
+							{
+							bestMoveX = x;
+							bestMoveY = y;
+							bestSurroundRating = tempSurroundRating;
+							}
+						}
+				}
+			}
+
+		iProcessingActive = EFalse;
+		iTimeManager.FinishMove ();
+		iMove.SetXY (bestMoveX, bestMoveY);
+		UpdateStatistics ();
+		if ( iReportStatistics)
+			{
+			ReportStatistics ();
+			}
+
+		// The AI has finished processing, the CIdle-object should
+		// be deactivated
+		return EFalse;
+		}
+	else
+		{
+		// Process cells until the time slice is over. Unlike processing a
+		// fixed number of cells, this keeps the application responsive
+		// independent of the size of the grid.
+		iTimeManager.StartSlice ();
+		do
+			{
+			ProcessNextCell ();
+			}
+		while ( iProcessingPass < 2 && !NodeBudgetReached ()
+				&& !iTimeManager.Poll ());
+
+		// The AI has further work to do!
+		return ETrue;
+		}
+
+	}
+
+void CGomokuPlayerAiSegment::ProcessNextCell()
+	{
+	if ( iNumCandidates > 0)
+		{
+		// The cells far away from all stones are not rated with a node
+		// budget, like when the soft time limit is reached.
+		const TInt cell = iCandidates[iNextCandidate];
+		RateCell (cell % iGridSize.iWidth, cell / iGridSize.iWidth);
+		iNextCandidate ++;
+		if ( iNextCandidate == iNumCandidates)
+			{
+			iProcessingPass = 2;
+			}
+		return;
+		}
+
+	// Only consider this field for a move if it's not already taken,
+	// and if it belongs to the current pass.
+	if ( iWorkingGrid->GetGridCell(iProcessingCol, iProcessingRow)->GetColor ()== EColorNeutral
+			&& IsNearStone (iProcessingCol, iProcessingRow) == (iProcessingPass == 0))
+		{
+		RateCell (iProcessingCol, iProcessingRow);
+		}
+
+	// Schedule the next cell
+	iProcessingCol ++;
+	if ( iProcessingCol == iWorkingGrid->GetCols ())
+		{
+		// Reached the end of the current row
+		iProcessingCol = 0;
+		iProcessingRow ++;
+		if ( iProcessingRow == iWorkingGrid->GetRows ())
+			{
+			// Reached the end of the pass. The cells far away from all stones
+			// are hardly ever the best move, skip them if time is short.
+			iProcessingRow = 0;
+			iProcessingPass ++;
+			if ( iRatedCells > 0 && iTimeManager.SoftLimitReached ())
+				{
+				iProcessingPass = 2;
+				}
+			}
+		}
+	}
+
+void CGomokuPlayerAiSegment::RateCell(TInt aX, TInt aY)
+	{
+	// Set the cell of the backup board. This routine will also do the paircheck (if enabled)
+	// and remove stones.
+	// We need to know number of removed pairs so that we can restore the field when
+	// pairs where deleted from the grid while the AI was trying all possible alternatives
+	const TInt removedPairs = iWorkingGrid->SetGridCell (aX, aY,
+			iCurrentPlayer, iPairCheck);
+	// Analyze what the board is like after this move
+	iRatingGrid[aX][aY] = RateMove (aX, aY, removedPairs);
+	iRatedCells ++;
+	// Undo temp move
+	if ( removedPairs > 0)
+		{
+		// Restore backup board (by overwriting it with a new backup of the original board)
+		// because pairs where removed and more of the board was changed.
+		CopyToWorkingGrid ();
+		if ( iNnue->Supports (iGridSize))
+			{
+			iNnue->Refresh (iWorkingGrid);
+			}
+		}
+	else
+		{
+		// No pair was deleted, only undo move directly to save time.
+		iWorkingGrid->SetGridCell (aX, aY, EColorNeutral, EFalse);
+		}
+	}
+
+void CGomokuPlayerAiSegment::OrderCandidates()
+	{
+	iNumCandidates = 0;
+	iNextCandidate = 0;
+	for (TInt distance = 1; distance <= 2; distance++)
+		{
+		for (TInt y = 0; y < iGridSize.iHeight; y++)
+			{
+			for (TInt x = 0; x < iGridSize.iWidth; x++)
+				{
+				if ( iGrid->GetGridCell (x, y)->GetColor ()== EColorNeutral
+						&& IsNearStone (x, y, distance)
+						&& (distance == 1 || !IsNearStone (x, y, 1)))
+					{
+					iCandidates[iNumCandidates++] = y * iGridSize.iWidth + x;
+					}
+				}
+			}
+		}
+	iOrderBoard->CopyFrom (iGrid);
+	iMoveOrdering->NewSearch ();
+	iMoveOrdering->OrderMoves (*iOrderBoard, 0, iCurrentPlayer, -1,
+			iCandidates, iNumCandidates);
+	}
+
+TBool CGomokuPlayerAiSegment::IsNearStone(TInt aX, TInt aY, TInt aDistance)
+	{
+	const TInt startX = TrimToGridSize (aX - aDistance, iGridSize.iWidth);
+	const TInt endX = TrimToGridSize (aX + aDistance, iGridSize.iWidth);
+	const TInt startY = TrimToGridSize (aY - aDistance, iGridSize.iHeight);
+	const TInt endY = TrimToGridSize (aY + aDistance, iGridSize.iHeight);
+	for (TInt x = startX; x <= endX; x++)
+		{
+		for (TInt y = startY; y <= endY; y++)
+			{
+			if ( iGrid->GetGridCell (x, y)->GetColor ()!= EColorNeutral)
+				{
+				return ETrue;
+				}
+			}
+		}
+	return EFalse;
+	}
+
+CGomokuPlayerAiSegment::TSurroundRating CGomokuPlayerAiSegment::CalcSurroundRating(
+		TInt aX, TInt aY)
+	{
+	// Take a look at the 9 surrounding cells of the coordinate, the borders
+	// of the grid and the taken cells are not considered.
+	const TInt width = iGridSize.iWidth + 1;
+	const TInt startX = Max (aX - 1, 0);
+	const TInt endX = Min (aX + 2, iGridSize.iWidth);
+	const TInt startY = Max (aY - 1, 0);
+	const TInt endY = Min (aY + 2, iGridSize.iHeight);
+	TSurroundRating rating;
+	rating.iSum = iSurroundSums[endY * width + endX]
+			- iSurroundSums[startY * width + endX]
+			- iSurroundSums[endY * width + startX]
+			+ iSurroundSums[startY * width + startX];
+	rating.iCells = iSurroundCells[endY * width + endX]
+			- iSurroundCells[startY * width + endX]
+			- iSurroundCells[endY * width + startX]
+			+ iSurroundCells[startY * width + startX];
+	// The cell itself is not part of its surrounding.
+	if ( iRatingGrid[aX][aY] != TAKEN_SPACE)
+		{
+		rating.iSum -= iRatingGrid[aX][aY];
+		rating.iCells --;
+		}
+	return rating;
+	}
+
+TInt CGomokuPlayerAiSegment::CompareSurroundRatings(
+		const TSurroundRating& aFirst, const TSurroundRating& aSecond)
+	{
+	if ( aFirst.iCells == 0 || aSecond.iCells == 0)
+		{
+		return -1;
+		}
+	// Both numbers of cells are positive, so the averages compare like
+	// the sums multiplied with the number of cells of the other one.
+	const TInt64 first = aFirst.iSum * aSecond.iCells;
+	const TInt64 second = aSecond.iSum * aFirst.iCells;
+	return (first > second) ? 1 : ((first == second) ? 0 : -1);
+	}
+
+void CGomokuPlayerAiSegment::CreateSurroundTables()
+	{
+	const TInt width = iGridSize.iWidth + 1;
+	for (TInt x = 0; x < width; x++)
+		{
+		iSurroundSums[x] = 0;
+		iSurroundCells[x] = 0;
+		}
+	for (TInt y = 0; y < iGridSize.iHeight; y++)
+		{
+		TInt64 rowSum = 0;
+		TInt rowCells = 0;
+		TInt64* sums = iSurroundSums + (y + 1) * width;
+		TInt* cells = iSurroundCells + (y + 1) * width;
+		sums[0] = 0;
+		cells[0] = 0;
+		for (TInt x = 0; x < iGridSize.iWidth; x++)
+			{
+			if ( iRatingGrid[x][y] != TAKEN_SPACE)
+				{
+				rowSum += iRatingGrid[x][y];
+				rowCells ++;
+				}
+			sums[x + 1] = sums[x + 1 - width] + rowSum;
+			cells[x + 1] = cells[x + 1 - width] + rowCells;
+			}
+		}
+	}
+
+TInt CGomokuPlayerAiSegment::AnalyzeBoard()
+	{
+	if ( TGomokuLineEvaluator::Supports (iGridSize))
+		{
+		return iLineEvaluator.Evaluate (iWorkingGrid, iCurrentPlayer);
+		}
+	return AnalyzeRows ();
+	}
+
+TInt CGomokuPlayerAiSegment::AnalyzeRows()
+	{
+	TInt totalRating = 0;
+
+	// --- Horizontal
+	// Go from left to right starting at the left border in direction: right
+	CalcRow (totalRating, 0, iWorkingGrid->GetRows (), EFalse, 0, 1, 0);
+
+	// --- Vertical
+	// Go from top to bottom starting at the upper border in direction: down
+	CalcRow (totalRating, 0, iWorkingGrid->GetCols (), ETrue, 0, 0, 1);
+
+	// --- Diagonal 1
+	// Go from top to bottom starting at the left border in direction: down right
+	CalcRow (totalRating, 0, iWorkingGrid->GetRows ()- 4, EFalse, 0, 1, 1);
+	// Go from left to right starting at the upper border in direction: down right
+	CalcRow (totalRating, 1, iWorkingGrid->GetCols ()- 4, ETrue, 0, 1, 1);
+
+	// --- Diagonal 2
+	// Go from top to bottom starting at the left border in direction: up right
+	CalcRow (totalRating, 4, iWorkingGrid->GetRows (), EFalse, 0, 1, -1);
+	// Go from left to right starting at the lower border in direction: up right
+	CalcRow (totalRating, 1, iWorkingGrid->GetCols ()- 4, ETrue,
+			iWorkingGrid->GetRows ()-1, 1, -1);
+
+	return totalRating;
+	}
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+void CGomokuPlayerAiSegment::RateAllCells(TGomokuRatingPath aPath,
+		TInt* aRatings)
+	{
+	CopyToWorkingGrid ();
+	if ( iNnue->Supports (iGridSize))
+		{
+		iNnue->Refresh (iWorkingGrid);
+		}
+	for (TInt y = 0; y < iGridSize.iHeight; y++)
+		{
+		for (TInt x = 0; x < iGridSize.iWidth; x++)
+			{
+			if ( iWorkingGrid->GetGridCell(x, y)->GetColor ()!= EColorNeutral)
+				{
+				iRatingGrid[x][y] = TAKEN_SPACE;
+				}
+			else
+				if ( aPath == ERatingPathAi)
+					{
+					RateCell (x, y);
+					}
+				else
+					{
+					// Like RateCell(), but with one of the cell by cell ratings.
+					const TInt removedPairs = iWorkingGrid->SetGridCell (x, y,
+							iCurrentPlayer, iPairCheck);
+					iRatingGrid[x][y] = (aPath == ERatingPathLegacy)
+							? AnalyzeRowsLegacy () : AnalyzeRows ();
+					if ( removedPairs > 0)
+						{
+						CopyToWorkingGrid ();
+						}
+					else
+						{
+						iWorkingGrid->SetGridCell (x, y, EColorNeutral, EFalse);
+						}
+					}
+			aRatings[y * iGridSize.iWidth + x] = iRatingGrid[x][y];
+			}
+		}
+	}
+
+TInt CGomokuPlayerAiSegment::RateBoardLegacy()
+	{
+	CopyToWorkingGrid ();
+	return AnalyzeRowsLegacy ();
+	}
+
+TInt CGomokuPlayerAiSegment::AnalyzeRowsLegacy()
+	{
+	TInt totalRating = 0;
+
+	// Same rows as AnalyzeRows()
+	CalcRowLegacy (totalRating, 0, iWorkingGrid->GetRows (), EFalse, 0, 1, 0);
+	CalcRowLegacy (totalRating, 0, iWorkingGrid->GetCols (), ETrue, 0, 0, 1);
+	CalcRowLegacy (totalRating, 0, iWorkingGrid->GetRows ()- 4, EFalse, 0, 1, 1);
+	CalcRowLegacy (totalRating, 1, iWorkingGrid->GetCols ()- 4, ETrue, 0, 1, 1);
+	CalcRowLegacy (totalRating, 4, iWorkingGrid->GetRows (), EFalse, 0, 1, -1);
+	CalcRowLegacy (totalRating, 1, iWorkingGrid->GetCols ()- 4, ETrue,
+			iWorkingGrid->GetRows ()-1, 1, -1);
+
+	return totalRating;
+	}
+
+void CGomokuPlayerAiSegment::CalcRowLegacy(TInt& aTotalRating,
+		TInt aRowStart, TInt aRowEnd, TBool aAssignRowToX,
+		TInt aOtherStartValue, TInt aDx, TInt aDy)
+	{
+	TInt x, y;
+	eCellColor curCellColor = EColorNeutral;
+	// Variable when potentially dangerous pair situation should be considered "XOO." then gets a penalty.
+	TInt countMyPairs = 0;
+	// Go through all rows as specified by the parameters
+	for (TInt curRowPos = aRowStart; curRowPos < aRowEnd; curRowPos++)
+		{
+		// Starting analysis of a new row - reset the analyze segment
+		ResetAnalyzeSeg ();
+		countMyPairs = 0;
+		// Set start value so that x and y coordinates can be increased in each iteration of the current row-loop.
+		if ( aAssignRowToX)
+			{
+			x = curRowPos;
+			y = aOtherStartValue;
+			}
+		else
+			{
+			y = curRowPos;
+			x = aOtherStartValue;
+			}
+		// Go through the whole row.
+		do
+			{
+			// Add the color of the current cell to the 5 cells wide analyzing segment
+			// (round array structure).
+			curCellColor = iWorkingGrid->GetGridCell(x, y)->GetColor ();
+			AddToSeg (curCellColor);
+			// calculate the rating of the current segment and add it to the total rating.
+			// Only analyze the segment when 5 stones have already been added, so that
+			// the border of the grid doesn't look like free cells.
+			if ( iNthAnalysis >= KSegmentCells)
+				{
+				aTotalRating += CalcTotalRatingForSeg ();
+				}
+
+			// The pair check prevention mechanism is a bit more complicated, as it needs
+			// to search for a special pattern, whereas the normal AI calculations only
+			// have to count the number of stones in a segment.
+			if ( iPairCheck)
+				{
+				if ( curCellColor == iCurrentPlayer)
+					{
+					// Count how many cells of the own color are found in a row.
+					countMyPairs ++;
+					}
+				else
+					{
+					// If a stone in another color than the own was found, check if the previous
+					// two stones where of the own color (and we're not directly at the border of the grid).
+					// If less than two stones preceded this event, it would have been reset previously.
+					// If more stones are in a row, countMyPairs would be > 2.
+					if ( countMyPairs == 2 && iNthAnalysis > 3)
+						{
+						// Get history color stored three cells ago.
+						TInt tempPos = iCurPos - 3;
+						// Do correction for round array structure
+						if ( tempPos < 0)
+							tempPos = 5 + tempPos;
+						// If the stone 3 fields ago has the opposite color of the current one
+						// and the two stones in the middle are the own color,
+						// we have a potentially dangerous pair capture situation - therefore, decrease
+						// the total rating.
+						if ( iAnalyzeSeg[tempPos] != curCellColor)
+							{
+							aTotalRating -= KSegmentPairPenalty;
+							}
+						}
+					// A stone not in the own color was found - reset counter.
+					countMyPairs = 0;
+					}
+				}
+
+			// Go through the row in the specified direction until we have reached the end
+			x += aDx;
+			y += aDy;
+			}
+		while (x < iWorkingGrid->GetCols ()&& y < iWorkingGrid->GetRows ()&& y >= 0);
+		}
+	}
+
+void CGomokuPlayerAiSegment::ResetAnalyzeSeg()
+	{
+	// Reset analyze array to neutral + all counting variables to the beginning.
+	iCurPos = 0;
+	iNthAnalysis = 0;
+	for (TInt i = 0; i < 5; i ++)
+		{
+		iAnalyzeSeg[i] = EColorNeutral;
+		}
+	}
+
+void CGomokuPlayerAiSegment::AddToSeg(eCellColor aCellColor)
+	{
+	// Increase position
+	iCurPos ++;
+	// Round array - if 5+, start again from 0.
+	iCurPos %= 5;
+	// Store the color
+	iAnalyzeSeg[iCurPos] = aCellColor;
+	// Store the number of stones added so that the segment isn't considered after
+	// only for example 3 stones have been added when starting on the border of the grid.
+	iNthAnalysis ++;
+	}
+#endif
+
+TInt CGomokuPlayerAiSegment::RateMove(TInt aX, TInt aY, TInt aRemovedPairs)
+	{
+	TInt rating;
+	if ( iQuiescenceDepth > 0 && TGomokuLineEvaluator::Supports (iGridSize))
+		{
+		rating = iQuiescence->Evaluate (iWorkingGrid, iCurrentPlayer,
+				iLineEvaluator, iCapturedPairs + aRemovedPairs,
+				iOpponentCapturedPairs);
+		}
+	else
+		if ( iNnue->Supports (iGridSize))
+			{
+			// The accumulators hold the board before the move. Only the new
+			// stone has to be added, unless pairs were captured.
+			if ( aRemovedPairs > 0)
+				{
+				iNnue->Refresh (iWorkingGrid);
+				rating = iNnue->Evaluate (iCurrentPlayer);
+				}
+			else
+				{
+				iNnue->MakeMove (aY * iGridSize.iWidth + aX, iCurrentPlayer);
+				rating = iNnue->Evaluate (iCurrentPlayer);
+				iNnue->UndoMove ();
+				}
+			}
+		else
+			{
+			return AnalyzeBoard ();
+			}
+	// Won and lost lines are rated far beyond any board. Keep them in the
+	// range of board ratings, so that they don't dominate the surround
+	// rating and a lost move is still better than a taken cell.
+	return Max (TAKEN_SPACE + 1, Min (rating, -TAKEN_SPACE - 1));
+	}
+
+void CGomokuPlayerAiSegment::CalcRow(TInt& aTotalRating, TInt aRowStart,
+		TInt aRowEnd, TBool aAssignRowToX, TInt aOtherStartValue, TInt aDx,
+		TInt aDy)
+	{
+	TInt x, y;
+	// Colors of the cells of the current row, the newest cell in the lowest bits.
+	TUint code = 0;
+	// Number of cells of the current row that have been added to the code.
+	TInt numCells = 0;
+	// Go through all rows as specified by the parameters
+	for (TInt curRowPos = aRowStart; curRowPos < aRowEnd; curRowPos++)
+		{
+		// Starting analysis of a new row - reset the code
+		code = 0;
+		numCells = 0;
+		// Set start value so that x and y coordinates can be increased in each iteration of the current row-loop.
+		if ( aAssignRowToX)
+			{
+			x = curRowPos;
+			y = aOtherStartValue;
+			}
+		else
+			{
+			y = curRowPos;
+			x = aOtherStartValue;
+			}
+		// Go through the whole row.
+		do
+			{
+			// Add the color of the current cell to the code of the row.
+			code = TGomokuSegmentTable::AddCell (code,
+					iWorkingGrid->GetGridCell(x, y)->GetColor ());
+			numCells ++;
+			// Look up the rating of the last 5 cells and add it to the total rating.
+			// The segment isn't rated before 5 cells have been added, so that the
+			// border of the grid doesn't look like free cells. The pair check
+			// penalty (included in the segment rating) only needs 4 cells.
+			if ( numCells >= KSegmentCells)
+				{
+				aTotalRating += iSegmentTable.Rating (code);
+				}
+			else
+				if ( numCells == KSegmentCells - 1)
+					{
+					aTotalRating += iSegmentTable.PairRating (code);
+					}
+
+			// Go through the row in the specified direction until we have reached the end
+			x += aDx;
+			y += aDy;
+			}
+		while (x < iWorkingGrid->GetCols ()&& y < iWorkingGrid->GetRows ()&& y >= 0);
+		}
+	}
+
+void CGomokuPlayerAiSegment::CreateSegmentTable()
+	{
+	for (TInt code = 0; code < KSegmentCodes; code ++)
+		{
+		// Decode the segment, the oldest cell is stored in the highest bits.
+		for (TInt i = 0; i < KSegmentCells; i ++)
+			{
+			iAnalyzeSeg[i] = TGomokuSegmentTable::Cell (code,
+					KSegmentCells - 1 - i);
+			}
+		TInt rating = CalcTotalRatingForSeg ();
+		// If the stone 3 fields ago has the opposite color of the current one
+		// and the two stones in the middle are the own color, we have a
+		// potentially dangerous pair capture situation ("XOO.") - therefore,
+		// decrease the rating.
+		if ( iPairCheck && TGomokuSegmentTable::IsCapturablePair (code,
+				iCurrentPlayer))
+			{
+			rating -= KSegmentPairPenalty;
+			}
+		iSegmentTable.iRating[code] = rating;
+		}
+	for (TInt code = 0; code < KSegmentPairCodes; code ++)
+		{
+		iSegmentTable.iPairRating[code] = 0;
+		if ( iPairCheck && TGomokuSegmentTable::IsCapturablePair (code,
+				iCurrentPlayer))
+			{
+			iSegmentTable.iPairRating[code] = -KSegmentPairPenalty;
+			}
+		}
+
+	// Rating of segments with only own or only enemy stones for the line evaluator.
+	TInt myRating[KSegmentCells + 1];
+	TInt enemyRating[KSegmentCells + 1];
+	for (TInt stones = 0; stones <= KSegmentCells; stones ++)
+		{
+		for (TInt i = 0; i < KSegmentCells; i ++)
+			{
+			iAnalyzeSeg[i] = (i < stones) ? iCurrentPlayer : EColorNeutral;
+			}
+		myRating[stones] = CalcTotalRatingForSeg ();
+		for (TInt i = 0; i < stones; i ++)
+			{
+			iAnalyzeSeg[i] = iEnemyPlayer;
+			}
+		enemyRating[stones] = CalcTotalRatingForSeg ();
+		}
+	iLineEvaluator.SetRatings (myRating, enemyRating,
+			iPairCheck ? KSegmentPairPenalty : 0);
+	}
+
+TInt CGomokuPlayerAiSegment::CountHitsInSeg(eCellColor aCheckForColor)
+	{
+	TInt score = 0;
+	for (TInt i=0; i<5; i++)
+		{
+		if ( iAnalyzeSeg[i] == aCheckForColor)
+			{
+			// Increase the score if a stone of the specified color is found.
+			score ++;
+			}
+		else
+			if ( iAnalyzeSeg[i] != EColorNeutral)
+				{
+				// If opposite color was found, the score is automatically 0.
+				score = 0;
+				break;
+				}
+		}
+	return score;
+	}
+
+TInt CGomokuPlayerAiSegment::RateHitsForPlayer(eCellColor aMyColor,
+		eCellColor aCountedFor, TInt aScore)
+	{
+	// Assign a rating depending on how many stones were found.
+	// The more stones, the higher the rating. It is always doubled, leaving space
+	// for the enemy getting double points (see below).
+	TInt rating = KSegmentStoneRating[aScore];
+
+	// If hits are counted for the enemy, rate it twice as much. This compensates
+	// that the AI has already done a (temponary) move. Example:
+	// Both the enemy and the AI have 3 in a row. As the enemy is the next, he will make
+	// 4 out of it. Therefore, all constellations of the enemy receive a higher rating
+	// than the own constellations.
+	if ( aMyColor != aCountedFor)
+		rating *= KSegmentEnemyFactor;
+
+	return rating;
+	}
+
+TInt CGomokuPlayerAiSegment::CalcTotalRatingForSeg()
+	{
+	// Analyze the own rating, counting how many own stones are in this segment.
+	TInt myScore = CountHitsInSeg (iCurrentPlayer);
+	// Rate it from the perspective of the current player
+	TInt myRating = RateHitsForPlayer (iCurrentPlayer, iCurrentPlayer, myScore);
+
+	// Analyze the rating of the enemy. Again, first count the number of stones in the segment.
+	TInt enemyScore = CountHitsInSeg (iEnemyPlayer);
+	// Rate it from the perspective that we counted stones of the enemy player.
+	TInt enemyRating = RateHitsForPlayer (iCurrentPlayer, iEnemyPlayer,
+			enemyScore);
+
+	// Return the difference of those two ratings, weighted by the personality of the AI.
+	return myRating * iMyWeight - enemyRating * iEnemyWeight;
+	}
+
+void CGomokuPlayerAiSegment::UpdateStatistics()
+	{
+	iStatistics.Reset ();
+	iStatistics.iNodes = SearchedNodes ();
+	iStatistics.iDepth = 1 + ((iQuiescenceDepth > 0) ? iQuiescence->MaxPly ()
+			: 0);
+	iStatistics.iTimeMs = iTimeManager.ElapsedMs ();
+	iStatistics.iHashLookups = iLineEvaluator.CacheLookups ();
+	iStatistics.iHashHits = iLineEvaluator.CacheHits ();
+	iStatistics.AddPvMove (iMove);
+	}
+
+TInt CGomokuPlayerAiSegment::SearchedNodes() const
+	{
+	// With the quiescence search, the rated positions are counted as its
+	// nodes as well.
+	return (iQuiescenceDepth > 0 && TGomokuLineEvaluator::Supports (iGridSize))
+			? iQuiescence->Nodes () : iRatedCells;
+	}
+
+TBool CGomokuPlayerAiSegment::NodeBudgetReached() const
+	{
+	return (SearchedNodes () >= iNodeBudget);
+	}
+
+void CGomokuPlayerAiSegment::ReportStatistics() const
+	{
+	const TInt lookups = iLineEvaluator.CacheLookups ();
+	const TInt hits = iLineEvaluator.CacheHits ();
+	RDebug::Print (_L("Segment AI: %d cells rated in %d ms"), iRatedCells,
+			iTimeManager.ElapsedMs ());
+	RDebug::Print (_L("Segment AI: line cache %d hits of %d lookups (%d%%)"),
+			hits, lookups, lookups > 0 ? (TInt) ((TInt64) hits * 100 / lookups) : 0);
+	if ( iQuiescenceDepth > 0)
+		{
+		RDebug::Print (_L("Segment AI: %d quiescence nodes, %d of %d cells extended"),
+				iQuiescence->Nodes (), iQuiescence->ExtendedPositions (),
+				iRatedCells);
+		}
+	}
+
+TInt CGomokuPlayerAiSegment::TrimToGridSize(TInt aValue, TInt aGridSize)
+	{
+	if ( aValue < 0)
+		aValue = 0;
+	if ( aValue >= aGridSize)
+		aValue = aGridSize - 1;
+	return aValue;
+	}
+
+void CGomokuPlayerAiSegment::CopyToWorkingGrid()
+	{
+	iWorkingGrid->CopyFrom (iGrid);
+	}
+
+void CGomokuPlayerAiSegment::CreateRatingGridL()
+	{
+	// First remove previous grid (if necessary).
+	DeleteRatingGrid ();
+
+	// Create new 2D dynamic arrays.
+	if ( iGridSize.iWidth > 0 && iGridSize.iHeight > 0)
+		{
+		iRatingGrid = new (ELeave) TInt* [iGridSize.iWidth];
+		for (TInt i=0; i<iGridSize.iWidth; i++)
+			{
+			*(iRatingGrid+i) = new (ELeave) TInt[iGridSize.iHeight];
+			}
+		const TInt tableSize = (iGridSize.iWidth + 1) * (iGridSize.iHeight + 1);
+		iSurroundSums = new (ELeave) TInt64[tableSize];
+		iSurroundCells = new (ELeave) TInt[tableSize];
+		iCandidates = new (ELeave) TInt[iGridSize.iWidth * iGridSize.iHeight];
+		}
+	}
+
+void CGomokuPlayerAiSegment::DeleteRatingGrid()
+	{
+	// If the grid exists, delete it.
+	if ( iRatingGrid)
+		{
+		for (TInt i=0; i<iGridSize.iWidth; i++)
+			{
+			delete[] *(iRatingGrid+i);
+			}
+		delete[] iRatingGrid;
+		iRatingGrid = NULL;
+		}
+	delete[] iSurroundSums;
+	iSurroundSums = NULL;
+	delete[] iSurroundCells;
+	iSurroundCells = NULL;
+	delete[] iCandidates;
+	iCandidates = NULL;
+	}
+
@@ -0,0 +1,922 @@
+/*
+ ============================================================================
+ Name		 : GomokuPlayerAiSegment.h
+ Copyright   : Andreas Jakl, 2007-2009
+ 
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+ 
+ Description : Segment based artificial intelligence that can handle
+               both a game with and without pair check. The reference,
+               defensive and aggressive AIs only differ in their weights.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPLAYERAISEGMENT_H_
+#define GOMOKUPLAYERAISEGMENT_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include <e32debug.h>
+#include <e32math.h>
+#include "GomokuPlayerInterface.h"
+#include "GomokuThreatSolver.h"
+#include "GomokuQuiescence.h"
+#include "GomokuMoveOrdering.h"
+#include "GomokuNnue.h"
+#include "GomokuOpeningBook.h"
+#include "GomokuBookLearner.h"
+#include "GomokuTimeManager.h"
+#include "GomokuSegmentTable.h"
+#include "GomokuLineEvaluator.h"
+#include "GomokuRandom.h"
+#include "GomokuAiThread.h"
+
+/**
+ * Extremely low rating for a space that is already taken and can no longer be used.
+ */
+#define TAKEN_SPACE		-20000
+
+/**
+ * No limit for the number of nodes that the AI searches per move.
+ */
+const TInt KNodesUnlimited = KMaxTInt;
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+/**
+ * Evaluation used by CGomokuPlayerAiSegment::RateAllCells().
+ */
+enum TGomokuRatingPath
+	{
+	/**
+	 * Like a turn of the AI: the line evaluator, the quiescence search or
+	 * the neural network.
+	 */
+	ERatingPathAi,
+	/**
+	 * The segment table, see AnalyzeRows().
+	 */
+	ERatingPathSegmentTable,
+	/**
+	 * Counting the stones of every segment like the original AIs.
+	 */
+	ERatingPathLegacy
+	};
+#endif
+
+// CLASS DECLARATION
+
+
+/**
+ * Thread calculating the best move for an AI player.
+ *
+ * This routine will try out every possible move. For each move, the total rating
+ * of the board is calculated. Then, the best move is chosen.
+ * Instead of searching for patterns, this algorithm goes through each row of the
+ * grid (in every direction: horizontal, vertical and both diagonal directions)
+ * and takes a look at every possible 5-stone-segment. The stones in the segments
+ * are counted and the segment a rating. This rating is summed up for the total board rating.
+ * The total rating for each possible AI-move is stored in an array. After calculating the move,
+ * the AI chooses the best move. If two moves are equally good, it calculates the
+ * average of the surrounding cell ratings. If both moves have an equal surround rating,
+ * the decision will be random.
+ *
+ * Explanation of the search method with examples:
+ *
+ * . . = empty field in the grid
+ * .x. = enemy stone
+ * .o. = own stone
+ * .|. = analyze segment border
+ *
+ * The following situation should be considered as dangerous:
+ *
+ * -------------------------- BOARD SITUATION
+ * . . . . . .x.x.x. . . . .
+ * -------------------------- ANALYSIS
+ * . | - - - -X|x.x. . . . .  - 1. segment - 1 stone found:  rating 1  (*2 -> enemy) = -2
+ * . . | - - -X-X|x. . . . .  - 2. segment - 2 stones found: rating 4  (*2 -> enemy) = -8
+ * . . . | - -X-X-X| . . . .  - 3. segment - 3 stones found: rating 16 (*2 -> enemy) = -32
+ * . . . . | -X-X-X- | . . .  - 4. segment - 3 stones found: rating 16 (*2 -> enemy) = -32
+ * . . . . . |X-X-X- - | . .  - 5. segment - 3 stones found: rating 16 (*2 -> enemy) = -32
+ * . . . . . .x|X-X- - - | .  - 6. segment - 2 stones found: rating 4  (*2 -> enemy) = -8
+ * . . . . . .x.x|X- - - - |  - 7. segment - 1 stone found:  rating 1  (*2 -> enemy) = -2
+ * ------------------------------------------------------------------------------------
+ *                                                                     Total Rating: -116
+ *
+ * This situation gets a quite high negative rating which is decreased from the total score of
+ * the board rating. Therefore, a board with such a situation in it will get a very low
+ * rating. The advantage is that one stone will also already be considered, even though it
+ * only gets a very low rating. But in situations where no clear best move is available,
+ * it pays if every single stone is considered. Of course this check is done in all directions.
+ *
+ * But what can the AI do to make this situation less dangerous? The following shows why
+ * a move where the AI puts a stone directly next to the pattern above will get a higher rating:
+ *
+ * -------------------------- BOARD SITUATION
+ * . . . . .o.x.x.x. . . . .
+ * -------------------------- ANALYSIS
+ * | - - - -O|x.x.x. . . . .  - 0. segment - 1 own stone:    rating 1                = 1
+ * . | - - -O-X|x.x. . . . .  - 1. segment - own stone found:rating 0                = -0
+ * . . | - -O-X-X|x. . . . .  - 2. segment - own stone found:rating 0                = -0
+ * . . . | -O-X-X-X| . . . .  - 3. segment - own stone found:rating 0                = -0
+ * . . . . |O-X-X-X- | . . .  - 4. segment - own stone found:rating 0                = -0
+ * . . . . .o|X-X-X- - | . .  - 5. segment - 3 stones found: rating 16 (*2 -> enemy) = -32
+ * . . . . .o.x|X-X- - - | .  - 6. segment - 2 stones found: rating 4  (*2 -> enemy) = -8
+ * . . . . .o.x.x|X- - - - |  - 7. segment - 1 stone found:  rating 1  (*2 -> enemy) = -2
+ * ------------------------------------------------------------------------------------
+ *                                                                     Total Rating: -41
+ *
+ * Every time an own stone is in the analyzed segment, the enemy *can not* build 5 in a row
+ * in this segment anymore. Therefore, it is not dangerous and not relevant anymore.
+ * Using this logic, a move where the AI places its stone next to the pattern will get a
+ * much better rating.
+ *
+ * The *2 for the enemy is because of the following situation: The AI rates the board after
+ * it has made his own (temponary) move. Therefore, if the enemy has 3 in a row and the AI
+ * also has 3 in a row somewhere else, the situation is not equal but much worse for the AI
+ * because the enemy will make 4 out of this in the next move, basically winning the game.
+ *
+ * Of course the board doesn't only have to be rated for the enemy, the AI also has to find
+ * good moves for itself. This is done by simply turning around the counting mechanism.
+ * Each own stone (o) in a segment gets counted, if an enemy stone (x) is found in the segment,
+ * it is no longer relevant. The total rating of each segment is the difference of the
+ * enemy and the own ranking. Those two steps are combined to one logical step in the example above.
+ *
+ * If enabled, the AI also has a correction to find situations where the enemy player can
+ * capture a pair of the AI (.x.o.o. .). Those situations get an additional penalty in the rating.
+ *
+ * The original AIs counted the stones of every segment while walking along the rows
+ * (CountHitsInSeg() and RateHitsForPlayer()). This rating is kept as the reference for
+ * the faster evaluations if GOMOKU_VERIFY_EVALUATOR is defined: the EvaluatorCheck tool
+ * compares the ratings of every cell with RateAllCells().
+ *
+ * The personality of the AI is defined by the weights of the own and the enemy rating
+ * of a segment and by the propability to switch to another cell with the same rating.
+ * Its strength is defined by the node budget and the quiescence depth.
+ * Use CGomokuPlayerAiSegmentT to create an AI with a specific personality.
+ */
+
+class CGomokuPlayerAiSegment : public CGomokuPlayerInterface,
+		public MGomokuAiJob
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuPlayerAiSegment();
+
+public:
+	/**
+	 * Initialize the player implementation. This method is called by
+	 * the game engine before the game is started and provides
+	 * the necessary parameters to the implementation.
+	 *
+	 * \param aGrid a reference of the grid that will be valid for the
+	 * whole game. The implementation should save a pointer to this
+	 * grid to be able to read the current grid state during the game.
+	 * Player implementations should not modify the grid. The engine
+	 * has its own private copy of the reference grid and synchronizes
+	 * the grid that the implementations use with the reference grid after
+	 * every move to be on the safe side, though.
+	 * \param aYourColor the color this implementation is assigned with for
+	 * this game.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 */
+	void InitL(CGrid* aGrid, eCellColor aYourColor, TBool aPairCheck, TInt aNumPairsWin);
+
+	/**
+	 * Called when the turn of this player is started. The implementation
+	 * should analyze the grid through the pointer it gets through the
+	 * InitL() method. Once the implementation is finished with
+	 * calculating its move, it should call the callback function
+	 * defined in the MGomokuPlayerObserver-interface.
+	 *
+	 * It is an advantage if the player starts its own thread for
+	 * calculating the next move, or if it uses a background active object
+	 * to do so. Otherwise, the game will hang.
+	 *
+	 * If the calculation is fast, this does not have to be done, however.
+	 * The game engine handles the callbacks of the implementation
+	 * asynchronously using an own timer, in order to ease the implementation
+	 * of players.
+	 */
+	void StartTurn();
+
+	/**
+	 * If a player is active, the game engine forwards selected cell events
+	 * (through the pointer or key events) to the implementation. This
+	 * is necessary for human players, but could also be used to implement
+	 * half-automatic AIs or other things.
+	 *
+	 * \param aCol column of the grid cell that was selected.
+	 * \param aRow row of the grid cell that was selected.
+	 */
+	void HandleSelectedCellL(TInt aCol, TInt aRow);
+
+	/**
+	 * This method is called by the game engine when the game is over,
+	 * the parameter provides the color of the winning player.
+	 *
+	 * This is important for network players, which might have to send
+	 * this result over the air to the other game instance. The AI adds
+	 * the result to the opening book.
+	 *
+	 * \param aWinnerColor color of the winning player.
+	 */
+	void GameOver(eCellColor aWinnerColor);
+
+	/**
+	 * Stop the background calculation of the current turn. The move of
+	 * the turn is not sent to the observer. If the move is calculated in
+	 * the worker thread, this waits until the thread has stopped.
+	 */
+	void CancelTurn();
+
+	/**
+	 * Configure the thinking time of the AI. If the time is up before all
+	 * cells have been rated, the best of the rated cells is played.
+	 * The cells close to existing stones are rated first.
+	 *
+	 * \param aMoveTimeMs deadline per move in milliseconds,
+	 * KTimeUnlimited for no deadline.
+	 * \param aClockMs remaining time on the game clock of this player in
+	 * milliseconds, KTimeUnlimited if the game is played without a clock.
+	 */
+	void SetTimeLimits(TInt aMoveTimeMs, TInt aClockMs = KTimeUnlimited);
+
+	/**
+	 * Print the number of rated cells, the hit rate of the line cache and
+	 * the positions of the quiescence search to the debug output after
+	 * each move.
+	 */
+	void SetReportStatistics(TBool aReport);
+
+	/**
+	 * Rate every possible move only after the forcing moves that follow it
+	 * (see CGomokuQuiescence), instead of rating the board right after the
+	 * move. Only used for grids that the line evaluator supports.
+	 *
+	 * \param aDepth maximum number of plies of forcing moves,
+	 * 0 to rate the board right after the move (the default).
+	 */
+	void SetQuiescenceDepth(TInt aDepth);
+
+	/**
+	 * Limit the number of nodes per move: the rated cells, or the
+	 * positions of the quiescence search if it is activated. When the
+	 * budget is used up, the best of the rated cells is played, like
+	 * when the time is up. Unlike the thinking time, the budget gives the
+	 * same strength on every device, and a small one saves battery.
+	 * With a budget, the cells close to stones are rated in the order of
+	 * CGomokuMoveOrdering instead of row by row (see OrderCandidates()),
+	 * so that the budget is spent on the most promising moves.
+	 *
+	 * \param aNodes maximum number of nodes, KNodesUnlimited for no limit
+	 * (the default).
+	 */
+	void SetNodeBudget(TInt aNodes);
+
+	/**
+	 * Seed the random number generator, so that the moves of the AI can
+	 * be reproduced. By default, it is seeded with
+	 * TGomokuRandom::DefaultSeed().
+	 */
+	void SetRandomSeed(TUint64 aSeed);
+
+	/**
+	 * Get the statistics of the last move: the rated cells (or the nodes
+	 * of the quiescence search), the hit rate of the line cache and the
+	 * chosen move. The depth is 1 plus the plies of the quiescence search.
+	 *
+	 * \param aStatistics receives the statistics.
+	 * \return ETrue if the AI has already made a move.
+	 */
+	TBool GetStatistics(TGomokuSearchStatistics& aStatistics) const;
+
+	/**
+	 * Store the pairs captured so far, for recognising wins by capturing
+	 * in the threat search.
+	 */
+	void SetCapturedPairs(TInt aYourPairs, TInt aOpponentPairs);
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+	/**
+	 * Rate every free cell of the grid of the game on the calling thread,
+	 * like a turn does but without the threat solver, the opening book and
+	 * the limits. Used by the EvaluatorCheck tool.
+	 *
+	 * \param aPath the evaluation to rate the boards with.
+	 * \param aRatings receives the rating of every cell, row by row,
+	 * TAKEN_SPACE for the taken cells.
+	 */
+	void RateAllCells(TGomokuRatingPath aPath, TInt* aRatings);
+
+	/**
+	 * Rate the grid of the game itself with the legacy evaluation, for
+	 * the color of this AI.
+	 * \return the total rating of the board.
+	 */
+	TInt RateBoardLegacy();
+#endif
+protected:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 *
+	 * \param aMyWeight weight of the own rating of a segment.
+	 * \param aEnemyWeight weight of the enemy rating of a segment.
+	 * \param aTieBreakOdds a cell with the same rating and surround rating as the
+	 * best cell so far is used instead with the propability 1 / aTieBreakOdds.
+	 * \param aNodeBudget initial node budget, see SetNodeBudget().
+	 * \param aQuiescenceDepth initial quiescence depth, see SetQuiescenceDepth().
+	 */
+	CGomokuPlayerAiSegment(TInt aMyWeight, TInt aEnemyWeight, TInt aTieBreakOdds,
+			TInt aNodeBudget = KNodesUnlimited, TInt aQuiescenceDepth = 0);
+
+	/**
+	 * EPOC default constructor for performing 2nd stage construction
+	 */
+	void ConstructL();
+
+private:
+	/**
+	 * Static callback function for the CIdle active object.
+	 * This method can call the non-static processing function
+	 * of the AI implementation, which will do the actual processing
+	 * of the computer move (-> DoBackgroundCalcMove()).
+	 *
+	 * \param aAi pointer to an instance of the implementation, which
+	 * allows to call the non-static method.
+	 * \return ETrue if the processing isn't finished yet and
+	 * the active object should call this method again as soon as possible.
+	 * EFalse if processing has finished and this method doesn't need
+	 * to be called anymore (for this turn).
+	 */
+	static TInt BackgroundCalcMove(TAny* aAi);
+
+	/**
+	 * The non-static processing function which will be called numerous
+	 * times by the CIdle active object. It will process grid cells until
+	 * the time slice of the time manager is over, in order to retain
+	 * responsivness of the total application.
+	 *
+	 * \return ETrue if the processing isn't finished yet and
+	 * the active object should call this method again as soon as possible.
+	 * EFalse if processing has finished and this method doesn't need
+	 * to be called anymore (for this turn).
+	 */
+	TInt DoBackgroundCalcMove();
+
+	// from MGomokuAiJob
+	TBool RunJobStep();
+	void HandleJobFinished();
+
+	/**
+	 * Send the move in iMove to the observer and add it to the game of
+	 * the book learner. Called on the thread of the game engine.
+	 */
+	void SendMove();
+
+	/**
+	 * Rate the next cell of the background calculation and move on to the
+	 * following cell.
+	 */
+	void ProcessNextCell();
+
+	/**
+	 * Rate the move to the cell and store the rating in iRatingGrid.
+	 */
+	void RateCell(TInt aX, TInt aY);
+
+	/**
+	 * Collect the free cells close to stones in iCandidates: the cells
+	 * next to a stone first, then the cells two steps away. Then the
+	 * moves that make or block threats are moved to the front with
+	 * CGomokuMoveOrdering, which keeps the order of the other moves.
+	 */
+	void OrderCandidates();
+
+	/**
+	 * Check if a stone is close to the cell in the live grid.
+	 * \param aDistance maximum distance of the stone in cells.
+	 * \return ETrue if a stone is at most aDistance cells away.
+	 */
+	TBool IsNearStone(TInt aX, TInt aY, TInt aDistance = 2);
+
+	/**
+	 * Go through the whole board in all directions and calculate its total rating.
+	 * Uses the line evaluator if it supports the size of the grid, otherwise
+	 * the rows are rated cell by cell with AnalyzeRows().
+	 * \return the total rating of this board.
+	 */
+	TInt AnalyzeBoard();
+
+	/**
+	 * Rate the board cell by cell with CalcRow(), in all directions.
+	 * \return the total rating of this board.
+	 */
+	TInt AnalyzeRows();
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+	/**
+	 * Rate the board cell by cell with CalcRowLegacy(), in all directions.
+	 * \return the total rating of this board.
+	 */
+	TInt AnalyzeRowsLegacy();
+
+	/**
+	 * Like CalcRow(), but counts the stones of every segment with
+	 * CalcTotalRatingForSeg() instead of looking up the segment table.
+	 */
+	void CalcRowLegacy(TInt& aTotalRating, TInt aRowStart, TInt aRowEnd,
+			TBool aAssignRowToX, TInt aOtherStartValue, TInt aDx, TInt aDy);
+
+	/**
+	 * Reset the analyze segment for a new row.
+	 */
+	void ResetAnalyzeSeg();
+
+	/**
+	 * Add the color of the next cell of the row to the analyze segment.
+	 */
+	void AddToSeg(eCellColor aCellColor);
+#endif
+
+	/**
+	 * Rate the move on the working grid: the rating of the board (by the
+	 * neural network if one is loaded for this grid size), or the result
+	 * of the quiescence search if it is activated.
+	 *
+	 * \param aX column of the move.
+	 * \param aY row of the move.
+	 * \param aRemovedPairs number of pairs the move captured.
+	 * \return the rating of the move, always higher than TAKEN_SPACE.
+	 */
+	TInt RateMove(TInt aX, TInt aY, TInt aRemovedPairs);
+
+	/**
+	 * Sum and number of the rated (free) neighbor cells of a cell. The
+	 * surround rating is their average.
+	 */
+	class TSurroundRating
+		{
+	public:
+		TInt64 iSum;
+		TInt iCells;
+		};
+
+	/**
+	 * Calculate the surround rating for the specified cell from the
+	 * tables of CreateSurroundTables().
+	 * Surround rating is the average rating of all (free) neighbor cells.
+	 *
+	 * \param aX x coordinate to calculate surround rating for
+	 * \param aY y coordinate to calculate surround rating for.
+	 * \return sum and number of the neighbor cells.
+	 */
+	TSurroundRating CalcSurroundRating(TInt aX, TInt aY);
+
+	/**
+	 * Compare the averages of two surround ratings without a division.
+	 * A cell without rated neighbors has no average, it is neither better
+	 * than nor equal to any other cell.
+	 *
+	 * \return a positive number if aFirst is better, 0 if both are equal,
+	 * a negative number otherwise.
+	 */
+	static TInt CompareSurroundRatings(const TSurroundRating& aFirst,
+			const TSurroundRating& aSecond);
+
+	/**
+	 * Calculate the summed-area tables of the ratings and the number of
+	 * rated cells, so that the surround rating of every cell can be
+	 * calculated in constant time while the best move is chosen.
+	 */
+	void CreateSurroundTables();
+
+	/**
+	 * Add the rating of all rows specified by the parameters ot the total rating.
+	 * Example: starting at the top, going to the bottom, and doing that for all rows.
+	 *
+	 * \param aTotalRating current total rating of the board. The value calculated by
+	 * this process will be added.
+	 * \param aRowStart coordinate where the row should start
+	 * \param aRowEnd coordinate where the row should end
+	 * \param is x or y value specified by the two parameters above.
+	 * \param aOtherStartValue one coordinate will always start at the position specified
+	 * above (looping through aRowStart to aRowEnd), the other one will always get the start
+	 * value assigned by this parameter.
+	 * \param aDx change of the x coordinate for each step
+	 * \param aDy change of the y coordinate for each step
+	 */
+	void CalcRow(TInt& aTotalRating, TInt aRowStart, TInt aRowEnd,
+			TBool aAssignRowToX, TInt aOtherStartValue, TInt aDx, TInt aDy);
+
+	/**
+	 * Fill the segment table with the rating of every possible segment,
+	 * for the own color and the pair check setting of the current game.
+	 * Also sets the ratings of the line evaluator.
+	 */
+	void CreateSegmentTable();
+
+	/**
+	 * Count how many stones with the specified color are currently in the analyze segment.
+	 * If one stone with the opposite color is found, the rating is 0.
+	 * \param aCheckForColor count number of stones for this color
+	 * \return number of stones of the specified color. 0 if no stone of this color is in the
+	 * segment, or if at least one stone of the opposite color is in the segment.
+	 */
+	TInt CountHitsInSeg(eCellColor aCheckForColor);
+
+	/**
+	 * Calculate a rating for the number of stones. If 3 stones with the same color are
+	 * in a segment, it gets a higher rating than if only 1. If the number of stones was
+	 * counted for the enemy, he will get a higher rating for the same stone situation.
+	 * This is because the AI move has already been done and the enemy will be the next to move.
+	 * \param aMyColor color of the own player
+	 * \param aCountedFor color of the stones that have been counted
+	 * \param aScore number of stones in the segment
+	 * \return the rating of the segment.
+	 */
+	TInt RateHitsForPlayer(eCellColor aMyColor, eCellColor aCountedFor,
+			TInt aScore);
+
+	/**
+	 * Calculate the rating of the segment, considering both the own situation and the enemy
+	 * situation. This is done by counting the number of stones in the segment and rating this.
+	 * \return the rating for this segment. The higher the better.
+	 */
+	TInt CalcTotalRatingForSeg();
+
+	/**
+	 * Fill iStatistics for the move in iMove.
+	 */
+	void UpdateStatistics();
+
+	/**
+	 * \return number of nodes searched for the current move, see
+	 * SetNodeBudget().
+	 */
+	TInt SearchedNodes() const;
+
+	/**
+	 * \return ETrue if the node budget of the current move is used up.
+	 */
+	TBool NodeBudgetReached() const;
+
+	/**
+	 * Print the statistics of the line cache and the quiescence search of
+	 * the current move to the debug output.
+	 */
+	void ReportStatistics() const;
+
+	/**
+	 * Make sure that the value isn't below 0 or bigger than the specified value.
+	 * \param aValue value to trim
+	 * \param aGridSize maximum value
+	 * \return trimmed value
+	 */
+	TInt TrimToGridSize(TInt aValue, TInt aGridSize);
+
+	/**
+	 * Create a two-dimensional array of the same size as the gaming grid.
+	 * During the calculation, this is used to store the rating for each
+	 * grid cell.
+	 */
+	void CreateRatingGridL();
+
+	/**
+	 * Delete the rating grid.
+	 */
+	void DeleteRatingGrid();
+
+	/**
+	 * To analyze the result of a possible move, the AI needs to actually execute
+	 * the move to be able to analyze the new situation. As this shouldn't be
+	 * done on the grid provided by the game engine, the AI keeps its own copy
+	 * of the grid, which it is free to modify.
+	 * Of course, this is also important to undo a move, in order to try the next
+	 * possible move.
+	 */
+	void CopyToWorkingGrid();
+private:
+	/**
+	 * Worker thread that calculates the moves. Created in the first turn,
+	 * owned by this class.
+	 */
+	CGomokuAiThread* iAiThread;
+
+	/**
+	 * The active object that takes care of calling the processing method
+	 * until the calculation is finished, if the worker thread can't be
+	 * created. The calculation itself is done in small increments, as this
+	 * approach uses active objects and no thread - and only one active object
+	 * can be active at the same time, therefore blocking the rest of the
+	 * application.
+	 */
+	CIdle* iIdleAO;
+
+	/**
+	 * The move of the current turn, once it has been calculated.
+	 */
+	TPoint iMove;
+
+	/**
+	 * Pointer to the grid, owned by the game engine.
+	 * This grid always contains the current game state and should not
+	 * be modified by this implementation.
+	 */
+	CGrid* iGrid;
+
+	/**
+	 * True if this implementation is currently active.
+	 * This is the case in the timeframe between StartTurn() is called
+	 * and the implementation sends back its move to the observer.
+	 */
+	TBool iIsActive;
+
+	/**
+	 * Local copy of the grid, which can be used by the AI to try possible
+	 * moves, in order to evaluate their impact on the game.
+	 */
+	CGrid* iWorkingGrid;
+
+	/**
+	 * Finds forced moves when the turn starts and searches for forced
+	 * wins through continuous fours before the board is rated.
+	 * Owned by this class.
+	 */
+	CGomokuThreatSolver* iThreatSolver;
+
+	/**
+	 * Searches the forcing moves after each possible move if
+	 * iQuiescenceDepth is not 0. Owned by this class.
+	 */
+	CGomokuQuiescence* iQuiescence;
+
+	/**
+	 * Sorts the candidates if the node budget is limited.
+	 * Owned by this class.
+	 */
+	CGomokuMoveOrdering* iMoveOrdering;
+
+	/**
+	 * Copy of the live grid for iMoveOrdering. Owned by this class.
+	 */
+	CGomokuBoard* iOrderBoard;
+
+	/**
+	 * Moves for the first positions of a game, if the book file exists.
+	 * Owned by this class.
+	 */
+	CGomokuOpeningBook* iOpeningBook;
+
+	/**
+	 * Adds the moves and results of the games to the opening book.
+	 * Owned by this class.
+	 */
+	CGomokuBookLearner* iBookLearner;
+
+	/**
+	 * Rates the boards instead of the segments if a network file for the
+	 * grid size exists. Owned by this class.
+	 */
+	CGomokuNnue* iNnue;
+
+	/**
+	 * Maximum number of plies of the quiescence search, 0 if deactivated.
+	 */
+	TInt iQuiescenceDepth;
+
+	/**
+	 * Maximum number of nodes per move, see SetNodeBudget().
+	 */
+	TInt iNodeBudget;
+
+	/**
+	 * Rating grid that is used to store the ratings of all analyzed cells
+	 * during the calculation of the next move. The grid cell with the highest
+	 * rating will be the best move that this implementation can find.
+	 */
+	TInt** iRatingGrid;
+
+	/**
+	 * Summed-area table of iRatingGrid without the taken cells: entry
+	 * y * (width + 1) + x is the sum of all ratings above and left of cell
+	 * (x, y). Created with the rating grid.
+	 */
+	TInt64* iSurroundSums;
+
+	/**
+	 * Summed-area table of the number of cells that aren't taken, same
+	 * layout as iSurroundSums.
+	 */
+	TInt* iSurroundCells;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Number of captured pairs required for winning a game.
+	 */
+	TInt iNumPairsWin;
+
+	/**
+	 * Pairs captured by this player so far, see SetCapturedPairs().
+	 */
+	TInt iCapturedPairs;
+
+	/**
+	 * Pairs captured by the opponent so far.
+	 */
+	TInt iOpponentCapturedPairs;
+	
+	/**
+	 * If a background calculation is already active, this is set to ETrue.
+	 * In case it is set to EFalse, the first call to the calculation method
+	 * will know that a new calculation just started and allows it to initialize
+	 * everything. After this, iProcessingActive will be set to ETrue - until
+	 * calculating the computer move has finished.
+	 */
+	TBool iProcessingActive;
+
+	/**
+	 * Currently processed column of the grid for the background calculation.
+	 * Needs to be stored so that the AI remembers its progress until the
+	 * next call of the DoBackgroundCalcMove() method.
+	 */
+	TInt iProcessingCol;
+
+	/**
+	 * Currently processed row of the background calculation. Needs to be stored
+	 * so that the AI remembers its progress until the next call of the
+	 * DoBackgroundCalcMove() method.
+	 */
+	TInt iProcessingRow;
+
+	/**
+	 * Pass of the background calculation. The first pass rates the cells
+	 * close to existing stones, the second pass all other cells. If the
+	 * soft time limit is reached after the first pass, the second pass
+	 * is skipped.
+	 */
+	TInt iProcessingPass;
+
+	/**
+	 * Number of cells rated in the current turn.
+	 */
+	TInt iRatedCells;
+
+	/**
+	 * Cells to rate in this order if the node budget is limited (position
+	 * in the cell array), see OrderCandidates(). One entry per cell.
+	 */
+	TInt* iCandidates;
+
+	/**
+	 * Number of cells in iCandidates, 0 to rate the cells row by row.
+	 */
+	TInt iNumCandidates;
+
+	/**
+	 * Position of the next cell to rate in iCandidates.
+	 */
+	TInt iNextCandidate;
+
+	/**
+	 * Thinking time of the current turn.
+	 */
+	TGomokuTimeManager iTimeManager;
+
+	/**
+	 * ETrue if the statistics are printed after each move.
+	 */
+	TBool iReportStatistics;
+
+	/**
+	 * Statistics of the last move, see GetStatistics().
+	 */
+	TGomokuSearchStatistics iStatistics;
+
+	/**
+	 * When starting to analyze, this variable stores for which player to calculate a move.
+	 */
+	eCellColor iCurrentPlayer;
+
+	/**
+	 * The opposite color of the own player.
+	 */
+	eCellColor iEnemyPlayer;
+
+	/**
+	 * Segment of 5 stones that is rated when the segment table is created
+	 * (and by the legacy rating).
+	 */
+	eCellColor iAnalyzeSeg[5];
+
+	/**
+	 * Rating of every possible segment, created in InitL(). Used by
+	 * CalcRow() instead of counting the stones of each segment.
+	 */
+	TGomokuSegmentTable iSegmentTable;
+
+	/**
+	 * Rates all segments of a line at once from bit masks of the stones.
+	 */
+	TGomokuLineEvaluator iLineEvaluator;
+
+	/**
+	 * Size of the grid that is used in the current game.
+	 * Stored here for easier and faster access.
+	 */
+	TSize iGridSize;
+
+	/**
+	 * Random number generator, seeded with TGomokuRandom::DefaultSeed()
+	 * when this object is instantiated.
+	 */
+	TGomokuRandom iRandom;
+
+	/**
+	 * Weight of the own rating of a segment.
+	 */
+	TInt iMyWeight;
+
+	/**
+	 * Weight of the enemy rating of a segment.
+	 */
+	TInt iEnemyWeight;
+
+	/**
+	 * A cell with the same rating as the best cell is used with the
+	 * propability 1 / iTieBreakOdds.
+	 */
+	TInt iTieBreakOdds;
+
+#ifdef GOMOKU_VERIFY_EVALUATOR
+	/**
+	 * Position of the newest cell in iAnalyzeSeg while a row is rated with
+	 * CalcRowLegacy() (round array).
+	 */
+	TInt iCurPos;
+
+	/**
+	 * Number of cells of the current row added to iAnalyzeSeg. A segment
+	 * is only rated once it is complete.
+	 */
+	TInt iNthAnalysis;
+#endif
+	};
+
+/**
+ * Segment based AI with the personality defined by the policy class.
+ * This is a thin template, all code is in CGomokuPlayerAiSegment.
+ *
+ * The policy has to define the enumeration values EMyWeight, EEnemyWeight,
+ * ETieBreakOdds, ENodeBudget and EQuiescenceDepth, see the parameters of the
+ * constructor of CGomokuPlayerAiSegment.
+ */
+template <class TPolicy>
+class CGomokuPlayerAiSegmentT : public CGomokuPlayerAiSegment
+	{
+public:
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuPlayerAiSegmentT* NewL();
+
+private:
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuPlayerAiSegmentT();
+	};
+
+template <class TPolicy>
+CGomokuPlayerAiSegmentT<TPolicy>* CGomokuPlayerAiSegmentT<TPolicy>::NewL()
+	{
+	CGomokuPlayerAiSegmentT* self = new (ELeave) CGomokuPlayerAiSegmentT();
+	CleanupStack::PushL (self);
+	self->ConstructL ();
+	CleanupStack::Pop (); // self;
+	return self;
+	}
+
+template <class TPolicy>
+CGomokuPlayerAiSegmentT<TPolicy>::CGomokuPlayerAiSegmentT() :
+	CGomokuPlayerAiSegment(TPolicy::EMyWeight, TPolicy::EEnemyWeight,
+			TPolicy::ETieBreakOdds, TPolicy::ENodeBudget,
+			TPolicy::EQuiescenceDepth)
+	{
+	// No implementation required
+	}
+
+#endif /*GOMOKUPLAYERAISEGMENT_H_*/
@@ -23,6 +23,7 @@ iIsActive(EFalse)
 
 CGomokuPlayerHuman::~CGomokuPlayerHuman()
 	{
+	delete iAnalysis;
 	}
 
 CGomokuPlayerHuman* CGomokuPlayerHuman::NewL()
@@ -36,7 +37,7 @@ CGomokuPlayerHuman* CGomokuPlayerHuman::NewL()
 
 void CGomokuPlayerHuman::ConstructL()
 	{
-
+	iAnalysis = CGomokuAnalysis::NewL();
 	}
 
 void CGomokuPlayerHuman::HandleSelectedCellL(TInt aCol, TInt aRow)
@@ -56,6 +57,9 @@ void CGomokuPlayerHuman::HandleSelectedCellL(TInt aCol, TInt aRow)
 			{
 			iIsActive = EFalse;
 			iObserver->HandleFinishedTurn(aCol, aRow);
+			// Only stop the analysis after the move has been handed on,
+			// it has no use for the next position.
+			iAnalysis->Cancel();
 			}
 		}
 	}
@@ -63,15 +67,30 @@ void CGomokuPlayerHuman::HandleSelectedCellL(TInt aCol, TInt aRow)
 void CGomokuPlayerHuman::StartTurn()
 	{
 	iIsActive = ETrue;
+	iAnalysis->Start(iGrid, iColor);
 	}
 
 void CGomokuPlayerHuman::GameOver(eCellColor /*aWinnerColor*/)
 	{
+	iAnalysis->Cancel();
+	}
+
+void CGomokuPlayerHuman::CancelTurn()
+	{
+	iIsActive = EFalse;
+	iAnalysis->Cancel();
+	}
 
+TInt CGomokuPlayerHuman::GetHints(TGomokuMoveHint* aHints, TInt aMaxHints) const
+	{
+	return iIsActive ? iAnalysis->GetHints(aHints, aMaxHints) : 0;
 	}
 
-void CGomokuPlayerHuman::InitL(CGrid* aGrid, eCellColor /*aYourColor*/, TBool /*aPairCheck*/, TInt /*aNumPairsWin*/)
+void CGomokuPlayerHuman::InitL(CGrid* aGrid, eCellColor aYourColor, TBool aPairCheck, TInt /*aNumPairsWin*/)
 	{
 	iGrid = aGrid;
+	iColor = aYourColor;
+	iIsActive = EFalse;
+	iAnalysis->InitL(TSize(aGrid->GetCols(), aGrid->GetRows()), aPairCheck);
 	}
 
@@ -20,6 +20,7 @@
 #include <e32base.h>
 #include <e32debug.h>
 #include "GomokuPlayerInterface.h"
+#include "GomokuAnalysis.h"
 
 // CLASS DECLARATION
 
@@ -102,6 +103,19 @@ public:
 	 */
 	void GameOver(eCellColor aWinnerColor);
 
+	/**
+	 * The turn is over without a move, selected cells are ignored until
+	 * the next turn starts.
+	 */
+	void CancelTurn();
+
+	/**
+	 * The best moves found by the analysis that runs in the background
+	 * during the turn, 0 outside of the turn or until the analysis
+	 * has finished.
+	 */
+	TInt GetHints(TGomokuMoveHint* aHints, TInt aMaxHints) const;
+
 private:
 
 	/**
@@ -128,6 +142,16 @@ private:
 	 * and the implementation sends back its move to the observer.
 	 */
 	TBool iIsActive;
+
+	/**
+	 * Suggests moves while the human thinks about the turn. Owned.
+	 */
+	CGomokuAnalysis* iAnalysis;
+
+	/**
+	 * Color of this player in the current game.
+	 */
+	eCellColor iColor;
 	};
 
 #endif /*GOMOKUPLAYERHUMAN_H_*/
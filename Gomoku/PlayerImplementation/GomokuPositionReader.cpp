@@ -0,0 +1,110 @@
+/*
+ ============================================================================
+ Name		 : GomokuPositionReader.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : TGomokuPositionReader implementation
+ ============================================================================
+ */
+
+#include "GomokuPositionReader.h"
+
+TGomokuPositionReader::TGomokuPositionReader(const TDesC8& aPositions) :
+	iRemaining(aPositions), iLineNumber(0)
+	{
+	}
+
+TBool TGomokuPositionReader::NextLine()
+	{
+	while (iRemaining.Length() > 0)
+		{
+		TInt lineLength = iRemaining.Locate('\n');
+		if (lineLength == KErrNotFound)
+			{
+			lineLength = iRemaining.Length();
+			}
+		iLine.Set(iRemaining.Left(lineLength));
+		iRemaining.Set(iRemaining.Mid(Min(lineLength + 1, iRemaining.Length())));
+		iLineNumber++;
+
+		TLex8 first(iLine);
+		first.SkipSpace();
+		if (!first.Eos() && first.Peek() != '#')
+			{
+			return ETrue;
+			}
+		}
+	iLine.Set(KNullDesC8);
+	return EFalse;
+	}
+
+TBool TGomokuPositionReader::ParsePosition(TSize& aGridSize,
+		TBool& aPairCheck, TInt& aNumPairsWin, TPoint* aMoves,
+		TInt& aNumMoves) const
+	{
+	TLex8 lex(iLine);
+	TInt pairCheck;
+	lex.SkipSpace();
+	if (lex.Val(aGridSize.iWidth) != KErrNone || aGridSize.iWidth <= 0)
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(aGridSize.iHeight) != KErrNone || aGridSize.iHeight <= 0)
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(pairCheck) != KErrNone || (pairCheck != 0 && pairCheck != 1))
+		{
+		return EFalse;
+		}
+	lex.SkipSpace();
+	if (lex.Val(aNumPairsWin) != KErrNone || aNumPairsWin <= 0)
+		{
+		return EFalse;
+		}
+	aPairCheck = (pairCheck != 0);
+
+	aNumMoves = 0;
+	lex.SkipSpace();
+	while (!lex.Eos())
+		{
+		if (aNumMoves == KMaxPositionMoves || lex.Val(aMoves[aNumMoves].iX)
+				!= KErrNone || lex.Get() != ',' || lex.Val(
+				aMoves[aNumMoves].iY) != KErrNone)
+			{
+			return EFalse;
+			}
+		aNumMoves++;
+		lex.SkipSpace();
+		}
+	return ETrue;
+	}
+
+TBool TGomokuPositionReader::PlayMoves(CGrid* aGrid, TBool aPairCheck,
+		const TPoint* aMoves, TInt aNumMoves, TInt* aCapturedPairs)
+	{
+	aCapturedPairs[0] = 0;
+	aCapturedPairs[1] = 0;
+	const TSize gridSize = aGrid->GetSize();
+	for (TInt i = 0; i < aNumMoves; i++)
+		{
+		const TPoint& move = aMoves[i];
+		if (!aGrid->IsInGrid(move.iX, gridSize.iWidth) || !aGrid->IsInGrid(
+				move.iY, gridSize.iHeight) || !aGrid->GetGridCell(move.iX,
+				move.iY)->IsFree())
+			{
+			return EFalse;
+			}
+		const eCellColor color = (i % 2 == 0) ? EColor1 : EColor2;
+		aCapturedPairs[i % 2] += aGrid->SetGridCell(move.iX, move.iY, color,
+				aPairCheck);
+		}
+	return ETrue;
+	}
@@ -0,0 +1,103 @@
+/*
+ ============================================================================
+ Name		 : GomokuPositionReader.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Reads the positions files of the console tools.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPOSITIONREADER_H_
+#define GOMOKUPOSITIONREADER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include "Grid.h"
+
+/**
+ * Maximum number of moves of a position.
+ */
+const TInt KMaxPositionMoves = 1024;
+
+// CLASS DECLARATION
+
+/**
+ * Reads the positions of the ProofSolver and BatchEvaluator tools. Every
+ * line describes one position by the moves that led to it, starting on an
+ * empty grid:
+ *   <columns> <rows> <pair check 0/1> <pairs to win> <x>,<y> <x>,<y> ...
+ * The player that made the first move has color 1, the moves alternate.
+ * Empty lines and lines starting with '#' are skipped.
+ *
+ * The reader doesn't copy the text, it has to stay valid while the reader
+ * is used.
+ */
+class TGomokuPositionReader
+	{
+public:
+	/**
+	 * Constructor, starts before the first line of aPositions.
+	 */
+	TGomokuPositionReader(const TDesC8& aPositions);
+
+	/**
+	 * Go to the next line that is not empty and no comment.
+	 * \return EFalse if there are no more lines.
+	 */
+	TBool NextLine();
+
+	/**
+	 * \return the number of the current line in the text, starting at 1.
+	 */
+	inline TInt LineNumber() const;
+
+	/**
+	 * Parse the position of the current line.
+	 *
+	 * \param aMoves array for at least KMaxPositionMoves moves.
+	 * \return EFalse if the line is not a valid position: the grid is empty,
+	 * the number of pairs to win isn't positive, a number is missing or
+	 * there are more than KMaxPositionMoves moves.
+	 */
+	TBool ParsePosition(TSize& aGridSize, TBool& aPairCheck,
+			TInt& aNumPairsWin, TPoint* aMoves, TInt& aNumMoves) const;
+
+	/**
+	 * Play the moves of a position on the grid and count the pairs that
+	 * were captured by the player of color 1 (aCapturedPairs[0]) and of
+	 * color 2 (aCapturedPairs[1]).
+	 *
+	 * \param aGrid empty grid of the size of the position.
+	 * \return EFalse if a move is outside of the grid or on an occupied cell.
+	 */
+	static TBool PlayMoves(CGrid* aGrid, TBool aPairCheck,
+			const TPoint* aMoves, TInt aNumMoves, TInt* aCapturedPairs);
+
+private:
+	/**
+	 * Text after the current line.
+	 */
+	TPtrC8 iRemaining;
+
+	/**
+	 * Current line.
+	 */
+	TPtrC8 iLine;
+
+	/**
+	 * Number of the current line, 0 before the first one.
+	 */
+	TInt iLineNumber;
+	};
+
+inline TInt TGomokuPositionReader::LineNumber() const
+	{
+	return iLineNumber;
+	}
+
+#endif /*GOMOKUPOSITIONREADER_H_*/
@@ -0,0 +1,520 @@
+/*
+ ============================================================================
+ Name		 : GomokuProofSolver.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuProofSolver implementation
+ ============================================================================
+ */
+
+#include "GomokuProofSolver.h"
+#include "GomokuRandom.h"
+
+CGomokuProofSolver::CGomokuProofSolver() :
+	iAttacker(EColor1), iNodeBudget(KProofDefaultNodeBudget),
+			iRadius(KProofDefaultRadius), iWinningMove(-1)
+	{
+	// No implementation required
+	}
+
+CGomokuProofSolver::~CGomokuProofSolver()
+	{
+	delete iBoard;
+	delete iOrdering;
+	DeleteArrays();
+	}
+
+CGomokuProofSolver* CGomokuProofSolver::NewL()
+	{
+	CGomokuProofSolver* self = new (ELeave) CGomokuProofSolver();
+	CleanupStack::PushL(self);
+	self->iBoard = CGomokuBoard::NewL();
+	self->iOrdering = CGomokuMoveOrdering::NewL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuProofSolver::InitL(TSize aGridSize, TBool aPairCheck,
+		TInt aNumPairsWin, TInt aHashEntries)
+	{
+	iPairCheck = aPairCheck;
+	iNumPairsWin = aNumPairsWin;
+	iBoard->ResizeL(aGridSize);
+	DeleteArrays();
+	const TInt numCells = iBoard->NumCells();
+
+	// The hash index is masked, so the size has to be a power of 2.
+	iHashSize = 1;
+	while (iHashSize * 2 <= (TUint32) aHashEntries)
+		{
+		iHashSize *= 2;
+		}
+	iHash = new (ELeave) THashEntry[iHashSize];
+	Mem::FillZ(iHash, iHashSize * sizeof(THashEntry));
+	iHashUsed = 0;
+
+	// Index and lock key for every cell and color. Always use the same seed,
+	// so that the search is reproducible.
+	iZobrist = new (ELeave) TUint32[numCells * 4];
+	TGomokuRandom random;
+	random.SetSeed(0x1234567);
+	for (TInt i = 0; i < numCells * 4; i++)
+		{
+		iZobrist[i] = random.Next();
+		}
+
+	iChildren = new (ELeave) TChild[numCells * (KProofMaxDepth + 1)];
+	iMarks = new (ELeave) TUint32[numCells];
+	Mem::FillZ(iMarks, numCells * sizeof(TUint32));
+	iMarkGeneration = 0;
+	iOrderedMoves = new (ELeave) TInt[numCells];
+	iOrdering->InitL(numCells, aPairCheck);
+	}
+
+void CGomokuProofSolver::SetLimits(TInt aNodeBudget, TInt aRadius)
+	{
+	iNodeBudget = aNodeBudget;
+	// Fives and captures are always next to a stone, these cells are required.
+	iRadius = Max(aRadius, 1);
+	}
+
+void CGomokuProofSolver::SetObserver(MGomokuProofObserver* aObserver)
+	{
+	iObserver = aObserver;
+	}
+
+void CGomokuProofSolver::DeleteArrays()
+	{
+	delete[] iHash;
+	iHash = NULL;
+	delete[] iZobrist;
+	iZobrist = NULL;
+	delete[] iChildren;
+	iChildren = NULL;
+	delete[] iMarks;
+	iMarks = NULL;
+	delete[] iOrderedMoves;
+	iOrderedMoves = NULL;
+	}
+
+TGomokuProofResult CGomokuProofSolver::Solve(const CGrid* aGrid,
+		eCellColor aToMove, TInt aCapturedPairsToMove,
+		TInt aCapturedPairsOpponent)
+	{
+	iBoard->CopyFrom(aGrid);
+	iBoard->SetCapturedPairs(aToMove, aCapturedPairsToMove);
+	iBoard->SetCapturedPairs(CGomokuBoard::Opponent(aToMove),
+			aCapturedPairsOpponent);
+	iKey = 0;
+	iKeyLock = 0;
+	for (TInt i = 0; i < iBoard->NumCells(); i++)
+		{
+		if (iBoard->CellAt(i) != EColorNeutral)
+			{
+			HashStone(i, iBoard->CellAt(i));
+			}
+		}
+	iNodes = 0;
+	iAborted = EFalse;
+	iWinningMove = -1;
+	iOrdering->NewSearch();
+	iOrdering->ResetStatistics();
+
+	// 1st run: can the player to move force a win?
+	iAttacker = aToMove;
+	iDepthLimitHit = EFalse;
+	if (ProveWin(0, ETrue))
+		{
+		return EProofWon;
+		}
+	if (iAborted)
+		{
+		return EProofUnknown;
+		}
+	// Positions at the maximum depth count as not won, so if these were
+	// reached, the disproof does not mean that there is no win.
+	const TBool firstRunExact = !iDepthLimitHit;
+
+	// 2nd run: can the opponent force a win?
+	iAttacker = CGomokuBoard::Opponent(aToMove);
+	iDepthLimitHit = EFalse;
+	if (ProveWin(1, EFalse))
+		{
+		return EProofLost;
+		}
+	if (iAborted || !firstRunExact || iDepthLimitHit)
+		{
+		return EProofUnknown;
+		}
+	return EProofDrawn;
+	}
+
+TPoint CGomokuProofSolver::WinningMove() const
+	{
+	if (iWinningMove < 0)
+		{
+		return TPoint(-1, -1);
+		}
+	return TPoint(iWinningMove % iBoard->Cols(), iWinningMove / iBoard->Cols());
+	}
+
+TInt CGomokuProofSolver::NodesSearched() const
+	{
+	return iNodes;
+	}
+
+TInt CGomokuProofSolver::FirstMoveCutoffRate() const
+	{
+	return iOrdering->FirstMoveCutoffRate();
+	}
+
+TBool CGomokuProofSolver::ProveWin(TInt aRun, TBool aAttackerToMove)
+	{
+	// Proof numbers of the other run are for a different attacker.
+	Mem::FillZ(iHash, iHashSize * sizeof(THashEntry));
+	iHashUsed = 0;
+	iRun = aRun;
+	iRootProof = 1;
+	iRootDisproof = 1;
+
+	const eCellColor toMove = aAttackerToMove ? iAttacker
+			: CGomokuBoard::Opponent(iAttacker);
+	TUint32 phi, delta;
+	Mid(0, toMove, KProofInfinity, KProofInfinity, phi, delta);
+	iRootProof = aAttackerToMove ? phi : delta;
+	iRootDisproof = aAttackerToMove ? delta : phi;
+	ReportProgress();
+	return (iRootProof == 0);
+	}
+
+void CGomokuProofSolver::Mid(TInt aDepth, eCellColor aToMove, TUint32 aThPhi,
+		TUint32 aThDelta, TUint32& aPhi, TUint32& aDelta)
+	{
+	iNodes++;
+	if (iNodes % KProofProgressInterval == 0)
+		{
+		ReportProgress();
+		}
+	if (iNodes > iNodeBudget)
+		{
+		iAborted = ETrue;
+		}
+	Lookup(aToMove, aPhi, aDelta);
+	if (iAborted || aPhi >= aThPhi || aDelta >= aThDelta)
+		{
+		return;
+		}
+	if (aDepth >= KProofMaxDepth)
+		{
+		iDepthLimitHit = ETrue;
+		SetAttackerFailed(aToMove, aPhi, aDelta);
+		return;
+		}
+
+	const TInt numChildren = GenerateMoves(aDepth, aToMove, aPhi, aDelta);
+	if (numChildren == 0)
+		{
+		Store(aToMove, aPhi, aDelta);
+		return;
+		}
+
+	TChild* children = iChildren + aDepth * iBoard->NumCells();
+	const eCellColor enemyColor = CGomokuBoard::Opponent(aToMove);
+	TInt best = 0;
+	FOREVER
+		{
+		// phi of this position is the smallest delta of the children,
+		// delta is the sum of all phi numbers.
+		best = 0;
+		TUint32 secondDelta = KProofInfinity;
+		aPhi = KProofInfinity;
+		aDelta = 0;
+		for (TInt i = 0; i < numChildren; i++)
+			{
+			const TChild& child = children[i];
+			if (child.iDelta < aPhi)
+				{
+				secondDelta = aPhi;
+				aPhi = child.iDelta;
+				best = i;
+				}
+			else if (child.iDelta < secondDelta)
+				{
+				secondDelta = child.iDelta;
+				}
+			if (child.iPhi >= KProofInfinity)
+				{
+				aDelta = KProofInfinity;
+				}
+			else if (aDelta < KProofInfinity)
+				{
+				aDelta = Min(aDelta + child.iPhi, KProofInfinity - 1);
+				}
+			}
+		if (aDepth == 0)
+			{
+			const TBool attackerToMove = (aToMove == iAttacker);
+			iRootProof = attackerToMove ? aPhi : aDelta;
+			iRootDisproof = attackerToMove ? aDelta : aPhi;
+			if (aPhi == 0)
+				{
+				iWinningMove = children[best].iIndex;
+				}
+			}
+		if (iAborted || aPhi >= aThPhi || aDelta >= aThDelta)
+			{
+			break;
+			}
+
+		// Search the most promising child until it is no longer the best one.
+		TChild& child = children[best];
+		const TUint32 childThPhi = Min(aThDelta - aDelta + child.iPhi,
+				KProofInfinity);
+		const TUint32 childThDelta = Min(aThPhi, secondDelta + 1);
+		Play(child.iIndex, aToMove);
+		Mid(aDepth + 1, enemyColor, childThPhi, childThDelta, child.iPhi,
+				child.iDelta);
+		Undo();
+		}
+	if (aPhi == 0)
+		{
+		// Proven for the player to move by the best child
+		iOrdering->RecordCutoff(aDepth, aToMove, children[best].iIndex, best,
+				KProofMaxDepth - aDepth);
+		}
+	Store(aToMove, aPhi, aDelta);
+	}
+
+TInt CGomokuProofSolver::GenerateMoves(TInt aDepth, eCellColor aToMove,
+		TUint32& aPhi, TUint32& aDelta)
+	{
+	const TInt numCells = iBoard->NumCells();
+	if (iBoard->RemainingFreeCells() == 0)
+		{
+		// Full board: draw.
+		SetAttackerFailed(aToMove, aPhi, aDelta);
+		return 0;
+		}
+	TChild* children = iChildren + aDepth * numCells;
+	TInt numChildren = 0;
+
+	if (iBoard->RemainingFreeCells() == numCells)
+		{
+		// Empty board: only the center is interesting.
+		children[0].iIndex = iBoard->Index(iBoard->Cols() / 2,
+				iBoard->Rows() / 2);
+		numChildren = 1;
+		}
+	else
+		{
+		// Collect all free cells close to any stone.
+		ResetMarks();
+		for (TInt pos = 0; pos < numCells; pos++)
+			{
+			if (iBoard->CellAt(pos) == EColorNeutral)
+				{
+				continue;
+				}
+			const TInt stoneX = pos % iBoard->Cols();
+			const TInt stoneY = pos / iBoard->Cols();
+			for (TInt y = stoneY - iRadius; y <= stoneY + iRadius; y++)
+				{
+				for (TInt x = stoneX - iRadius; x <= stoneX + iRadius; x++)
+					{
+					if (iBoard->IsInside(x, y) && iBoard->Cell(x, y)
+							== EColorNeutral && Mark(iBoard->Index(x, y)))
+						{
+						iOrderedMoves[numChildren++] = iBoard->Index(x, y);
+						}
+					}
+				}
+			}
+		// Most promising moves first: wins and blocks are found right away,
+		// and children with equal numbers are searched in this order.
+		iOrdering->OrderMoves(*iBoard, aDepth, aToMove, -1, iOrderedMoves,
+				numChildren);
+		for (TInt i = 0; i < numChildren; i++)
+			{
+			children[i].iIndex = iOrderedMoves[i];
+			}
+		}
+
+	// Does any move win right now? Otherwise get the numbers of the children.
+	const eCellColor enemyColor = CGomokuBoard::Opponent(aToMove);
+	TInt i;
+	for (i = 0; i < numChildren; i++)
+		{
+		TChild& child = children[i];
+		const TBool won = Play(child.iIndex, aToMove);
+		if (!won)
+			{
+			Lookup(enemyColor, child.iPhi, child.iDelta);
+			}
+		Undo();
+		if (won)
+			{
+			if (aDepth == 0)
+				{
+				iWinningMove = child.iIndex;
+				}
+			aPhi = 0;
+			aDelta = KProofInfinity;
+			return 0;
+			}
+		}
+
+	// If the opponent could win with the next move, only blocking that move
+	// or capturing a pair can help. All other moves lose immediately.
+	ResetMarks();
+	TInt numThreats = 0;
+	for (i = 0; i < numChildren; i++)
+		{
+		const TBool threat = Play(children[i].iIndex, enemyColor);
+		Undo();
+		if (threat)
+			{
+			Mark(children[i].iIndex);
+			numThreats++;
+			}
+		}
+	if (numThreats > 0)
+		{
+		TInt numDefences = 0;
+		for (i = 0; i < numChildren; i++)
+			{
+			const TInt index = children[i].iIndex;
+			if (!Mark(index) || (iPairCheck && iBoard->CapturesPair(index
+					% iBoard->Cols(), index / iBoard->Cols(), aToMove)))
+				{
+				children[numDefences++] = children[i];
+				}
+			}
+		numChildren = numDefences;
+		if (numChildren == 0)
+			{
+			// Can't stop the opponent.
+			aPhi = KProofInfinity;
+			aDelta = 0;
+			}
+		}
+	return numChildren;
+	}
+
+void CGomokuProofSolver::SetAttackerFailed(eCellColor aToMove, TUint32& aPhi,
+		TUint32& aDelta) const
+	{
+	if (aToMove == iAttacker)
+		{
+		aPhi = KProofInfinity;
+		aDelta = 0;
+		}
+	else
+		{
+		aPhi = 0;
+		aDelta = KProofInfinity;
+		}
+	}
+
+void CGomokuProofSolver::ResetMarks()
+	{
+	iMarkGeneration++;
+	if (iMarkGeneration == 0)
+		{
+		// Overflow - clear all marks of earlier generations.
+		Mem::FillZ(iMarks, iBoard->NumCells() * sizeof(TUint32));
+		iMarkGeneration = 1;
+		}
+	}
+
+TBool CGomokuProofSolver::Play(TInt aIndex, eCellColor aColor)
+	{
+	const TInt moveNumber = iBoard->MoveCount();
+	iKeyHistory[moveNumber * 2] = iKey;
+	iKeyHistory[moveNumber * 2 + 1] = iKeyLock;
+
+	const TInt x = aIndex % iBoard->Cols();
+	const TInt y = aIndex / iBoard->Cols();
+	const TInt numPairs = iBoard->MakeMove(x, y, aColor, iPairCheck);
+	HashStone(aIndex, aColor);
+	const eCellColor enemyColor = CGomokuBoard::Opponent(aColor);
+	for (TInt i = 0; i < numPairs * 2; i++)
+		{
+		HashStone(iBoard->LastCapturedCell(i), enemyColor);
+		}
+	return iBoard->IsFive(x, y, aColor) || (iPairCheck
+			&& iBoard->CapturedPairs(aColor) >= iNumPairsWin);
+	}
+
+void CGomokuProofSolver::Undo()
+	{
+	iBoard->UndoMove();
+	const TInt moveNumber = iBoard->MoveCount();
+	iKey = iKeyHistory[moveNumber * 2];
+	iKeyLock = iKeyHistory[moveNumber * 2 + 1];
+	}
+
+void CGomokuProofSolver::HashPosition(eCellColor aToMove, TUint32& aIndex,
+		TUint32& aLock) const
+	{
+	// The same stones with different captured pairs or a different player
+	// to move are a different position.
+	const TUint32 pairs1 = iBoard->CapturedPairs(EColor1);
+	const TUint32 pairs2 = iBoard->CapturedPairs(EColor2);
+	const TUint32 side = (aToMove == EColor2) ? 1 : 0;
+	aIndex = (iKey ^ (pairs1 * 0x9E3779B1) ^ (pairs2 * 0x85EBCA77) ^ (side
+			* 0xC2B2AE3D)) & (iHashSize - 1);
+	// 0 marks an empty entry.
+	aLock = (iKeyLock ^ (pairs1 * 0x27D4EB2F) ^ (pairs2 * 0x165667B1) ^ (side
+			* 0xD3A2646C)) | 1;
+	}
+
+void CGomokuProofSolver::Lookup(eCellColor aToMove, TUint32& aPhi,
+		TUint32& aDelta) const
+	{
+	TUint32 index, lock;
+	HashPosition(aToMove, index, lock);
+	const THashEntry& entry = iHash[index];
+	if (entry.iLock == lock)
+		{
+		aPhi = entry.iPhi;
+		aDelta = entry.iDelta;
+		}
+	else
+		{
+		aPhi = 1;
+		aDelta = 1;
+		}
+	}
+
+void CGomokuProofSolver::Store(eCellColor aToMove, TUint32 aPhi, TUint32 aDelta)
+	{
+	TUint32 index, lock;
+	HashPosition(aToMove, index, lock);
+	THashEntry& entry = iHash[index];
+	if (entry.iLock == 0)
+		{
+		iHashUsed++;
+		}
+	entry.iLock = lock;
+	entry.iPhi = aPhi;
+	entry.iDelta = aDelta;
+	}
+
+void CGomokuProofSolver::ReportProgress()
+	{
+	if (iObserver)
+		{
+		TGomokuProofProgress progress;
+		progress.iRun = iRun;
+		progress.iNodes = iNodes;
+		progress.iProof = iRootProof;
+		progress.iDisproof = iRootDisproof;
+		progress.iHashUsed = iHashUsed;
+		iObserver->HandleProofProgress(progress);
+		}
+	}
@@ -0,0 +1,488 @@
+/*
+ ============================================================================
+ Name		 : GomokuProofSolver.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Depth-first proof-number search (df-pn) that proves
+               positions won, lost or drawn.
+ ============================================================================
+ */
+
+#ifndef GOMOKUPROOFSOLVER_H_
+#define GOMOKUPROOFSOLVER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuMoveOrdering.h"
+
+/**
+ * Proof and disproof numbers of solved positions.
+ * Sums of proof numbers are limited to values below.
+ */
+const TUint32 KProofInfinity = 100000000;
+
+/**
+ * Maximum number of plies below the root position.
+ * The search is recursive, so this also limits the stack usage.
+ */
+const TInt KProofMaxDepth = 40;
+
+/**
+ * Default number of entries of the hash table (12 bytes each).
+ */
+const TInt KProofDefaultHashEntries = 1 << 16;
+
+/**
+ * Default number of positions that may be visited by one call to Solve().
+ */
+const TInt KProofDefaultNodeBudget = 200000;
+
+/**
+ * Default distance of candidate moves to the closest stone.
+ */
+const TInt KProofDefaultRadius = 2;
+
+/**
+ * Number of visited positions between two progress reports.
+ */
+const TInt KProofProgressInterval = 5000;
+
+/**
+ * Result of a proof search, seen from the player to move.
+ */
+enum TGomokuProofResult
+	{
+	EProofUnknown,
+	EProofWon,
+	EProofLost,
+	EProofDrawn
+	};
+
+/**
+ * State of a running proof search, sent to the observer.
+ */
+class TGomokuProofProgress
+	{
+public:
+	/**
+	 * 0 while proving a win of the player to move,
+	 * 1 while proving a win of the opponent.
+	 */
+	TInt iRun;
+
+	/**
+	 * Positions visited in the current call to Solve().
+	 */
+	TInt iNodes;
+
+	/**
+	 * Proof number of the root position for the current run.
+	 */
+	TUint32 iProof;
+
+	/**
+	 * Disproof number of the root position for the current run.
+	 */
+	TUint32 iDisproof;
+
+	/**
+	 * Number of used hash table entries.
+	 */
+	TInt iHashUsed;
+	};
+
+/**
+ * Interface to receive the progress of a running proof search.
+ */
+class MGomokuProofObserver
+	{
+public:
+	/**
+	 * Called every KProofProgressInterval positions and once when a run
+	 * has finished.
+	 */
+	virtual void HandleProofProgress(const TGomokuProofProgress& aProgress) = 0;
+	};
+
+// CLASS DECLARATION
+
+/**
+ * Solves positions with depth-first proof-number search.
+ *
+ * Proof-number search expands the position that is cheapest to prove or
+ * disprove, which works very well for games like Gomoku where most
+ * lines end quickly with a five. The proof and disproof numbers are stored
+ * in a hash table with a fixed number of entries, old entries are simply
+ * overwritten.
+ *
+ * As the search can only answer yes/no questions, Solve() runs twice:
+ * 1. Can the player to move force a win? If yes -> won.
+ * 2. Can the opponent force a win? If yes -> lost, otherwise -> drawn.
+ *
+ * The rules are the same as in CGrid, including the pair check: a move
+ * also wins if it captures the required number of pairs.
+ *
+ * Only free cells close to existing stones are searched (see SetLimits()),
+ * results are only exact if the radius covers the whole grid.
+ * If the opponent threatens to win with the next move, only moves that
+ * block the threat or capture a pair are searched, which keeps the tree
+ * small without losing exactness.
+ *
+ * The moves of every position are sorted by CGomokuMoveOrdering. Children
+ * with equal numbers are searched in this order, and a move that proves
+ * a position is remembered as killer move and in the history.
+ *
+ * The search is synchronous and intended for offline use (verifying opening
+ * lines, labeling positions). Use the node budget to limit the time.
+ */
+class CGomokuProofSolver : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuProofSolver();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuProofSolver* NewL();
+
+public:
+	/**
+	 * Prepare the solver for positions of the specified game.
+	 *
+	 * \param aGridSize size of the grid.
+	 * \param aPairCheck ETrue if pair check is activated.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 * \param aHashEntries number of entries of the hash table.
+	 */
+	void InitL(TSize aGridSize, TBool aPairCheck, TInt aNumPairsWin,
+			TInt aHashEntries = KProofDefaultHashEntries);
+
+	/**
+	 * Limit the search.
+	 *
+	 * \param aNodeBudget maximum number of visited positions per call to Solve().
+	 * \param aRadius only free cells within this distance to any stone are
+	 * searched. Use the size of the grid to search all free cells.
+	 */
+	void SetLimits(TInt aNodeBudget, TInt aRadius);
+
+	/**
+	 * Set the observer that receives the progress of the search.
+	 * \param aObserver observer or NULL. Ownership is not transferred.
+	 */
+	void SetObserver(MGomokuProofObserver* aObserver);
+
+	/**
+	 * Solve the position for the player to move.
+	 * Does not modify the grid.
+	 *
+	 * \param aGrid position to solve.
+	 * \param aToMove color of the player to move.
+	 * \param aCapturedPairsToMove pairs that the player to move has already captured.
+	 * \param aCapturedPairsOpponent pairs that the opponent has already captured.
+	 * \return EProofUnknown if the node budget was not sufficient.
+	 */
+	TGomokuProofResult Solve(const CGrid* aGrid, eCellColor aToMove,
+			TInt aCapturedPairsToMove = 0, TInt aCapturedPairsOpponent = 0);
+
+	/**
+	 * A winning move of the player to move, if the last call to Solve()
+	 * returned EProofWon.
+	 */
+	TPoint WinningMove() const;
+
+	/**
+	 * Number of positions visited by the last call to Solve().
+	 */
+	TInt NodesSearched() const;
+
+	/**
+	 * Percentage of the positions proven by the last call to Solve() where
+	 * the first move of the ordered list was the proving move.
+	 */
+	TInt FirstMoveCutoffRate() const;
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuProofSolver();
+
+	/**
+	 * Delete all arrays owned by the solver.
+	 */
+	void DeleteArrays();
+
+	/**
+	 * Prove a win of iAttacker on the current board.
+	 * \param aRun number of the run, for progress reports.
+	 * \param aAttackerToMove ETrue if the attacker is the player to move.
+	 * \return ETrue if proven, EFalse if disproven or out of budget
+	 * (check iAborted).
+	 */
+	TBool ProveWin(TInt aRun, TBool aAttackerToMove);
+
+	/**
+	 * Multiple iterative deepening: search the position until its phi or
+	 * delta number reaches the threshold.
+	 *
+	 * phi is the proof number of the player to move, delta its disproof number.
+	 * \param aDepth plies below the root.
+	 * \param aToMove color of the player to move.
+	 * \param aThPhi threshold for phi.
+	 * \param aThDelta threshold for delta.
+	 * \param aPhi receives phi of the position.
+	 * \param aDelta receives delta of the position.
+	 */
+	void Mid(TInt aDepth, eCellColor aToMove, TUint32 aThPhi, TUint32 aThDelta,
+			TUint32& aPhi, TUint32& aDelta);
+
+	/**
+	 * Create the moves of the current position in the buffer of the depth.
+	 * Solves the position instead if the player to move wins right now,
+	 * or if the game has ended.
+	 * \return number of moves, 0 if solved (aPhi and aDelta are set).
+	 */
+	TInt GenerateMoves(TInt aDepth, eCellColor aToMove, TUint32& aPhi,
+			TUint32& aDelta);
+
+	/**
+	 * Result of a position that can not be searched any further
+	 * (full board or too deep): the attacker did not manage to win.
+	 */
+	void SetAttackerFailed(eCellColor aToMove, TUint32& aPhi, TUint32& aDelta) const;
+
+	/**
+	 * Start a new set of collected cells, every cell can be added once.
+	 */
+	void ResetMarks();
+
+	/**
+	 * Mark the cell as collected.
+	 * \return ETrue if the cell was not marked before.
+	 */
+	inline TBool Mark(TInt aIndex);
+
+	/**
+	 * Place a stone and update the hash keys.
+	 * \return ETrue if this move wins the game for aColor.
+	 */
+	TBool Play(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Take back the last move and restore the hash keys.
+	 */
+	void Undo();
+
+	/**
+	 * Toggle a stone of the specified color in the hash keys.
+	 */
+	inline void HashStone(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Index and lock of the current position in the hash table.
+	 */
+	void HashPosition(eCellColor aToMove, TUint32& aIndex, TUint32& aLock) const;
+
+	/**
+	 * Get phi and delta of the current position from the hash table.
+	 * New positions start with 1 / 1.
+	 */
+	void Lookup(eCellColor aToMove, TUint32& aPhi, TUint32& aDelta) const;
+
+	/**
+	 * Store phi and delta of the current position in the hash table.
+	 */
+	void Store(eCellColor aToMove, TUint32 aPhi, TUint32 aDelta);
+
+	/**
+	 * Send the current state to the observer.
+	 */
+	void ReportProgress();
+
+private:
+	/**
+	 * One entry of the hash table.
+	 */
+	struct THashEntry
+		{
+		/** Second hash key to verify the position, 0 = empty. */
+		TUint32 iLock;
+		TUint32 iPhi;
+		TUint32 iDelta;
+		};
+
+	/**
+	 * A move of a searched position, with the numbers of the child position.
+	 */
+	struct TChild
+		{
+		TInt iIndex;
+		TUint32 iPhi;
+		TUint32 iDelta;
+		};
+
+	/**
+	 * Board that the search is performed on.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * Moves of every search depth, NumCells() entries per depth.
+	 */
+	TChild* iChildren;
+
+	/**
+	 * Sorts the moves of every position. Owned by this class.
+	 */
+	CGomokuMoveOrdering* iOrdering;
+
+	/**
+	 * Moves of the position that is sorted, NumCells() entries.
+	 */
+	TInt* iOrderedMoves;
+
+	/**
+	 * Hash table with the proof numbers of visited positions.
+	 */
+	THashEntry* iHash;
+
+	/**
+	 * Number of hash table entries (power of 2).
+	 */
+	TUint32 iHashSize;
+
+	/**
+	 * Number of used hash table entries.
+	 */
+	TInt iHashUsed;
+
+	/**
+	 * Random numbers for every cell and color, index and lock keys.
+	 */
+	TUint32* iZobrist;
+
+	/**
+	 * Hash index key of the stones on the board.
+	 */
+	TUint32 iKey;
+
+	/**
+	 * Hash lock key of the stones on the board.
+	 */
+	TUint32 iKeyLock;
+
+	/**
+	 * Hash keys before every move made on the board, to restore them in Undo().
+	 */
+	TUint32 iKeyHistory[(KProofMaxDepth + 1) * 2];
+
+	/**
+	 * Generation number for every cell, used to collect each cell only once.
+	 */
+	TUint32* iMarks;
+
+	/**
+	 * Current generation of iMarks.
+	 */
+	TUint32 iMarkGeneration;
+
+	/**
+	 * Color trying to prove a win in the current run.
+	 */
+	eCellColor iAttacker;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Number of captured pairs required for winning a game.
+	 */
+	TInt iNumPairsWin;
+
+	/**
+	 * Maximum number of positions per call to Solve().
+	 */
+	TInt iNodeBudget;
+
+	/**
+	 * Distance of candidate moves to the closest stone.
+	 */
+	TInt iRadius;
+
+	/**
+	 * Positions visited by the current call to Solve().
+	 */
+	TInt iNodes;
+
+	/**
+	 * ETrue if the node budget is used up.
+	 */
+	TBool iAborted;
+
+	/**
+	 * ETrue if a position was not searched because of KProofMaxDepth.
+	 * Disproofs are not exact then.
+	 */
+	TBool iDepthLimitHit;
+
+	/**
+	 * Number of the current run, for progress reports.
+	 */
+	TInt iRun;
+
+	/**
+	 * Proof number of the root position (for the attacker).
+	 */
+	TUint32 iRootProof;
+
+	/**
+	 * Disproof number of the root position (for the attacker).
+	 */
+	TUint32 iRootDisproof;
+
+	/**
+	 * Winning move found by the last call to Solve(), -1 if none.
+	 */
+	TInt iWinningMove;
+
+	/**
+	 * Receives the progress of the search. Not owned.
+	 */
+	MGomokuProofObserver* iObserver;
+	};
+
+inline void CGomokuProofSolver::HashStone(TInt aIndex, eCellColor aColor)
+	{
+	const TInt key = (aIndex * 2 + (aColor - EColor1)) * 2;
+	iKey ^= iZobrist[key];
+	iKeyLock ^= iZobrist[key + 1];
+	}
+
+inline TBool CGomokuProofSolver::Mark(TInt aIndex)
+	{
+	if (iMarks[aIndex] == iMarkGeneration)
+		{
+		return EFalse;
+		}
+	iMarks[aIndex] = iMarkGeneration;
+	return ETrue;
+	}
+
+#endif /*GOMOKUPROOFSOLVER_H_*/
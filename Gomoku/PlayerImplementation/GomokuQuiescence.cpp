@@ -0,0 +1,313 @@
+/*
+ ============================================================================
+ Name		 : GomokuQuiescence.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuQuiescence implementation
+ ============================================================================
+ */
+
+#include "GomokuQuiescence.h"
+#include "GomokuMoveOrdering.h"
+
+CGomokuQuiescence::CGomokuQuiescence() :
+	iMaxDepth(KQuiescenceDefaultDepth), iThreeDepth(
+			KQuiescenceDefaultThreeDepth), iNodeBudget(
+			KQuiescenceDefaultNodeBudget)
+	{
+	// No implementation required
+	}
+
+CGomokuQuiescence::~CGomokuQuiescence()
+	{
+	delete iBoard;
+	DeleteArrays();
+	}
+
+CGomokuQuiescence* CGomokuQuiescence::NewL()
+	{
+	CGomokuQuiescence* self = new (ELeave) CGomokuQuiescence();
+	CleanupStack::PushL(self);
+	self->iBoard = CGomokuBoard::NewL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuQuiescence::InitL(TSize aGridSize, TBool aPairCheck,
+		TInt aNumPairsWin)
+	{
+	iPairCheck = aPairCheck;
+	iNumPairsWin = aNumPairsWin;
+	iBoard->ResizeL(aGridSize);
+	DeleteArrays();
+	const TInt numCells = iBoard->NumCells();
+	iMoveBuffer = new (ELeave) TInt[numCells * (KQuiescenceMaxDepth + 1)];
+	iScores = new (ELeave) TInt[numCells];
+	ResetStatistics();
+	}
+
+void CGomokuQuiescence::SetLimits(TInt aMaxDepth, TInt aThreeDepth,
+		TInt aNodeBudget)
+	{
+	iMaxDepth = Min(aMaxDepth, KQuiescenceMaxDepth);
+	iThreeDepth = aThreeDepth;
+	iNodeBudget = aNodeBudget;
+	}
+
+void CGomokuQuiescence::SetNnue(CGomokuNnue* aNnue)
+	{
+	iNnue = aNnue;
+	}
+
+TInt CGomokuQuiescence::Evaluate(const CGrid* aGrid, eCellColor aLastMover,
+		TGomokuLineEvaluator& aEvaluator, TInt aCapturedPairsLastMover,
+		TInt aCapturedPairsOpponent)
+	{
+	iEvaluator = &aEvaluator;
+	iBoard->CopyFrom(aGrid);
+	// The grid doesn't know the captured pairs, without them the search
+	// can't recognise wins by capturing.
+	iBoard->SetCapturedPairs(aLastMover, aCapturedPairsLastMover);
+	iBoard->SetCapturedPairs(CGomokuBoard::Opponent(aLastMover),
+			aCapturedPairsOpponent);
+	if (iNnue)
+		{
+		iNnue->Refresh(aGrid);
+		}
+	iSearchNodes = 0;
+	const TInt rating = -Search(CGomokuBoard::Opponent(aLastMover),
+			-KQuiescenceWin, KQuiescenceWin, 0);
+	if (iSearchNodes > 1)
+		{
+		iExtendedPositions++;
+		}
+	return rating;
+	}
+
+void CGomokuQuiescence::ResetStatistics()
+	{
+	iNodes = 0;
+	iExtendedPositions = 0;
+	iMaxPly = 0;
+	}
+
+TInt CGomokuQuiescence::Nodes() const
+	{
+	return iNodes;
+	}
+
+TInt CGomokuQuiescence::ExtendedPositions() const
+	{
+	return iExtendedPositions;
+	}
+
+TInt CGomokuQuiescence::MaxPly() const
+	{
+	return iMaxPly;
+	}
+
+void CGomokuQuiescence::DeleteArrays()
+	{
+	delete[] iMoveBuffer;
+	iMoveBuffer = NULL;
+	delete[] iScores;
+	iScores = NULL;
+	}
+
+TInt CGomokuQuiescence::Search(eCellColor aToMove, TInt aAlpha, TInt aBeta,
+		TInt aPly)
+	{
+	iNodes++;
+	iSearchNodes++;
+	if (aPly > iMaxPly)
+		{
+		iMaxPly = aPly;
+		}
+	const eCellColor opponent = CGomokuBoard::Opponent(aToMove);
+	TInt* moves = iMoveBuffer + aPly * iBoard->NumCells();
+	TBool win = EFalse;
+	TBool mustBlock = EFalse;
+	const TInt numMoves = GenerateMoves(aToMove, aPly, moves, win, mustBlock);
+	if (win)
+		{
+		return KQuiescenceWin - aPly - 1;
+		}
+
+	// The board is rated for the player that just moved.
+	if (aPly >= iMaxDepth || iSearchNodes >= iNodeBudget || (numMoves == 0
+			&& !mustBlock))
+		{
+		return -Rate(opponent);
+		}
+
+	TInt best;
+	if (mustBlock)
+		{
+		// No stand pat: if no block works, the opponent completes five.
+		best = -KQuiescenceWin + aPly + 2;
+		}
+	else
+		{
+		best = -Rate(opponent);
+		if (best >= aBeta)
+			{
+			return best;
+			}
+		}
+	TInt alpha = Max(aAlpha, best);
+
+	for (TInt i = 0; i < numMoves; i++)
+		{
+		TInt rating;
+		if (Play(moves[i], aToMove))
+			{
+			// Won by capturing enough pairs.
+			rating = KQuiescenceWin - aPly - 1;
+			}
+		else
+			{
+			rating = -Search(opponent, -aBeta, -alpha, aPly + 1);
+			}
+		Undo();
+		if (rating > best)
+			{
+			best = rating;
+			if (best >= aBeta)
+				{
+				break;
+				}
+			alpha = Max(alpha, best);
+			}
+		}
+	return best;
+	}
+
+TInt CGomokuQuiescence::GenerateMoves(eCellColor aToMove, TInt aPly,
+		TInt* aMoves, TBool& aWin, TBool& aMustBlock)
+	{
+	const eCellColor opponent = CGomokuBoard::Opponent(aToMove);
+	const TInt openThree = (aPly < iThreeDepth) ? KOrderOpenThree : 0;
+	TInt numMoves = 0;
+	for (TInt y = 0; y < iBoard->Rows(); y++)
+		{
+		for (TInt x = 0; x < iBoard->Cols(); x++)
+			{
+			if (iBoard->Cell(x, y) != EColorNeutral || !IsNearStone(x, y))
+				{
+				continue;
+				}
+			TInt score = CGomokuMoveOrdering::ScoreLines(*iBoard, x, y,
+					aToMove, KOrderWin, KOrderFour, openThree);
+			if (score == KOrderWin)
+				{
+				aWin = ETrue;
+				return 0;
+				}
+			if (CGomokuMoveOrdering::ScoreLines(*iBoard, x, y, opponent,
+					KOrderBlockWin, 0, 0) == KOrderBlockWin)
+				{
+				aMustBlock = ETrue;
+				score = KOrderBlockWin;
+				}
+			else if (iPairCheck && iBoard->CapturesPair(x, y, aToMove))
+				{
+				score = Max(score, KOrderCapture);
+				}
+			if (score > 0)
+				{
+				aMoves[numMoves] = iBoard->Index(x, y);
+				iScores[numMoves] = score;
+				numMoves++;
+				}
+			}
+		}
+
+	if (aMustBlock)
+		{
+		// Own threats don't help against a five, only blocks and captures.
+		TInt numBlocks = 0;
+		for (TInt i = 0; i < numMoves; i++)
+			{
+			const TInt x = aMoves[i] % iBoard->Cols();
+			const TInt y = aMoves[i] / iBoard->Cols();
+			if (iScores[i] == KOrderBlockWin || (iPairCheck
+					&& iBoard->CapturesPair(x, y, aToMove)))
+				{
+				aMoves[numBlocks] = aMoves[i];
+				iScores[numBlocks] = iScores[i];
+				numBlocks++;
+				}
+			}
+		numMoves = numBlocks;
+		}
+
+	// Insertion sort, the strongest threat first.
+	for (TInt i = 1; i < numMoves; i++)
+		{
+		const TInt move = aMoves[i];
+		const TInt score = iScores[i];
+		TInt j = i;
+		while (j > 0 && iScores[j - 1] < score)
+			{
+			aMoves[j] = aMoves[j - 1];
+			iScores[j] = iScores[j - 1];
+			j--;
+			}
+		aMoves[j] = move;
+		iScores[j] = score;
+		}
+	return numMoves;
+	}
+
+TBool CGomokuQuiescence::IsNearStone(TInt aX, TInt aY) const
+	{
+	for (TInt y = aY - 1; y <= aY + 1; y++)
+		{
+		for (TInt x = aX - 1; x <= aX + 1; x++)
+			{
+			if (iBoard->IsInside(x, y) && iBoard->Cell(x, y) != EColorNeutral)
+				{
+				return ETrue;
+				}
+			}
+		}
+	return EFalse;
+	}
+
+TBool CGomokuQuiescence::Play(TInt aIndex, eCellColor aColor)
+	{
+	const TInt x = aIndex % iBoard->Cols();
+	const TInt y = aIndex / iBoard->Cols();
+	const TInt pairs = iBoard->MakeMove(x, y, aColor, iPairCheck);
+	if (iNnue)
+		{
+		iNnue->MakeMove(aIndex, aColor);
+		for (TInt i = 0; i < 2 * pairs; i++)
+			{
+			iNnue->RemoveStone(iBoard->LastCapturedCell(i),
+					CGomokuBoard::Opponent(aColor));
+			}
+		}
+	return iBoard->IsFive(x, y, aColor) || (iPairCheck
+			&& iBoard->CapturedPairs(aColor) >= iNumPairsWin);
+	}
+
+void CGomokuQuiescence::Undo()
+	{
+	iBoard->UndoMove();
+	if (iNnue)
+		{
+		iNnue->UndoMove();
+		}
+	}
+
+TInt CGomokuQuiescence::Rate(eCellColor aLastMover)
+	{
+	return iNnue ? iNnue->Evaluate(aLastMover) : iEvaluator->Evaluate(*iBoard,
+			aLastMover);
+	}
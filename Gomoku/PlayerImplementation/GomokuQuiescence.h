@@ -0,0 +1,301 @@
+/*
+ ============================================================================
+ Name		 : GomokuQuiescence.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Quiescence search: rates a position only after the forcing
+               moves (fives, fours, open threes and captures) are played out.
+ ============================================================================
+ */
+
+#ifndef GOMOKUQUIESCENCE_H_
+#define GOMOKUQUIESCENCE_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+#include "GomokuLineEvaluator.h"
+#include "GomokuNnue.h"
+
+/**
+ * Maximum number of plies of the quiescence search.
+ */
+const TInt KQuiescenceMaxDepth = 8;
+
+/**
+ * Default number of plies of the quiescence search.
+ */
+const TInt KQuiescenceDefaultDepth = 4;
+
+/**
+ * By default, open threes are only forcing moves in the first 2 plies,
+ * deeper only fours, captures and blocks of a five are searched.
+ */
+const TInt KQuiescenceDefaultThreeDepth = 2;
+
+/**
+ * Default number of positions that may be visited for one position.
+ */
+const TInt KQuiescenceDefaultNodeBudget = 200;
+
+/**
+ * Rating of a won position, minus the number of plies to the win.
+ * Far higher than the rating of any board.
+ */
+const TInt KQuiescenceWin = 1000000;
+
+// CLASS DECLARATION
+
+/**
+ * Extends the rating of a position by the forcing moves that follow it.
+ *
+ * A search that stops at a fixed depth rates the board in the middle of
+ * a fight: the opponent might have an open three that becomes an open four
+ * with the next move, or might capture a pair that breaks the own four.
+ * The static rating can't see this (horizon effect).
+ *
+ * The quiescence search only plays forcing moves on top of the rated
+ * position, with alpha-beta pruning:
+ * - a move that completes five wins immediately,
+ * - if the opponent could complete five, only its blocks (and, with pair
+ *   check, captures that might break the five) are searched and the player
+ *   can't stop in this position,
+ * - otherwise, the player can either accept the static rating of the
+ *   position ("stand pat"), or make a four, an open three (only in the first
+ *   plies, see SetLimits()) or capture a pair.
+ * Positions without forcing moves are rated exactly like before, so
+ * a quiet position gets its static rating.
+ *
+ * The board is rated by the line evaluator of the AI (or the neural network,
+ * see SetNnue()), from the point of view of the player that made the last
+ * move (the enemy moves next).
+ * The moves are ordered by the threat they make: fives, fours, threes,
+ * captures.
+ */
+class CGomokuQuiescence : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuQuiescence();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuQuiescence* NewL();
+
+public:
+	/**
+	 * Prepare the search for a new game.
+	 *
+	 * \param aGridSize size of the grid used in the game.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 */
+	void InitL(TSize aGridSize, TBool aPairCheck, TInt aNumPairsWin);
+
+	/**
+	 * Limit the search.
+	 *
+	 * \param aMaxDepth maximum number of plies (up to KQuiescenceMaxDepth).
+	 * \param aThreeDepth open threes are only forcing moves in this
+	 * number of plies.
+	 * \param aNodeBudget maximum number of visited positions per call
+	 * of Evaluate().
+	 */
+	void SetLimits(TInt aMaxDepth, TInt aThreeDepth, TInt aNodeBudget);
+
+	/**
+	 * Rate the positions with a neural network instead of the line
+	 * evaluator. Its accumulators are updated with the moves of the search.
+	 *
+	 * \param aNnue the network, NULL to use the line evaluator. Not owned,
+	 * has to support the grid size.
+	 */
+	void SetNnue(CGomokuNnue* aNnue);
+
+	/**
+	 * Rate the position after the forcing moves.
+	 * Does not modify the grid.
+	 *
+	 * \param aGrid the position to rate.
+	 * \param aLastMover color of the player that made the last move,
+	 * the other player moves next.
+	 * \param aEvaluator rates the positions. Its size has to support the grid.
+	 * \param aCapturedPairsLastMover pairs that aLastMover has captured,
+	 * including the ones of the last move.
+	 * \param aCapturedPairsOpponent pairs that the other player has captured.
+	 * \return the rating from the point of view of aLastMover, the higher
+	 * the better. Close to +/- KQuiescenceWin if a player wins by force.
+	 */
+	TInt Evaluate(const CGrid* aGrid, eCellColor aLastMover,
+			TGomokuLineEvaluator& aEvaluator, TInt aCapturedPairsLastMover = 0,
+			TInt aCapturedPairsOpponent = 0);
+
+	/**
+	 * Set the number of visited positions back to 0.
+	 */
+	void ResetStatistics();
+
+	/**
+	 * Number of positions visited since the statistics were reset,
+	 * including the rated positions themselves.
+	 */
+	TInt Nodes() const;
+
+	/**
+	 * Number of positions rated by Evaluate() since the statistics were
+	 * reset that were not quiet, i.e. where forcing moves were searched.
+	 */
+	TInt ExtendedPositions() const;
+
+	/**
+	 * Highest ply reached since the statistics were reset, 0 if only the
+	 * rated positions themselves were visited.
+	 */
+	TInt MaxPly() const;
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuQuiescence();
+
+	/**
+	 * Delete all arrays owned by the search.
+	 */
+	void DeleteArrays();
+
+	/**
+	 * Alpha-beta search over the forcing moves.
+	 *
+	 * \param aToMove color of the player to move.
+	 * \param aAlpha the player has already found a line with this rating.
+	 * \param aBeta the opponent has already found a line that limits the
+	 * rating of the player to this value.
+	 * \param aPly distance to the rated position.
+	 * \return the rating from the point of view of aToMove.
+	 */
+	TInt Search(eCellColor aToMove, TInt aAlpha, TInt aBeta, TInt aPly);
+
+	/**
+	 * Collect the forcing moves of the player, the best ones first.
+	 *
+	 * \param aToMove color of the player to move.
+	 * \param aPly distance to the rated position.
+	 * \param aMoves receives the positions of the moves in the cell array.
+	 * \param aWin set to ETrue if a move completes five. No moves are
+	 * collected in this case.
+	 * \param aMustBlock set to ETrue if the opponent could complete five.
+	 * Only blocks and captures are collected in this case.
+	 * \return number of moves.
+	 */
+	TInt GenerateMoves(eCellColor aToMove, TInt aPly, TInt* aMoves,
+			TBool& aWin, TBool& aMustBlock);
+
+	/**
+	 * Check if a stone is next to the cell. Threats only arise next to
+	 * existing stones.
+	 */
+	TBool IsNearStone(TInt aX, TInt aY) const;
+
+	/**
+	 * Place a stone on the search board.
+	 * \return ETrue if this move wins the game for aColor.
+	 */
+	TBool Play(TInt aIndex, eCellColor aColor);
+
+	/**
+	 * Take back the last move made through Play().
+	 */
+	void Undo();
+
+	/**
+	 * Static rating of the board for the player that made the last move.
+	 */
+	TInt Rate(eCellColor aLastMover);
+
+private:
+	/**
+	 * Board that the search is performed on.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * Rates the positions, not owned.
+	 */
+	TGomokuLineEvaluator* iEvaluator;
+
+	/**
+	 * Rates the positions instead of iEvaluator if not NULL, not owned.
+	 */
+	CGomokuNnue* iNnue;
+
+	/**
+	 * Memory for the moves of every ply.
+	 */
+	TInt* iMoveBuffer;
+
+	/**
+	 * Order scores of the moves while they are collected.
+	 */
+	TInt* iScores;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Number of captured pairs required for winning a game.
+	 */
+	TInt iNumPairsWin;
+
+	/**
+	 * Maximum number of plies.
+	 */
+	TInt iMaxDepth;
+
+	/**
+	 * Number of plies in which open threes are forcing moves.
+	 */
+	TInt iThreeDepth;
+
+	/**
+	 * Maximum number of positions per call of Evaluate().
+	 */
+	TInt iNodeBudget;
+
+	/**
+	 * Positions visited by the current call of Evaluate().
+	 */
+	TInt iSearchNodes;
+
+	/**
+	 * Positions visited since the statistics were reset.
+	 */
+	TInt iNodes;
+
+	/**
+	 * Positions that were not quiet since the statistics were reset.
+	 */
+	TInt iExtendedPositions;
+
+	/**
+	 * Highest ply reached since the statistics were reset.
+	 */
+	TInt iMaxPly;
+	};
+
+#endif /*GOMOKUQUIESCENCE_H_*/
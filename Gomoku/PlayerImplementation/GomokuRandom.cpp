@@ -0,0 +1,47 @@
+/*
+ ============================================================================
+ Name		 : GomokuRandom.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : TGomokuRandom implementation
+ ============================================================================
+ */
+
+#include "GomokuRandom.h"
+
+TGomokuRandom::TGomokuRandom()
+	{
+	SetSeed(DefaultSeed());
+	}
+
+void TGomokuRandom::SetSeed(TUint64 aSeed)
+	{
+	// SplitMix64 never gives 0 twice in a row, so the state is never all 0.
+	TUint64 state = aSeed;
+	for (TInt i = 0; i < 4; i += 2)
+		{
+		state += UI64LIT(0x9E3779B97F4A7C15);
+		TUint64 mixed = state;
+		mixed = (mixed ^ (mixed >> 30)) * UI64LIT(0xBF58476D1CE4E5B9);
+		mixed = (mixed ^ (mixed >> 27)) * UI64LIT(0x94D049BB133111EB);
+		mixed ^= mixed >> 31;
+		iState[i] = (TUint32) mixed;
+		iState[i + 1] = (TUint32) (mixed >> 32);
+		}
+	}
+
+TUint64 TGomokuRandom::DefaultSeed()
+	{
+#ifdef GOMOKU_DETERMINISTIC_RANDOM
+	return KRandomDeterministicSeed;
+#else
+	TTime time;
+	time.HomeTime();
+	return (TUint64) time.Int64();
+#endif
+	}
@@ -0,0 +1,139 @@
+/*
+ ============================================================================
+ Name		 : GomokuRandom.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Fast random number generator with an explicit seed, so that
+               the games of the AIs can be reproduced.
+ ============================================================================
+ */
+
+#ifndef GOMOKURANDOM_H_
+#define GOMOKURANDOM_H_
+
+// INCLUDES
+#include <e32std.h>
+
+/**
+ * Seed of all generators if GOMOKU_DETERMINISTIC_RANDOM is defined.
+ */
+const TUint64 KRandomDeterministicSeed = UI64LIT(0x5EED0F60A0C0FFEE);
+
+// CLASS DECLARATION
+
+/**
+ * Random number generator of the AIs (xoshiro128**).
+ *
+ * Only needs 32 bit additions, shifts and multiplications, so it is much
+ * faster than Math::Rand() on the phone, and the state is small enough to
+ * give every worker thread its own generator. The 64 bit seed is spread
+ * over the state with SplitMix64, similar seeds give unrelated sequences.
+ *
+ * Every generator is seeded with DefaultSeed() when it is created: the
+ * current time, so that every game is different. The game engine passes
+ * a new seed to the AIs for every game (see
+ * CGomokuPlayerInterface::SetRandomSeed()) and prints it in debug builds.
+ * To reproduce a game (e.g. for benchmarks or to replay a bug), either set
+ * the seed of the AI with SetSeed(), or build with
+ * GOMOKU_DETERMINISTIC_RANDOM defined to seed all generators that aren't
+ * seeded by the engine with KRandomDeterministicSeed.
+ */
+class TGomokuRandom
+	{
+public:
+	/**
+	 * Constructor, seeds the generator with DefaultSeed().
+	 */
+	TGomokuRandom();
+
+	/**
+	 * Start the sequence of the seed. The same seed always gives the same
+	 * numbers.
+	 */
+	void SetSeed(TUint64 aSeed);
+
+	/**
+	 * \return the current time, or KRandomDeterministicSeed if
+	 * GOMOKU_DETERMINISTIC_RANDOM is defined.
+	 */
+	static TUint64 DefaultSeed();
+
+	/**
+	 * \return the next 32 random bits.
+	 */
+	inline TUint32 Next();
+
+	/**
+	 * A random number from 0 to aRange - 1, every number with the same
+	 * probability (unlike Next() % aRange).
+	 *
+	 * \param aRange number of possible results, greater than 0.
+	 */
+	inline TInt Next(TInt aRange);
+
+	/**
+	 * \return a seed for another generator, e.g. of a worker thread.
+	 */
+	inline TUint64 NextSeed();
+
+private:
+	/**
+	 * Rotate the bits of aValue to the left.
+	 */
+	static inline TUint32 RotateLeft(TUint32 aValue, TInt aBits);
+
+private:
+	/**
+	 * State of the generator, never all 0.
+	 */
+	TUint32 iState[4];
+	};
+
+inline TUint32 TGomokuRandom::RotateLeft(TUint32 aValue, TInt aBits)
+	{
+	return (aValue << aBits) | (aValue >> (32 - aBits));
+	}
+
+inline TUint32 TGomokuRandom::Next()
+	{
+	const TUint32 result = RotateLeft(iState[1] * 5, 7) * 9;
+	const TUint32 shifted = iState[1] << 9;
+	iState[2] ^= iState[0];
+	iState[3] ^= iState[1];
+	iState[1] ^= iState[2];
+	iState[0] ^= iState[3];
+	iState[2] ^= shifted;
+	iState[3] = RotateLeft(iState[3], 11);
+	return result;
+	}
+
+inline TInt TGomokuRandom::Next(TInt aRange)
+	{
+	// The high word of Next() * aRange is the result. Only the few values
+	// whose low word is below 2^32 mod aRange have to be drawn again, the
+	// (slow) division is only needed if that could be the case.
+	const TUint32 range = (TUint32) aRange;
+	TUint64 product = (TUint64) Next() * range;
+	if ((TUint32) product < range)
+		{
+		const TUint32 threshold = (0 - range) % range;
+		while ((TUint32) product < threshold)
+			{
+			product = (TUint64) Next() * range;
+			}
+		}
+	return (TInt) (product >> 32);
+	}
+
+inline TUint64 TGomokuRandom::NextSeed()
+	{
+	const TUint64 high = Next();
+	return (high << 32) | Next();
+	}
+
+#endif /*GOMOKURANDOM_H_*/
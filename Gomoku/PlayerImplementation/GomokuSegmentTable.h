@@ -0,0 +1,161 @@
+/*
+ ============================================================================
+ Name		 : GomokuSegmentTable.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Lookup tables with the rating of every possible 5-cell
+               segment for the segment based AIs.
+ ============================================================================
+ */
+
+#ifndef GOMOKUSEGMENTTABLE_H_
+#define GOMOKUSEGMENTTABLE_H_
+
+// INCLUDES
+#include <e32std.h>
+#include "GridCell.h"
+
+/**
+ * Number of bits per cell in the code of a segment.
+ */
+const TInt KSegmentBitsPerCell = 2;
+
+/**
+ * Number of cells of a segment.
+ */
+const TInt KSegmentCells = 5;
+
+/**
+ * Number of possible codes of a 5-cell segment.
+ */
+const TInt KSegmentCodes = 1 << (KSegmentCells * KSegmentBitsPerCell);
+
+/**
+ * Number of possible codes of the last 4 cells, used for the pair check.
+ */
+const TInt KSegmentPairCodes = 1 << (4 * KSegmentBitsPerCell);
+
+/**
+ * Penalty for a pair of own stones that the enemy could capture.
+ */
+const TInt KSegmentPairPenalty = 16;
+
+/**
+ * Rating of a segment for the number of stones of one player, if the
+ * other player has no stone in it. Five stones are a win and are rated
+ * higher than by the normal rule.
+ */
+const TInt KSegmentStoneRating[KSegmentCells + 1] = { 0, 1, 4, 16, 64, 512 };
+
+/**
+ * The stones of the enemy are rated this many times higher, as the enemy
+ * moves next.
+ */
+const TInt KSegmentEnemyFactor = 2;
+
+// CLASS DECLARATION
+
+/**
+ * Rating of all 5-cell segments of a line, looked up by the colors
+ * of the cells.
+ *
+ * A line is encoded while going through it: each cell shifts its color
+ * (eCellColor, 2 bits) into the code, the newest cell is stored in the
+ * lowest bits. The lowest 10 bits are the code of the current segment.
+ *
+ * The AI fills the table once per game with its own rating function
+ * (the rating only depends on the own color and whether pair check is
+ * active), so rating a segment is a single table access instead of
+ * counting the stones of both players.
+ *
+ * The penalty for a pair that the enemy could capture (.x.o.o.?) only
+ * depends on the last 4 cells. It is included in the rating of the
+ * segment and stored separately for the 4th cell of a line, where the
+ * first complete segment is not available yet.
+ */
+class TGomokuSegmentTable
+	{
+public:
+	/**
+	 * Add a cell to the code of the line.
+	 * \param aCode code of the line so far, 0 at the start of a line.
+	 * \param aColor color of the next cell of the line.
+	 * \return code including the new cell.
+	 */
+	static inline TUint AddCell(TUint aCode, eCellColor aColor);
+
+	/**
+	 * Color of a cell of a segment.
+	 * \param aCode code of the segment.
+	 * \param aAge 0 for the newest cell of the segment, 4 for the oldest.
+	 */
+	static inline eCellColor Cell(TUint aCode, TInt aAge);
+
+	/**
+	 * Check if the last 4 cells contain a pair of own stones between an
+	 * enemy stone and a free cell, which the enemy could capture.
+	 * \param aCode code of the line.
+	 * \param aMyColor color of the own player.
+	 */
+	static inline TBool IsCapturablePair(TUint aCode, eCellColor aMyColor);
+
+	/**
+	 * Rating of the segment that ends with the last cell.
+	 * Only valid from the 5th cell of a line on.
+	 */
+	inline TInt Rating(TUint aCode) const;
+
+	/**
+	 * Pair check penalty for the 4th cell of a line.
+	 */
+	inline TInt PairRating(TUint aCode) const;
+
+public:
+	/**
+	 * Rating of every segment code, including the pair check penalty.
+	 */
+	TInt iRating[KSegmentCodes];
+
+	/**
+	 * Pair check penalty for every code of 4 cells.
+	 */
+	TInt iPairRating[KSegmentPairCodes];
+	};
+
+inline TUint TGomokuSegmentTable::AddCell(TUint aCode, eCellColor aColor)
+	{
+	return (aCode << KSegmentBitsPerCell) | (TUint) aColor;
+	}
+
+inline eCellColor TGomokuSegmentTable::Cell(TUint aCode, TInt aAge)
+	{
+	return (eCellColor) ((aCode >> (aAge * KSegmentBitsPerCell)) & 3);
+	}
+
+inline TBool TGomokuSegmentTable::IsCapturablePair(TUint aCode,
+		eCellColor aMyColor)
+	{
+	// Newest cell and the cell 3 cells ago are not own stones and differ,
+	// the two cells in between are own stones.
+	const eCellColor current = Cell(aCode, 0);
+	const eCellColor before = Cell(aCode, 3);
+	return (current != aMyColor && before != aMyColor && current != before
+			&& Cell(aCode, 1) == aMyColor && Cell(aCode, 2) == aMyColor);
+	}
+
+inline TInt TGomokuSegmentTable::Rating(TUint aCode) const
+	{
+	return iRating[aCode & (KSegmentCodes - 1)];
+	}
+
+inline TInt TGomokuSegmentTable::PairRating(TUint aCode) const
+	{
+	return iPairRating[aCode & (KSegmentPairCodes - 1)];
+	}
+
+#endif /*GOMOKUSEGMENTTABLE_H_*/
@@ -0,0 +1,432 @@
+/*
+ ============================================================================
+ Name		 : GomokuThreatSolver.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : CGomokuThreatSolver implementation
+ ============================================================================
+ */
+
+#include "GomokuThreatSolver.h"
+
+CGomokuThreatSolver::CGomokuThreatSolver() :
+	iAttacker(EColor1), iDefender(EColor2), iMaxDepth(KThreatDefaultDepth),
+			iNodeBudget(KThreatDefaultNodeBudget)
+	{
+	// No implementation required
+	}
+
+CGomokuThreatSolver::~CGomokuThreatSolver()
+	{
+	delete iBoard;
+	DeleteArrays();
+	}
+
+CGomokuThreatSolver* CGomokuThreatSolver::NewL()
+	{
+	CGomokuThreatSolver* self = new (ELeave) CGomokuThreatSolver();
+	CleanupStack::PushL(self);
+	self->iBoard = CGomokuBoard::NewL();
+	CleanupStack::Pop(); // self;
+	return self;
+	}
+
+void CGomokuThreatSolver::InitL(TSize aGridSize, TBool aPairCheck,
+		TInt aNumPairsWin)
+	{
+	iPairCheck = aPairCheck;
+	iNumPairsWin = aNumPairsWin;
+	iBoard->ResizeL(aGridSize);
+	DeleteArrays();
+	CreateSegmentsL();
+	const TInt numCells = iBoard->NumCells();
+	// Each search depth needs space for the attacker moves and the defender replies.
+	iMoveBuffer = new (ELeave) TInt16[numCells * 2 * (KThreatMaxDepth + 1)];
+	iMarks = new (ELeave) TUint32[numCells];
+	Mem::FillZ(iMarks, numCells * sizeof(TUint32));
+	iMarkGeneration = 0;
+	}
+
+void CGomokuThreatSolver::SetSearchThrees(TBool aSearchThrees)
+	{
+	iSearchThrees = aSearchThrees;
+	}
+
+void CGomokuThreatSolver::SetLimits(TInt aMaxDepth, TInt aNodeBudget)
+	{
+	iMaxDepth = Min(aMaxDepth, KThreatMaxDepth);
+	iNodeBudget = aNodeBudget;
+	}
+
+void CGomokuThreatSolver::CreateSegmentsL()
+	{
+	const TInt cols = iBoard->Cols();
+	const TInt rows = iBoard->Rows();
+	// Horizontal, vertical and both diagonal directions.
+	const TInt KDirX[4] =
+		{1, 0, 1, 1};
+	const TInt KDirY[4] =
+		{0, 1, 1, -1};
+
+	// Count the segments first to allocate the arrays with the correct size.
+	TInt dir, x, y;
+	iNumSegments = 0;
+	for (dir = 0; dir < 4; dir++)
+		{
+		for (y = 0; y < rows; y++)
+			{
+			for (x = 0; x < cols; x++)
+				{
+				if (iBoard->IsInside(x + KDirX[dir] * 4, y + KDirY[dir] * 4))
+					{
+					iNumSegments++;
+					}
+				}
+			}
+		}
+
+	iSegmentStart = new (ELeave) TInt16[iNumSegments];
+	iSegmentStep = new (ELeave) TInt16[iNumSegments];
+	TInt segment = 0;
+	for (dir = 0; dir < 4; dir++)
+		{
+		for (y = 0; y < rows; y++)
+			{
+			for (x = 0; x < cols; x++)
+				{
+				if (iBoard->IsInside(x + KDirX[dir] * 4, y + KDirY[dir] * 4))
+					{
+					iSegmentStart[segment] = (TInt16) iBoard->Index(x, y);
+					iSegmentStep[segment] = (TInt16) (KDirY[dir] * cols
+							+ KDirX[dir]);
+					segment++;
+					}
+				}
+			}
+		}
+	}
+
+void CGomokuThreatSolver::DeleteArrays()
+	{
+	delete[] iSegmentStart;
+	iSegmentStart = NULL;
+	delete[] iSegmentStep;
+	iSegmentStep = NULL;
+	delete[] iMoveBuffer;
+	iMoveBuffer = NULL;
+	delete[] iMarks;
+	iMarks = NULL;
+	iNumSegments = 0;
+	}
+
+TBool CGomokuThreatSolver::FindWin(const CGrid* aGrid, eCellColor aAttacker,
+		TPoint& aMove, TInt aCapturedPairsAttacker, TInt aCapturedPairsDefender)
+	{
+	iBoard->CopyFrom(aGrid);
+	iAttacker = aAttacker;
+	iDefender = CGomokuBoard::Opponent(aAttacker);
+	// The grid doesn't know the captured pairs, without them Play() can't
+	// recognise wins by capturing.
+	iBoard->SetCapturedPairs(iAttacker, aCapturedPairsAttacker);
+	iBoard->SetCapturedPairs(iDefender, aCapturedPairsDefender);
+	iNodes = 0;
+	iLineLength = 0;
+
+	const TBool foundWin = SearchAttacker(0);
+	if (foundWin)
+		{
+		aMove = WinningLineMove(0);
+		}
+	else
+		{
+		iLineLength = 0;
+		}
+	return foundWin;
+	}
+
+TBool CGomokuThreatSolver::FindForcedMove(const CGrid* aGrid,
+		eCellColor aToMove, TPoint& aMove, TInt aCapturedPairsToMove,
+		TInt aCapturedPairsOpponent)
+	{
+	iBoard->CopyFrom(aGrid);
+	iBoard->SetCapturedPairs(aToMove, aCapturedPairsToMove);
+	iBoard->SetCapturedPairs(CGomokuBoard::Opponent(aToMove),
+			aCapturedPairsOpponent);
+	const TInt numCells = iBoard->NumCells();
+	TInt16* cells = iMoveBuffer;
+	TInt forcedCell = -1;
+
+	// Complete five?
+	ResetMarks();
+	if (CollectSegmentCells(aToMove, 4, cells, 0) > 0)
+		{
+		forcedCell = cells[0];
+		}
+	// Capture the last pairs that are needed to win?
+	if (forcedCell < 0)
+		{
+		forcedCell = FindCaptureWin(aToMove, cells);
+		}
+	if (forcedCell < 0)
+		{
+		// Block five of the opponent? If the opponent has two fours,
+		// the game is lost anyway.
+		ResetMarks();
+		if (CollectSegmentCells(CGomokuBoard::Opponent(aToMove), 4, cells, 0)
+				> 0)
+			{
+			forcedCell = cells[0];
+			// Capturing a pair of the four might be better than blocking it.
+			ResetMarks();
+			if (iPairCheck && CollectCaptures(aToMove, cells + numCells, 0) > 0)
+				{
+				forcedCell = -1;
+				}
+			}
+		}
+	if (forcedCell < 0)
+		{
+		return EFalse;
+		}
+	aMove = TPoint(forcedCell % iBoard->Cols(), forcedCell / iBoard->Cols());
+	return ETrue;
+	}
+
+TInt CGomokuThreatSolver::WinningLineLength() const
+	{
+	return iLineLength;
+	}
+
+TPoint CGomokuThreatSolver::WinningLineMove(TInt aPly) const
+	{
+	const TInt index = iLine[aPly];
+	return TPoint(index % iBoard->Cols(), index / iBoard->Cols());
+	}
+
+TInt CGomokuThreatSolver::NodesSearched() const
+	{
+	return iNodes;
+	}
+
+TBool CGomokuThreatSolver::SearchAttacker(TInt aDepth)
+	{
+	iNodes++;
+	if (iNodes > iNodeBudget)
+		{
+		return EFalse;
+		}
+	const TInt numCells = iBoard->NumCells();
+	TInt16* candidates = iMoveBuffer + aDepth * 2 * numCells;
+	TInt16* replies = candidates + numCells;
+
+	// Can the attacker complete five right now?
+	ResetMarks();
+	if (CollectSegmentCells(iAttacker, 4, candidates, 0) > 0)
+		{
+		iLine[aDepth * 2] = candidates[0];
+		iLineLength = aDepth * 2 + 1;
+		return ETrue;
+		}
+	const TInt captureWin = FindCaptureWin(iAttacker, candidates);
+	if (captureWin >= 0)
+		{
+		iLine[aDepth * 2] = (TInt16) captureWin;
+		iLineLength = aDepth * 2 + 1;
+		return ETrue;
+		}
+	if (aDepth >= iMaxDepth)
+		{
+		return EFalse;
+		}
+
+	// If the defender already has a four, the attacker has to block it.
+	// Two fours can not be blocked at once.
+	ResetMarks();
+	const TInt numBlocks = CollectSegmentCells(iDefender, 4, replies, 0);
+	if (numBlocks > 1)
+		{
+		return EFalse;
+		}
+	const TInt blockCell = (numBlocks == 1) ? replies[0] : -1;
+
+	// Collect the forcing moves: fours first, then threes.
+	ResetMarks();
+	const TInt numFours = CollectSegmentCells(iAttacker, 3, candidates, 0);
+	TInt numCandidates = numFours;
+	if (iSearchThrees && numBlocks == 0 && aDepth < KThreatMaxThreeDepth)
+		{
+		numCandidates = CollectSegmentCells(iAttacker, 2, candidates,
+				numCandidates);
+		}
+
+	for (TInt i = 0; i < numCandidates; i++)
+		{
+		const TInt move = candidates[i];
+		if (blockCell >= 0 && move != blockCell)
+			{
+			continue;
+			}
+		if (Play(move, iAttacker))
+			{
+			// Won by capturing enough pairs.
+			iBoard->UndoMove();
+			iLine[aDepth * 2] = (TInt16) move;
+			iLineLength = aDepth * 2 + 1;
+			return ETrue;
+			}
+
+		// The defender has to block all cells that would complete five.
+		ResetMarks();
+		TInt numReplies = CollectSegmentCells(iAttacker, 4, replies, 0);
+		if (numReplies == 0 && i >= numFours)
+			{
+			// A three: the defender can play into any segment that the
+			// attacker could turn into a four, or counter with an own four.
+			numReplies = CollectSegmentCells(iAttacker, 3, replies, 0);
+			if (numReplies > 0)
+				{
+				numReplies = CollectSegmentCells(iDefender, 3, replies,
+						numReplies);
+				}
+			}
+		if (numReplies > 0 && iPairCheck)
+			{
+			// Capturing a pair might break the threat.
+			numReplies = CollectCaptures(iDefender, replies, numReplies);
+			}
+
+		const TBool won = (numReplies > 0) && SearchDefender(aDepth, replies,
+				numReplies);
+		iBoard->UndoMove();
+		if (won)
+			{
+			iLine[aDepth * 2] = (TInt16) move;
+			return ETrue;
+			}
+		}
+	return EFalse;
+	}
+
+TBool CGomokuThreatSolver::SearchDefender(TInt aDepth, TInt16* aReplies,
+		TInt aNumReplies)
+	{
+	for (TInt i = 0; i < aNumReplies; i++)
+		{
+		if (Play(aReplies[i], iDefender))
+			{
+			// The defender wins with this reply (by capturing pairs).
+			iBoard->UndoMove();
+			return EFalse;
+			}
+		const TBool won = SearchAttacker(aDepth + 1);
+		iBoard->UndoMove();
+		if (!won)
+			{
+			return EFalse;
+			}
+		iLine[aDepth * 2 + 1] = aReplies[i];
+		}
+	return ETrue;
+	}
+
+TInt CGomokuThreatSolver::CollectSegmentCells(eCellColor aColor,
+		TInt aStones, TInt16* aCells, TInt aCount)
+	{
+	for (TInt segment = 0; segment < iNumSegments; segment++)
+		{
+		const TInt start = iSegmentStart[segment];
+		const TInt step = iSegmentStep[segment];
+		TInt stones = 0;
+		TInt pos = start;
+		TInt i;
+		for (i = 0; i < 5; i++)
+			{
+			const eCellColor color = iBoard->CellAt(pos);
+			if (color == aColor)
+				{
+				stones++;
+				}
+			else if (color != EColorNeutral)
+				{
+				// Segment is blocked by the opponent.
+				break;
+				}
+			pos += step;
+			}
+		if (i == 5 && stones == aStones)
+			{
+			pos = start;
+			for (i = 0; i < 5; i++)
+				{
+				if (iBoard->CellAt(pos) == EColorNeutral && Mark(pos))
+					{
+					aCells[aCount++] = (TInt16) pos;
+					}
+				pos += step;
+				}
+			}
+		}
+	return aCount;
+	}
+
+TInt CGomokuThreatSolver::CollectCaptures(eCellColor aColor, TInt16* aCells,
+		TInt aCount)
+	{
+	const TInt cols = iBoard->Cols();
+	const TInt numCells = iBoard->NumCells();
+	for (TInt pos = 0; pos < numCells; pos++)
+		{
+		if (iBoard->CellAt(pos) == EColorNeutral && iBoard->CapturesPair(pos
+				% cols, pos / cols, aColor) && Mark(pos))
+			{
+			aCells[aCount++] = (TInt16) pos;
+			}
+		}
+	return aCount;
+	}
+
+void CGomokuThreatSolver::ResetMarks()
+	{
+	iMarkGeneration++;
+	if (iMarkGeneration == 0)
+		{
+		// Overflow - clear all marks of earlier generations.
+		Mem::FillZ(iMarks, iBoard->NumCells() * sizeof(TUint32));
+		iMarkGeneration = 1;
+		}
+	}
+
+TInt CGomokuThreatSolver::FindCaptureWin(eCellColor aColor, TInt16* aCells)
+	{
+	if (!iPairCheck || iBoard->CapturedPairs(aColor) + KThreatMaxPairsPerMove
+			< iNumPairsWin)
+		{
+		return -1;
+		}
+	ResetMarks();
+	const TInt numCaptures = CollectCaptures(aColor, aCells, 0);
+	TInt winCell = -1;
+	for (TInt i = 0; i < numCaptures && winCell < 0; i++)
+		{
+		if (Play(aCells[i], aColor))
+			{
+			winCell = aCells[i];
+			}
+		iBoard->UndoMove();
+		}
+	return winCell;
+	}
+
+TBool CGomokuThreatSolver::Play(TInt aIndex, eCellColor aColor)
+	{
+	const TInt x = aIndex % iBoard->Cols();
+	const TInt y = aIndex / iBoard->Cols();
+	iBoard->MakeMove(x, y, aColor, iPairCheck);
+	return iBoard->IsFive(x, y, aColor) || (iPairCheck
+			&& iBoard->CapturedPairs(aColor) >= iNumPairsWin);
+	}
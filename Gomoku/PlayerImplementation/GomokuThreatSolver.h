@@ -0,0 +1,347 @@
+/*
+ ============================================================================
+ Name		 : GomokuThreatSolver.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Threat-space search that finds forced wins through
+               continuous fours (VCF) and optionally threes (VCT).
+ ============================================================================
+ */
+
+#ifndef GOMOKUTHREATSOLVER_H_
+#define GOMOKUTHREATSOLVER_H_
+
+// INCLUDES
+#include <e32std.h>
+#include <e32base.h>
+#include "Grid.h"
+#include "GomokuBoard.h"
+
+/**
+ * Maximum number of attacker moves in a winning line.
+ */
+const TInt KThreatMaxDepth = 16;
+
+/**
+ * Default number of attacker moves that the solver looks ahead.
+ * 12 attacker moves plus the forced replies are 24 plies.
+ */
+const TInt KThreatDefaultDepth = 12;
+
+/**
+ * Threes are only considered for the first attacker moves of a line,
+ * deeper in the tree only fours are searched. Otherwise, the branching
+ * factor of VCT is too large.
+ */
+const TInt KThreatMaxThreeDepth = 2;
+
+/**
+ * Default number of positions that the solver may visit for one search.
+ */
+const TInt KThreatDefaultNodeBudget = 3000;
+
+/**
+ * Most pairs that one stone can capture (one in each of the eight directions).
+ */
+const TInt KThreatMaxPairsPerMove = 8;
+
+// CLASS DECLARATION
+
+/**
+ * Searches for a forced win of the attacker that only uses threats.
+ *
+ * The segment rating of the AI implementations can not see that a
+ * sequence of fours leads to a win. But as the opponent has to reply to
+ * every four (or lose), the tree of forcing moves is tiny and can be
+ * searched many plies deep within a few milliseconds:
+ *
+ * -------------------------- VCF (victory by continuous fours)
+ * . .o.o.o. . .   - attacker plays a fourth stone into a 5-cell segment
+ * . .o.o.o.o.x.   - defender has to block the only free cell of the segment
+ *                   (or capture a pair of the four if pair check is active)
+ * ... repeat until the attacker has two fours at once or completes five.
+ *
+ * Only three kinds of segments are relevant, so the search simply scans all
+ * 5-cell segments of the board:
+ * - 4 own stones + 1 free cell: the free cell completes five.
+ * - 3 own stones + 2 free cells: each free cell creates a four.
+ * - 2 own stones + 3 free cells: each free cell creates a three (VCT only).
+ *
+ * If threes are searched as well (VCT), the defender may answer a three
+ * with any free cell of the attacker's threatening segments or with a four of
+ * its own. This reply set is a heuristic, therefore VCT is disabled by default.
+ *
+ * With activated pair check, the defender can also reply by capturing a pair,
+ * which might break the four. All such replies are searched as well.
+ */
+class CGomokuThreatSolver : public CBase
+	{
+public:
+	// Constructors and destructor
+
+	/**
+	 * Destructor.
+	 */
+	~CGomokuThreatSolver();
+
+	/**
+	 * Two-phased constructor.
+	 */
+	static CGomokuThreatSolver* NewL();
+
+public:
+	/**
+	 * Prepare the solver for a new game.
+	 *
+	 * \param aGridSize size of the grid used in the game.
+	 * \param aPairCheck ETrue if pair check is activated for this game.
+	 * \param aNumPairsWin number of captured pairs required for winning a game.
+	 */
+	void InitL(TSize aGridSize, TBool aPairCheck, TInt aNumPairsWin);
+
+	/**
+	 * Also search for wins that need threes as forcing moves (VCT).
+	 * Disabled by default.
+	 */
+	void SetSearchThrees(TBool aSearchThrees);
+
+	/**
+	 * Limit the search.
+	 *
+	 * \param aMaxDepth maximum number of attacker moves (up to KThreatMaxDepth).
+	 * \param aNodeBudget maximum number of visited positions.
+	 */
+	void SetLimits(TInt aMaxDepth, TInt aNodeBudget);
+
+	/**
+	 * Search for a forced win of the attacker on the provided grid.
+	 * Does not modify the grid.
+	 *
+	 * \param aGrid the current game state.
+	 * \param aAttacker color of the player to move.
+	 * \param aMove receives the first move of the winning line.
+	 * \param aCapturedPairsAttacker pairs that the attacker has already captured.
+	 * \param aCapturedPairsDefender pairs that the defender has already captured.
+	 * \return ETrue if a forced win was found.
+	 */
+	TBool FindWin(const CGrid* aGrid, eCellColor aAttacker, TPoint& aMove,
+			TInt aCapturedPairsAttacker = 0, TInt aCapturedPairsDefender = 0);
+
+	/**
+	 * Check if the player to move has to play a specific move: a move that
+	 * completes five, or the block of a five of the opponent. Only scans the
+	 * segments of the board, much faster than rating the board.
+	 * With pair check, a capture that wins the game is forced as well, and
+	 * a five of the opponent is not a forced block if the player could
+	 * capture a pair instead.
+	 * Does not modify the grid.
+	 *
+	 * \param aGrid the current game state.
+	 * \param aToMove color of the player to move.
+	 * \param aMove receives the forced move.
+	 * \param aCapturedPairsToMove pairs that the player to move has already captured.
+	 * \param aCapturedPairsOpponent pairs that the opponent has already captured.
+	 * \return ETrue if the move is forced.
+	 */
+	TBool FindForcedMove(const CGrid* aGrid, eCellColor aToMove, TPoint& aMove,
+			TInt aCapturedPairsToMove = 0, TInt aCapturedPairsOpponent = 0);
+
+	/**
+	 * Number of plies of the winning line found by the last successful
+	 * call to FindWin() (attacker and defender moves).
+	 */
+	TInt WinningLineLength() const;
+
+	/**
+	 * Get a move of the winning line found by the last successful call to FindWin().
+	 * Even plies are attacker moves, odd plies are (one of the) defender replies.
+	 */
+	TPoint WinningLineMove(TInt aPly) const;
+
+	/**
+	 * Number of positions visited by the last call to FindWin().
+	 */
+	TInt NodesSearched() const;
+
+private:
+
+	/**
+	 * Constructor for performing 1st stage construction
+	 */
+	CGomokuThreatSolver();
+
+	/**
+	 * Create the list of all 5-cell segments of the board.
+	 */
+	void CreateSegmentsL();
+
+	/**
+	 * Delete all arrays owned by the solver.
+	 */
+	void DeleteArrays();
+
+	/**
+	 * Attacker to move: try all forcing moves.
+	 * \param aDepth number of attacker moves already made.
+	 * \return ETrue if the attacker can force a win.
+	 */
+	TBool SearchAttacker(TInt aDepth);
+
+	/**
+	 * Defender to move after a threat of the attacker. The attacker only
+	 * wins if it wins after every reply.
+	 * \param aDepth number of attacker moves already made.
+	 * \param aReplies all defender moves that have to be considered.
+	 * \param aNumReplies number of entries in aReplies.
+	 * \return ETrue if the attacker wins after all replies.
+	 */
+	TBool SearchDefender(TInt aDepth, TInt16* aReplies, TInt aNumReplies);
+
+	/**
+	 * Collect the free cells of all segments that contain exactly
+	 * aStones stones of the specified color and no stone of the opponent.
+	 * Every cell is only added once.
+	 *
+	 * \param aColor color to count the stones for.
+	 * \param aStones required number of stones in the segment.
+	 * \param aCells receives the positions of the cells.
+	 * \param aCount number of cells already stored in aCells, new cells are appended.
+	 * \return new number of cells in aCells.
+	 */
+	TInt CollectSegmentCells(eCellColor aColor, TInt aStones, TInt16* aCells,
+			TInt aCount);
+
+	/**
+	 * Append all free cells where the specified color would capture a pair.
+	 * Cells that are already in aCells (marked) are not added again.
+	 */
+	TInt CollectCaptures(eCellColor aColor, TInt16* aCells, TInt aCount);
+
+	/**
+	 * Find a capture that brings aColor to the number of pairs needed for
+	 * winning the game.
+	 * \param aCells buffer for the capturing cells, NumCells() entries.
+	 * \return the winning cell or -1.
+	 */
+	TInt FindCaptureWin(eCellColor aColor, TInt16* aCells);
+
+	/**
+	 * Start a new set of collected cells, every cell can be added once.
+	 */
+	void ResetMarks();
+
+	/**
+	 * Mark the cell as collected.
+	 * \return ETrue if the cell was not marked before.
+	 */
+	inline TBool Mark(TInt aIndex);
+
+	/**
+	 * Place a stone on the search board.
+	 * \return ETrue if this move wins the game for aColor.
+	 */
+	TBool Play(TInt aIndex, eCellColor aColor);
+
+private:
+	/**
+	 * Board that the search is performed on.
+	 */
+	CGomokuBoard* iBoard;
+
+	/**
+	 * First cell of every 5-cell segment of the board.
+	 */
+	TInt16* iSegmentStart;
+
+	/**
+	 * Distance between two cells of the segment (in the cell array).
+	 */
+	TInt16* iSegmentStep;
+
+	/**
+	 * Number of segments.
+	 */
+	TInt iNumSegments;
+
+	/**
+	 * Memory for the candidate moves of every search depth.
+	 */
+	TInt16* iMoveBuffer;
+
+	/**
+	 * Generation number for every cell, used to collect each cell only once.
+	 */
+	TUint32* iMarks;
+
+	/**
+	 * Current generation of iMarks.
+	 */
+	TUint32 iMarkGeneration;
+
+	/**
+	 * Moves of the winning line.
+	 */
+	TInt16 iLine[KThreatMaxDepth * 2 + 1];
+
+	/**
+	 * Number of plies in iLine.
+	 */
+	TInt iLineLength;
+
+	/**
+	 * Color of the player searching for a win.
+	 */
+	eCellColor iAttacker;
+
+	/**
+	 * Color of the player that has to reply to the threats.
+	 */
+	eCellColor iDefender;
+
+	/**
+	 * Stores if pair check is activated in the current game.
+	 */
+	TBool iPairCheck;
+
+	/**
+	 * Number of captured pairs required for winning a game.
+	 */
+	TInt iNumPairsWin;
+
+	/**
+	 * ETrue if threes are searched as well (VCT).
+	 */
+	TBool iSearchThrees;
+
+	/**
+	 * Maximum number of attacker moves.
+	 */
+	TInt iMaxDepth;
+
+	/**
+	 * Maximum number of positions per search.
+	 */
+	TInt iNodeBudget;
+
+	/**
+	 * Positions visited by the current search.
+	 */
+	TInt iNodes;
+	};
+
+inline TBool CGomokuThreatSolver::Mark(TInt aIndex)
+	{
+	if (iMarks[aIndex] == iMarkGeneration)
+		{
+		return EFalse;
+		}
+	iMarks[aIndex] = iMarkGeneration;
+	return ETrue;
+	}
+
+#endif /*GOMOKUTHREATSOLVER_H_*/
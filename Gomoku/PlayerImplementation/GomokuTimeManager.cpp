@@ -0,0 +1,103 @@
+/*
+ ============================================================================
+ Name		 : GomokuTimeManager.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : TGomokuTimeManager implementation
+ ============================================================================
+ */
+
+#include "GomokuTimeManager.h"
+
+TGomokuTimeManager::TGomokuTimeManager() :
+	iMoveTimeMs(KTimeUnlimited), iClockMs(KTimeUnlimited), iClockFraction(
+			KTimeDefaultClockFraction), iPollInterval(KTimeDefaultPollInterval),
+			iPollCountdown(KTimeDefaultPollInterval), iSliceStartUs(0),
+			iElapsedUs(0), iSoftLimitUs(0), iHardLimitUs(0), iExpired(EFalse)
+	{
+	iMoveStart.UniversalTime();
+	}
+
+void TGomokuTimeManager::SetLimits(TInt aMoveTimeMs, TInt aClockMs,
+		TInt aClockFraction)
+	{
+	iMoveTimeMs = Max(aMoveTimeMs, 0);
+	iClockMs = Max(aClockMs, 0);
+	iClockFraction = Max(aClockFraction, 1);
+	}
+
+void TGomokuTimeManager::SetPollInterval(TInt aInterval)
+	{
+	iPollInterval = Max(aInterval, 1);
+	iPollCountdown = iPollInterval;
+	}
+
+void TGomokuTimeManager::StartMove()
+	{
+	iMoveStart.UniversalTime();
+	iElapsedUs = 0;
+	iSliceStartUs = 0;
+	iPollCountdown = iPollInterval;
+	iExpired = EFalse;
+
+	TInt budgetMs = iMoveTimeMs;
+	if (iClockMs != KTimeUnlimited)
+		{
+		budgetMs = Min(budgetMs, iClockMs / iClockFraction);
+		}
+	if (budgetMs == KTimeUnlimited)
+		{
+		iHardLimitUs = KMaxTInt64;
+		iSoftLimitUs = KMaxTInt64;
+		}
+	else
+		{
+		iHardLimitUs = (TInt64) budgetMs * 1000;
+		iSoftLimitUs = iHardLimitUs * KTimeSoftPercent / 100;
+		}
+	}
+
+void TGomokuTimeManager::StartSlice()
+	{
+	Update();
+	iSliceStartUs = iElapsedUs;
+	iExpired = EFalse;
+	}
+
+TBool TGomokuTimeManager::Update()
+	{
+	TTime now;
+	now.UniversalTime();
+	iElapsedUs = now.MicroSecondsFrom(iMoveStart).Int64();
+	iPollCountdown = iPollInterval;
+	iExpired = SliceExpired();
+	return iExpired;
+	}
+
+void TGomokuTimeManager::FinishMove()
+	{
+	Update();
+	if (iClockMs != KTimeUnlimited)
+		{
+		iClockMs = (TInt) Max((TInt64) 0, iClockMs - iElapsedUs / 1000);
+		}
+	}
+
+TInt TGomokuTimeManager::ElapsedMs() const
+	{
+	return (TInt) (iElapsedUs / 1000);
+	}
+
+TInt TGomokuTimeManager::BudgetMs() const
+	{
+	if (iHardLimitUs == KMaxTInt64)
+		{
+		return KTimeUnlimited;
+		}
+	return (TInt) (iHardLimitUs / 1000);
+	}
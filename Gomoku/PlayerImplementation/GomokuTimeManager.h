@@ -0,0 +1,244 @@
+/*
+ ============================================================================
+ Name		 : GomokuTimeManager.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Thinking time of the AI players: per-move deadline,
+               soft and hard limits and the slices of the active object.
+ ============================================================================
+ */
+
+#ifndef GOMOKUTIMEMANAGER_H_
+#define GOMOKUTIMEMANAGER_H_
+
+// INCLUDES
+#include <e32std.h>
+
+/**
+ * No limit for the thinking time or the game clock.
+ */
+const TInt KTimeUnlimited = KMaxTInt;
+
+/**
+ * Default part of the remaining game clock that may be used for one move
+ * (1 / KTimeDefaultClockFraction).
+ */
+const TInt KTimeDefaultClockFraction = 20;
+
+/**
+ * The soft limit is this percentage of the move budget.
+ */
+const TInt KTimeSoftPercent = 50;
+
+/**
+ * Maximum duration of one call of the CIdle active object in milliseconds.
+ * Afterwards, the UI gets a chance to handle its events.
+ */
+const TInt KTimeSliceMs = 20;
+
+/**
+ * Default number of Poll() calls between two reads of the clock.
+ */
+const TInt KTimeDefaultPollInterval = 1;
+
+// CLASS DECLARATION
+
+/**
+ * Keeps track of the thinking time of an AI player.
+ *
+ * The budget of a move is the per-move deadline, reduced to a fraction of
+ * the remaining game clock if the game is played with a clock. Two limits
+ * are derived from the budget:
+ * - Soft limit (KTimeSoftPercent of the budget): the AI should not start
+ *   another big step of its calculation, but finish the current one.
+ * - Hard limit (the whole budget): the AI has to stop immediately and play
+ *   the best move it has found so far.
+ *
+ * In addition, the calculation in the CIdle active object is split into
+ * slices of KTimeSliceMs, independent of the size of the board.
+ *
+ * Reading the clock is more expensive than a step of most inner loops,
+ * therefore Poll() only reads it every few calls (see SetPollInterval()).
+ * The other queries just return the state of the last read.
+ *
+ * Usage:
+ * - StartMove() when the turn starts,
+ * - StartSlice() at the beginning of each callback of the active object,
+ * - Poll() in the inner loop until it returns ETrue at the end of the
+ *   slice, then check SoftLimitReached() and HardLimitReached(),
+ * - FinishMove() when the move is sent to the game engine.
+ */
+class TGomokuTimeManager
+	{
+public:
+	/**
+	 * Constructor. No limits and no game clock.
+	 */
+	TGomokuTimeManager();
+
+	/**
+	 * Configure the thinking time.
+	 *
+	 * \param aMoveTimeMs deadline per move in milliseconds,
+	 * KTimeUnlimited for no deadline.
+	 * \param aClockMs remaining time on the game clock of this player in
+	 * milliseconds, KTimeUnlimited if the game is played without a clock.
+	 * \param aClockFraction at most 1 / aClockFraction of the remaining
+	 * game clock is used for one move.
+	 */
+	void SetLimits(TInt aMoveTimeMs, TInt aClockMs = KTimeUnlimited,
+			TInt aClockFraction = KTimeDefaultClockFraction);
+
+	/**
+	 * Set how often Poll() reads the clock. Use a larger interval if a step
+	 * of the inner loop only takes a few microseconds.
+	 *
+	 * \param aInterval number of Poll() calls per read of the clock.
+	 */
+	void SetPollInterval(TInt aInterval);
+
+	/**
+	 * Start the thinking time of a new move and calculate its limits.
+	 */
+	void StartMove();
+
+	/**
+	 * Start a new slice of the active object.
+	 */
+	void StartSlice();
+
+	/**
+	 * Cheap check for the inner loop. Reads the clock every few calls.
+	 * The limits of the move are not checked, the caller queries them
+	 * once the slice is over.
+	 *
+	 * \return ETrue if the slice is over.
+	 */
+	inline TBool Poll();
+
+	/**
+	 * Read the clock now, independent of the poll interval.
+	 *
+	 * \return ETrue if the slice is over.
+	 */
+	TBool Update();
+
+	/**
+	 * \return ETrue if the current slice of the active object is over.
+	 */
+	inline TBool SliceExpired() const;
+
+	/**
+	 * \return ETrue if no new big step should be started.
+	 */
+	inline TBool SoftLimitReached() const;
+
+	/**
+	 * \return ETrue if the calculation has to stop immediately.
+	 */
+	inline TBool HardLimitReached() const;
+
+	/**
+	 * End the move and subtract its thinking time from the game clock.
+	 */
+	void FinishMove();
+
+	/**
+	 * \return thinking time of the current move in milliseconds,
+	 * as of the last read of the clock.
+	 */
+	TInt ElapsedMs() const;
+
+	/**
+	 * \return budget of the current move in milliseconds.
+	 */
+	TInt BudgetMs() const;
+
+private:
+	/**
+	 * Per-move deadline in milliseconds.
+	 */
+	TInt iMoveTimeMs;
+
+	/**
+	 * Remaining game clock in milliseconds.
+	 */
+	TInt iClockMs;
+
+	/**
+	 * Part of the game clock that may be used for one move.
+	 */
+	TInt iClockFraction;
+
+	/**
+	 * Number of Poll() calls per read of the clock.
+	 */
+	TInt iPollInterval;
+
+	/**
+	 * Poll() calls until the clock is read again.
+	 */
+	TInt iPollCountdown;
+
+	/**
+	 * Start of the current move.
+	 */
+	TTime iMoveStart;
+
+	/**
+	 * Elapsed time of the current move in microseconds when the current
+	 * slice was started.
+	 */
+	TInt64 iSliceStartUs;
+
+	/**
+	 * Elapsed time of the current move in microseconds, as of the last read.
+	 */
+	TInt64 iElapsedUs;
+
+	/**
+	 * Soft limit of the current move in microseconds.
+	 */
+	TInt64 iSoftLimitUs;
+
+	/**
+	 * Hard limit of the current move in microseconds.
+	 */
+	TInt64 iHardLimitUs;
+
+	/**
+	 * ETrue if the slice is over, as of the last read.
+	 */
+	TBool iExpired;
+	};
+
+inline TBool TGomokuTimeManager::Poll()
+	{
+	if (--iPollCountdown > 0)
+		{
+		return iExpired;
+		}
+	return Update();
+	}
+
+inline TBool TGomokuTimeManager::SliceExpired() const
+	{
+	return iElapsedUs - iSliceStartUs >= KTimeSliceMs * 1000;
+	}
+
+inline TBool TGomokuTimeManager::SoftLimitReached() const
+	{
+	return iElapsedUs >= iSoftLimitUs;
+	}
+
+inline TBool TGomokuTimeManager::HardLimitReached() const
+	{
+	return iElapsedUs >= iHardLimitUs;
+	}
+
+#endif /*GOMOKUTIMEMANAGER_H_*/
@@ -21,6 +21,10 @@
 #include "GomokuPlayerAiDefensive.h"
 #include "GomokuPlayerAiAggressive.h"
 #include "GomokuPlayerAiRandom.h"
+#include "GomokuPlayerAiMcts.h"
+#include "GomokuPlayerAiEasy.h"
+#include "GomokuPlayerAiMedium.h"
+#include "GomokuPlayerAiExpert.h"
 
 
 // Map the interface implementation UIDs to implementation factory functions
@@ -30,7 +34,11 @@ const TImplementationProxy ImplementationTable[] =
 		IMPLEMENTATION_PROXY_ENTRY(0xE0000E03,	CGomokuPlayerAiReference::NewL),
 		IMPLEMENTATION_PROXY_ENTRY(0xE0000E04,	CGomokuPlayerAiDefensive::NewL),
 		IMPLEMENTATION_PROXY_ENTRY(0xE0000E05,	CGomokuPlayerAiAggressive::NewL),
-		IMPLEMENTATION_PROXY_ENTRY(0xE0000E02,	CGomokuPlayerAiRandom::NewL)
+		IMPLEMENTATION_PROXY_ENTRY(0xE0000E02,	CGomokuPlayerAiRandom::NewL),
+		IMPLEMENTATION_PROXY_ENTRY(0xE0000E06,	CGomokuPlayerAiMcts::NewL),
+		IMPLEMENTATION_PROXY_ENTRY(0xE0000E07,	CGomokuPlayerAiEasy::NewL),
+		IMPLEMENTATION_PROXY_ENTRY(0xE0000E08,	CGomokuPlayerAiMedium::NewL),
+		IMPLEMENTATION_PROXY_ENTRY(0xE0000E09,	CGomokuPlayerAiExpert::NewL)
 	};
 
 // Exported proxy for instantiation method resolution
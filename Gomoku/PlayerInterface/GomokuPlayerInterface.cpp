@@ -70,3 +70,43 @@ EXPORT_C void CGomokuPlayerInterface::SetObserver(MGomokuPlayerObserver* aObserv
 	// Keep a reference to the observer
 	iObserver = aObserver;
 	}
+
+EXPORT_C void CGomokuPlayerInterface::CancelTurn()
+	{
+	// Players that don't calculate in the background have nothing to stop.
+	}
+
+EXPORT_C TBool CGomokuPlayerInterface::GetStatistics(
+		TGomokuSearchStatistics& /*aStatistics*/) const
+	{
+	return EFalse;
+	}
+
+EXPORT_C TInt CGomokuPlayerInterface::GetHints(TGomokuMoveHint* /*aHints*/,
+		TInt /*aMaxHints*/) const
+	{
+	return 0;
+	}
+
+EXPORT_C void CGomokuPlayerInterface::SetCapturedPairs(TInt /*aYourPairs*/,
+		TInt /*aOpponentPairs*/)
+	{
+	}
+
+EXPORT_C void CGomokuPlayerInterface::SetTimeLimits(TInt /*aMoveTimeMs*/,
+		TInt /*aClockMs*/)
+	{
+	// Players that don't calculate their move are never out of time.
+	}
+
+EXPORT_C void CGomokuPlayerInterface::SetThreads(TInt /*aThreads*/)
+	{
+	}
+
+EXPORT_C void CGomokuPlayerInterface::SetReportStatistics(TBool /*aReport*/)
+	{
+	}
+
+EXPORT_C void CGomokuPlayerInterface::SetRandomSeed(TUint64 /*aSeed*/)
+	{
+	}
@@ -19,6 +19,7 @@
 #include <ECom.h>
 #include "Grid.h"
 #include "GomokuPlayerObserver.h"
+#include "GomokuSearchStatistics.h"
 
 // UID of this interface
 const TUid KCGomokuPlayerInterfaceUid =
@@ -130,6 +131,108 @@ public:
 	 */
 	virtual void GameOver(eCellColor aWinnerColor) = 0;
 
+	/**
+	 * Called by the game engine when the turn that was started through
+	 * StartTurn() is no longer needed, e.g. because the game is restarted
+	 * or abandoned. The implementation should stop calculating its move as
+	 * soon as possible (within one time slice of its active object) and
+	 * must not call the observer for this turn anymore.
+	 *
+	 * The engine discards moves that arrive after the turn was cancelled,
+	 * so players that calculate their move right away in StartTurn() don't
+	 * have to implement this. The default implementation does nothing.
+	 */
+	IMPORT_C virtual void CancelTurn();
+
+	/**
+	 * Get the statistics of the search for the last move of this player,
+	 * e.g. to print them or to compare the speed of different versions.
+	 * Valid after the player has sent its move to the observer, until the
+	 * next turn is started.
+	 *
+	 * The default implementation returns EFalse, for players that don't
+	 * search (like human players).
+	 *
+	 * \param aStatistics receives the statistics.
+	 * \return ETrue if the player has statistics of its last move.
+	 */
+	IMPORT_C virtual TBool GetStatistics(
+			TGomokuSearchStatistics& aStatistics) const;
+
+	/**
+	 * Get the best moves for the current position, e.g. to show them as
+	 * hints to a human player. The game engine asks the player whose turn
+	 * it is. Implementations should calculate them in the background during
+	 * the turn and return right away, without waiting for the calculation.
+	 *
+	 * The default implementation returns 0.
+	 *
+	 * \param aHints receives the moves, the best one first.
+	 * \param aMaxHints maximum number of moves, up to KMaxMoveHints.
+	 * \return number of moves in aHints, 0 if none are available (yet).
+	 */
+	IMPORT_C virtual TInt GetHints(TGomokuMoveHint* aHints,
+			TInt aMaxHints) const;
+
+	/**
+	 * Called by the game engine before StartTurn() with the number of pairs
+	 * that both players have captured so far. Players that search ahead
+	 * need them to recognise wins by capturing pairs.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * \param aYourPairs pairs captured by this player.
+	 * \param aOpponentPairs pairs captured by the opponent.
+	 */
+	IMPORT_C virtual void SetCapturedPairs(TInt aYourPairs,
+			TInt aOpponentPairs);
+
+	/**
+	 * Called by the game engine after InitL() to configure how long the
+	 * player may think about a move. Players that calculate their move
+	 * play the best move found so far when the time is up.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * \param aMoveTimeMs deadline per move in milliseconds, KMaxTInt for
+	 * no deadline.
+	 * \param aClockMs remaining time on the game clock of this player in
+	 * milliseconds, KMaxTInt if the game is played without a clock.
+	 */
+	IMPORT_C virtual void SetTimeLimits(TInt aMoveTimeMs, TInt aClockMs);
+
+	/**
+	 * Called by the game engine before InitL() with the number of threads
+	 * that the player may use to calculate its moves.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * \param aThreads number of threads, at least 1.
+	 */
+	IMPORT_C virtual void SetThreads(TInt aThreads);
+
+	/**
+	 * Called by the game engine in debug builds to let the player print
+	 * the statistics of its calculation to the debug output after each
+	 * move.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * \param aReport ETrue to print the statistics.
+	 */
+	IMPORT_C virtual void SetReportStatistics(TBool aReport);
+
+	/**
+	 * Called by the game engine after InitL() with a seed for the random
+	 * numbers of the player. The same seed and the same moves of the
+	 * opponent give the same game.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * \param aSeed seed of the random number generator.
+	 */
+	IMPORT_C virtual void SetRandomSeed(TUint64 aSeed);
+
 protected:
 	/**
 	 * Observer of this player, which the player implementation can use
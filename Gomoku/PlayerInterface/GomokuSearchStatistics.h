@@ -0,0 +1,160 @@
+/*
+ ============================================================================
+ Name		 : GomokuSearchStatistics.h
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Statistics of the search of a player implementation for
+ its last move, and the moves it suggests as hints.
+ ============================================================================
+ */
+
+#ifndef GOMOKUSEARCHSTATISTICS_H_
+#define GOMOKUSEARCHSTATISTICS_H_
+
+#include <e32std.h>
+
+/**
+ * Maximum number of moves of the principal variation.
+ */
+const TInt KSearchMaxPvLength = 8;
+
+/**
+ * What a player implementation did to find its last move. Filled in by
+ * the AIs (see CGomokuPlayerInterface::GetStatistics()), so that the game
+ * and test programs can compare the speed and the depth of the search
+ * between versions.
+ *
+ * What a node is depends on the AI, e.g. a rated position or a playout.
+ * Numbers that an AI doesn't have stay 0.
+ */
+class TGomokuSearchStatistics
+	{
+public:
+	/**
+	 * Constructor, all statistics are 0.
+	 */
+	inline TGomokuSearchStatistics();
+
+	/**
+	 * Set all statistics back to 0.
+	 */
+	inline void Reset();
+
+	/**
+	 * Add a move to the end of the principal variation. Moves beyond
+	 * KSearchMaxPvLength are ignored.
+	 */
+	inline void AddPvMove(const TPoint& aMove);
+
+	/**
+	 * \return number of nodes per second, 0 if no time was measured.
+	 */
+	inline TInt NodesPerSecond() const;
+
+	/**
+	 * \return percentage of the lookups of the transposition table or
+	 * cache that were hits, 0 if there were none.
+	 */
+	inline TInt HashHitPercent() const;
+
+public:
+	/**
+	 * Number of nodes searched.
+	 */
+	TInt iNodes;
+
+	/**
+	 * Number of plies reached by the search.
+	 */
+	TInt iDepth;
+
+	/**
+	 * Calculation time in milliseconds.
+	 */
+	TInt iTimeMs;
+
+	/**
+	 * Lookups of the transposition table (or cache) of the AI.
+	 */
+	TInt iHashLookups;
+
+	/**
+	 * Lookups that found an entry.
+	 */
+	TInt iHashHits;
+
+	/**
+	 * Number of moves in iPv.
+	 */
+	TInt iPvLength;
+
+	/**
+	 * The best line of play that the AI found, starting with its move.
+	 */
+	TPoint iPv[KSearchMaxPvLength];
+	};
+
+inline TGomokuSearchStatistics::TGomokuSearchStatistics()
+	{
+	Reset();
+	}
+
+inline void TGomokuSearchStatistics::Reset()
+	{
+	iNodes = 0;
+	iDepth = 0;
+	iTimeMs = 0;
+	iHashLookups = 0;
+	iHashHits = 0;
+	iPvLength = 0;
+	}
+
+inline void TGomokuSearchStatistics::AddPvMove(const TPoint& aMove)
+	{
+	if (iPvLength < KSearchMaxPvLength)
+		{
+		iPv[iPvLength++] = aMove;
+		}
+	}
+
+inline TInt TGomokuSearchStatistics::NodesPerSecond() const
+	{
+	return (iTimeMs > 0) ? (TInt) ((TInt64) iNodes * 1000 / iTimeMs) : 0;
+	}
+
+inline TInt TGomokuSearchStatistics::HashHitPercent() const
+	{
+	return (iHashLookups > 0) ? (TInt) ((TInt64) iHashHits * 100
+			/ iHashLookups) : 0;
+	}
+
+/**
+ * Maximum number of moves suggested as hints.
+ */
+const TInt KMaxMoveHints = 5;
+
+/**
+ * A move suggested by a player implementation, see
+ * CGomokuPlayerInterface::GetHints().
+ */
+class TGomokuMoveHint
+	{
+public:
+	/**
+	 * Cell of the move.
+	 */
+	TPoint iMove;
+
+	/**
+	 * Rating of the move, higher is better. Only comparable with the other
+	 * hints of the same player.
+	 */
+	TInt iScore;
+	};
+
+#endif /*GOMOKUSEARCHSTATISTICS_H_*/
@@ -90,6 +90,7 @@ EXPORT_C void CGrid::ResizeGridL(TSize aGridSize)
 	iGridRows = aGridSize.iHeight;
 	CreateGridL();
 	iLastMove.SetXY(-1, -1);
+	iNumHintCells = 0;
 	iCurCell.SetXY(iGridCols / 2, iGridRows / 2);
 	iRemainingFreeCells = iGridCols * iGridRows;
 	CalculateSize();
@@ -141,6 +142,15 @@ EXPORT_C void CGrid::SetBgColor(const TRgb &aBgColor)
 	iBgColor = aBgColor;
 }
 
+EXPORT_C void CGrid::SetHintCells(const TPoint* aCells, TInt aNumCells)
+{
+	iNumHintCells = aCells ? Min(aNumCells, KGridMaxHintCells) : 0;
+	for (TInt i = 0; i < iNumHintCells; i++)
+	{
+		iHintCells[i] = aCells[i];
+	}
+}
+
 void CGrid::CreateGridL()
 {
 	// Create new 2D dynamic arrays.
@@ -445,6 +455,14 @@ void CGrid::Draw(const TRect &aRect) const
 		iBackBufferBmpGc->DrawRect(GetRectOfCell(iLastMove));
 	}
 
+	// Highlight suggested moves, the best one stronger than the others
+	for (TInt i = 0; i < iNumHintCells; i++)
+	{
+		iBackBufferBmpGc->SetBrushColor((i == 0) ? TRgb(120, 170, 255)
+				: TRgb(200, 220, 255));
+		iBackBufferBmpGc->DrawRect(GetRectOfCell(iHintCells[i]));
+	}
+
 	// Highlight currently selected cell
 	if (iCurCell.iX > -1 && iCurCell.iY > -1)
 	{
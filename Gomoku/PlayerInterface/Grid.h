@@ -40,6 +40,11 @@
 #define EStdKeyLeftDownArrow    EStdKeyDevice13  // Diagonal arrow event
 #endif
 
+/**
+ * Maximum number of cells that can be highlighted as hints.
+ */
+const TInt KGridMaxHintCells = 5;
+
 // CLASS DECLARATION
 
 /**
@@ -169,6 +174,16 @@ public:
 	 */
 	IMPORT_C void SetBgColor (const TRgb &aBgColor);
 
+	/**
+	 * Highlight cells that are suggested as the next move. The first cell
+	 * is the best one and gets a stronger color. The hints stay until they
+	 * are replaced or the grid is resized.
+	 *
+	 * \param aCells the cells, can be NULL to remove the hints.
+	 * \param aNumCells number of cells, up to KGridMaxHintCells are shown.
+	 */
+	IMPORT_C void SetHintCells(const TPoint* aCells, TInt aNumCells);
+
 	/**
 	 * Make the control take all the available space of the main pane.
 	 */
@@ -316,6 +331,16 @@ private:
 	 */
 	TPoint iLastMove;
 
+	/**
+	 * Cells highlighted as hints, the best one first.
+	 */
+	TPoint iHintCells[KGridMaxHintCells];
+
+	/**
+	 * Number of cells in iHintCells.
+	 */
+	TInt iNumHintCells;
+
 	/**
 	 * Screen size (in pixels) of an individual grid cell.
 	 */
@@ -0,0 +1,199 @@
+/*
+ ============================================================================
+ Name		 : ProofSolver.cpp
+ Copyright   : Andreas Jakl, 2007-2009
+
+ All rights reserved. This program and the accompanying materials
+ are made available under the terms of the Eclipse Public License v2.0
+ which accompanies this distribution, and is available at
+ https://www.eclipse.org/legal/epl-2.0/
+
+ Description : Console tool that solves positions with the proof-number
+               search, e.g. to verify the lines of the opening book.
+
+ Usage: ProofSolver <positions> <results file> [node budget] [radius]
+
+ Every line of the positions describes one position by the moves that led
+ to it, starting on an empty grid:
+   <columns> <rows> <pair check 0/1> <pairs to win> <x>,<y> <x>,<y> ...
+ The player that made the first move has color 1, the moves alternate.
+ Empty lines and lines starting with '#' are ignored. For every position,
+ a line is written to the results file:
+   <line number> <won/lost/drawn/unknown> <winning move x,y or -> <nodes>
+ The result is for the player to move.
+ ============================================================================
+ */
+
+#include <e32base.h>
+#include <e32cons.h>
+#include <f32file.h>
+#include "GomokuProofSolver.h"
+#include "GomokuPositionReader.h"
+
+_LIT(KTitle, "Gomoku Proof Solver");
+_LIT(KUsage, "ProofSolver <positions> <results file> [node budget] [radius]\n");
+
+/**
+ * Maximum length of a line of the results file.
+ */
+const TInt KMaxResultLength = 64;
+
+LOCAL_C void SolvePositionsL(CConsoleBase& aConsole)
+	{
+	// Arguments
+	HBufC* commandLine = HBufC::NewLC(User::CommandLineLength());
+	TPtr arguments = commandLine->Des();
+	User::CommandLine(arguments);
+	TLex lex(arguments);
+	const TPtrC positionsFileName = lex.NextToken();
+	const TPtrC resultsFileName = lex.NextToken();
+	TInt nodeBudget = KProofDefaultNodeBudget;
+	TInt radius = KProofDefaultRadius;
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(nodeBudget) != KErrNone)
+		{
+		nodeBudget = 0;
+		}
+	lex.SkipSpace();
+	if (!lex.Eos() && lex.Val(radius) != KErrNone)
+		{
+		radius = 0;
+		}
+	if (resultsFileName.Length() == 0 || nodeBudget <= 0 || radius <= 0)
+		{
+		aConsole.Printf(KUsage);
+		CleanupStack::PopAndDestroy(commandLine);
+		return;
+		}
+
+	RFs fs;
+	User::LeaveIfError(fs.Connect());
+	CleanupClosePushL(fs);
+
+	// Read the positions
+	RFile positionsFile;
+	User::LeaveIfError(positionsFile.Open(fs, positionsFileName, EFileRead
+			| EFileShareReadersOnly));
+	CleanupClosePushL(positionsFile);
+	TInt size;
+	User::LeaveIfError(positionsFile.Size(size));
+	HBufC8* positions = HBufC8::NewLC(size);
+	TPtr8 positionsPtr = positions->Des();
+	User::LeaveIfError(positionsFile.Read(positionsPtr));
+
+	RFile resultsFile;
+	User::LeaveIfError(resultsFile.Replace(fs, resultsFileName, EFileWrite));
+	CleanupClosePushL(resultsFile);
+
+	CGomokuProofSolver* solver = CGomokuProofSolver::NewL();
+	CleanupStack::PushL(solver);
+	CGrid* grid = CGrid::NewL();
+	CleanupStack::PushL(grid);
+	TPoint* moves = new (ELeave) TPoint[KMaxPositionMoves];
+	CleanupArrayDeletePushL(moves);
+
+	TInt results[EProofDrawn + 1];
+	Mem::FillZ(results, sizeof(results));
+	TInt numSkipped = 0;
+	TBuf8<KMaxResultLength> result;
+	TSize solverGridSize;
+	TBool solverPairCheck = EFalse;
+	TInt solverNumPairsWin = 0;
+	TGomokuPositionReader reader(*positions);
+	while (reader.NextLine())
+		{
+		TSize gridSize;
+		TBool pairCheck;
+		TInt numPairsWin;
+		TInt numMoves;
+		TInt capturedPairs[2];
+		if (!reader.ParsePosition(gridSize, pairCheck, numPairsWin, moves,
+				numMoves))
+			{
+			numSkipped++;
+			continue;
+			}
+		grid->ResizeGridL(gridSize);
+		if (!TGomokuPositionReader::PlayMoves(grid, pairCheck, moves,
+				numMoves, capturedPairs))
+			{
+			numSkipped++;
+			continue;
+			}
+
+		// The tables of the solver are only allocated again for another
+		// kind of game.
+		if (gridSize != solverGridSize || pairCheck != solverPairCheck
+				|| numPairsWin != solverNumPairsWin)
+			{
+			solver->InitL(gridSize, pairCheck, numPairsWin);
+			solver->SetLimits(nodeBudget, radius);
+			solverGridSize = gridSize;
+			solverPairCheck = pairCheck;
+			solverNumPairsWin = numPairsWin;
+			}
+		const TInt toMove = numMoves % 2;
+		const TGomokuProofResult proof = solver->Solve(grid, (toMove == 0)
+				? EColor1 : EColor2, capturedPairs[toMove],
+				capturedPairs[1 - toMove]);
+		results[proof]++;
+
+		result.Num(reader.LineNumber());
+		switch (proof)
+			{
+			case EProofWon:
+				{
+				const TPoint move = solver->WinningMove();
+				result.Append(_L8(" won "));
+				result.AppendNum(move.iX);
+				result.Append(',');
+				result.AppendNum(move.iY);
+				break;
+				}
+			case EProofLost:
+				result.Append(_L8(" lost -"));
+				break;
+			case EProofDrawn:
+				result.Append(_L8(" drawn -"));
+				break;
+			default:
+				result.Append(_L8(" unknown -"));
+				break;
+			}
+		result.Append(' ');
+		result.AppendNum(solver->NodesSearched());
+		result.Append('\n');
+		User::LeaveIfError(resultsFile.Write(result));
+		}
+
+	aConsole.Printf(_L("%d won, %d lost, %d drawn, %d unknown\n"),
+			results[EProofWon], results[EProofLost], results[EProofDrawn],
+			results[EProofUnknown]);
+	aConsole.Printf(_L("%d invalid positions skipped\n"), numSkipped);
+	aConsole.Printf(_L("Results written to %S\n"), &resultsFileName);
+
+	CleanupStack::PopAndDestroy(8, commandLine); // moves, grid, solver, resultsFile, positions, positionsFile, fs, commandLine
+	}
+
+GLDEF_C TInt E32Main()
+	{
+	__UHEAP_MARK;
+	CTrapCleanup* cleanup = CTrapCleanup::New();
+	CConsoleBase* console = NULL;
+	TRAPD(err, console = Console::NewL(KTitle, TSize(KConsFullScreen,
+					KConsFullScreen)));
+	if (err == KErrNone)
+		{
+		TRAP(err, SolvePositionsL(*console));
+		if (err != KErrNone)
+			{
+			console->Printf(_L("Failed: %d\n"), err);
+			}
+		console->Printf(_L("[press any key]\n"));
+		console->Getch();
+		delete console;
+		}
+	delete cleanup;
+	__UHEAP_MARKEND;
+	return err;
+	}
@@ -33,7 +33,7 @@ _LIT(KFileStore, "Settings.dat");
  * an old and potentially incompatible settings file after upgrading
  * Gomoku to a new version on the phone.
  */
-#define INI_FILE_VERSION_NUMBER					3
+#define INI_FILE_VERSION_NUMBER					5
 
 /**
  * The current game phase.
@@ -247,6 +247,34 @@ public:
 	 * game by this method.
 	 */
 	TInt& GetNumPairsWin();
+
+	/**
+	 * Sets how long the AI players may think about a move.
+	 *
+	 * \param aMoveTime thinking time per move in seconds.
+	 */
+	void SetMoveTime(TInt aMoveTime);
+
+	/**
+	 * Retrieve how long the AI players may think about a move.
+	 *
+	 * \return thinking time per move in seconds.
+	 */
+	TInt& GetMoveTime();
+
+	/**
+	 * Sets how many threads the AI players may use.
+	 *
+	 * \param aThreads number of threads.
+	 */
+	void SetThreads(TInt aThreads);
+
+	/**
+	 * Retrieve how many threads the AI players may use.
+	 *
+	 * \return number of threads.
+	 */
+	TInt& GetThreads();
 	
 	/**
 	 * Reset the counter that stores how many pairs
@@ -441,6 +469,16 @@ private:
 	 */
 	TInt iNumPairsWin;
 
+	/**
+	 * Thinking time of the AI players per move in seconds.
+	 */
+	TInt iMoveTime;
+
+	/**
+	 * Number of threads that the AI players may use.
+	 */
+	TInt iThreads;
+
 	/**
 	 * Store how many pairs each player has already captured.
 	 */
@@ -86,6 +86,24 @@ private:
 	 */
 	void InitGameL();
 
+	/**
+	 * Cancel the turn of the current player if the view is waiting for its
+	 * move. A move that is sent anyway is discarded by HandleFinishedTurn().
+	 */
+	void CancelPendingTurn();
+
+	/**
+	 * Print the search statistics of the current player for the move
+	 * it just sent to the debug output. Only used in debug builds.
+	 */
+	void ReportStatistics();
+
+	/**
+	 * Highlight the moves that the current player suggests, if it has
+	 * already found some. See CGomokuPlayerInterface::GetHints().
+	 */
+	void ShowHints();
+
 	/**
 	 * Update the view context text with the current game status.
 	 */
@@ -180,6 +198,20 @@ private:
 	 */
 	TPoint iSaveMoveForAsyncCallback;
 
+	/**
+	 * Id of the current game, incremented by InitGameL().
+	 */
+	TInt iGameId;
+
+	/**
+	 * Id of the game in which the turn of the current player was started,
+	 * 0 if the view is not waiting for a move. Moves are only accepted if
+	 * this is the id of the current game, so that a player that is still
+	 * calculating when a game is restarted can't place its stone on the
+	 * board of the new game.
+	 */
+	TInt iTurnGameId;
+
 	/**
 	 * Timer object for handling asynchronous callbacks.
 	 */
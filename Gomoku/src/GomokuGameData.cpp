@@ -31,7 +31,8 @@ void CGomokuGameData::ConstructL()
 
 CGomokuGameData::CGomokuGameData() :
 		// Initialize with default values
-	iCurrentPlayer(1), iGridCols(10), iGridRows(10), iPairCheck(EFalse), iNumPairsWin(5)
+	iCurrentPlayer(1), iGridCols(10), iGridRows(10), iPairCheck(EFalse), iNumPairsWin(5),
+	iMoveTime(5), iThreads(1)
 {
 }
 
@@ -200,6 +201,26 @@ TInt& CGomokuGameData::GetNumPairsWin()
 	return iNumPairsWin;
 }
 
+void CGomokuGameData::SetMoveTime(TInt aMoveTime)
+{
+	iMoveTime = aMoveTime;
+}
+
+TInt& CGomokuGameData::GetMoveTime()
+{
+	return iMoveTime;
+}
+
+void CGomokuGameData::SetThreads(TInt aThreads)
+{
+	iThreads = aThreads;
+}
+
+TInt& CGomokuGameData::GetThreads()
+{
+	return iThreads;
+}
+
 void CGomokuGameData::IncreasePairsCaptured(TInt aPlayer,
 		TInt aAdditionalPairsCaptured)
 {
@@ -295,6 +316,8 @@ void CGomokuGameData::ReadSettingsL(RStoreReadStream& aStream)
 	iGridRows = aStream.ReadInt32L();
 	iPairCheck = aStream.ReadInt32L();	
 	iNumPairsWin = aStream.ReadInt32L();
+	iMoveTime = aStream.ReadInt32L();
+	iThreads = aStream.ReadInt32L();
 }
 
 void CGomokuGameData::WriteSettingsL(RStoreWriteStream& aStream)
@@ -303,6 +326,8 @@ void CGomokuGameData::WriteSettingsL(RStoreWriteStream& aStream)
 	aStream.WriteInt32L(iGridRows);
 	aStream.WriteInt32L(iPairCheck);
 	aStream.WriteInt32L(iNumPairsWin);
+	aStream.WriteInt32L(iMoveTime);
+	aStream.WriteInt32L(iThreads);
 }
 
 
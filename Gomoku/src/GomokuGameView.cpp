@@ -12,6 +12,7 @@
  ============================================================================
  */
 
+#include <e32debug.h>
 #include "GomokuGameView.h"
 
 /**
@@ -39,7 +40,8 @@ CGomokuGameView* CGomokuGameView::NewL(CGomokuGameData* aGameData)
  */
 CGomokuGameView::CGomokuGameView(CGomokuGameData* aGameData) :
 	iSetViewContextText(EFalse), iGameData(aGameData), iPaused(EFalse),
-			iPausedCallbackWaiting(EFalse), iSaveMoveForAsyncCallback(-1, -1)
+			iPausedCallbackWaiting(EFalse), iSaveMoveForAsyncCallback(-1, -1),
+			iGameId(0), iTurnGameId(0)
 {
 }
 
@@ -140,6 +142,12 @@ void CGomokuGameView::DoDeactivate()
 
 void CGomokuGameView::InitGameL()
 {
+	// Stop a player that is still calculating a move for the previous game.
+	// Moves of the previous game that arrive anyway are discarded, as they
+	// belong to an older game id.
+	CancelPendingTurn();
+	iGameId++;
+
 	// Cancel the timer in case it is still active (it shouldn't be, but anyway).
 	iTimer->Cancel();
 	// Unpause the game
@@ -163,13 +171,33 @@ void CGomokuGameView::InitGameL()
 	iSendGrid->CopyFrom(iGameData->GetGrid());
 
 	// Initialize the player implementations with the settings
-	// of this game.
+	// of this game. The number of threads is used by InitL().
+	iGameData->GetPlayer1()->SetThreads(iGameData->GetThreads());
+	iGameData->GetPlayer2()->SetThreads(iGameData->GetThreads());
+#ifdef _DEBUG
+	iGameData->GetPlayer1()->SetReportStatistics(ETrue);
+	iGameData->GetPlayer2()->SetReportStatistics(ETrue);
+#endif
 	iGameData->GetPlayer1()->SetObserver(this);
 	iGameData->GetPlayer1()->InitL(iSendGrid, EColor1,
 			iGameData->GetPairCheckEnabled(), iGameData->GetNumPairsWin());
 	iGameData->GetPlayer2()->SetObserver(this);
 	iGameData->GetPlayer2()->InitL(iSendGrid, EColor2,
 			iGameData->GetPairCheckEnabled(), iGameData->GetNumPairsWin());
+	// The game is played without a clock, only the time per move is limited.
+	const TInt moveTimeMs = iGameData->GetMoveTime() * 1000;
+	iGameData->GetPlayer1()->SetTimeLimits(moveTimeMs, KMaxTInt);
+	iGameData->GetPlayer2()->SetTimeLimits(moveTimeMs, KMaxTInt);
+	// Every game gets a new seed for the random numbers of the players.
+	// It is printed in debug builds, so that a game can be reproduced.
+	TTime now;
+	now.UniversalTime();
+	const TUint64 seed = (TUint64) now.Int64();
+#ifdef _DEBUG
+	RDebug::Print(_L("Game %d: random seed %Lu"), iGameId, seed);
+#endif
+	iGameData->GetPlayer1()->SetRandomSeed(seed + 1);
+	iGameData->GetPlayer2()->SetRandomSeed(seed + 2);
 
 	// Update the view with the current player
 	iGameData->SetCurrentPlayerNum(1);
@@ -270,8 +298,14 @@ void CGomokuGameView::HandleCommandL(TInt aCommand)
 		InitGameL();
 		break;
 	}
+	case EGomokuHintCmd:
+	{
+		ShowHints();
+		break;
+	}
 	case EGomokuNewGameCmd:
 	{
+		CancelPendingTurn();
 		iGameData->SetGamePhase(EGameOver);
 		// Go back to the settings view.
 		AppUi()->HandleCommandL(EGomokuBackCmd);
@@ -338,6 +372,13 @@ void CGomokuGameView::HandleFinishedTurn(TInt aCol, TInt aRow)
 		// Only process a turn if the game is currently active.
 		return;
 	}
+	if (iTurnGameId != iGameId)
+	{
+		// No turn has been requested in the current game - this is a late
+		// move of a cancelled turn.
+		return;
+	}
+	iTurnGameId = 0;
 	if (iTimer->IsActive())
 	{
 		User::Panic(
@@ -351,6 +392,54 @@ void CGomokuGameView::HandleFinishedTurn(TInt aCol, TInt aRow)
 
 }
 
+void CGomokuGameView::ReportStatistics()
+{
+	TGomokuSearchStatistics statistics;
+	if (!iGameData->GetCurrentPlayer()->GetStatistics(statistics))
+	{
+		// Human players don't search.
+		return;
+	}
+	RDebug::Print(_L("Player %d: %d nodes in %d ms (%d per second), depth %d, hash hits %d%%"),
+			iGameData->GetCurrentPlayerNum(), statistics.iNodes,
+			statistics.iTimeMs, statistics.NodesPerSecond(),
+			statistics.iDepth, statistics.HashHitPercent());
+	TBuf<8 * KSearchMaxPvLength> pv;
+	for (TInt i = 0; i < statistics.iPvLength; i++)
+	{
+		pv.AppendFormat(_L(" %d,%d"), statistics.iPv[i].iX,
+				statistics.iPv[i].iY);
+	}
+	RDebug::Print(_L("Player %d: PV%S"), iGameData->GetCurrentPlayerNum(), &pv);
+}
+
+void CGomokuGameView::ShowHints()
+{
+	if (iGameData->GetGamePhase() != EIngame)
+	{
+		return;
+	}
+	TGomokuMoveHint hints[KMaxMoveHints];
+	const TInt numHints = iGameData->GetCurrentPlayer()->GetHints(hints,
+			KMaxMoveHints);
+	TPoint cells[KMaxMoveHints];
+	for (TInt i = 0; i < numHints; i++)
+	{
+		cells[i] = hints[i].iMove;
+	}
+	iGameData->GetGrid()->SetHintCells(cells, numHints);
+	iGameData->GetGrid()->DrawDeferred();
+}
+
+void CGomokuGameView::CancelPendingTurn()
+{
+	if (iTurnGameId != 0 && iTurnGameId == iGameId)
+	{
+		iGameData->GetCurrentPlayer()->CancelTurn();
+	}
+	iTurnGameId = 0;
+}
+
 TInt CGomokuGameView::TimerFunc(TAny* aObj)
 {
 	// Start the non-static processing method
@@ -438,12 +527,17 @@ void CGomokuGameView::AsyncHandleFinishedTurnL()
 		if (iSaveMoveForAsyncCallback.iX != -1 && iSaveMoveForAsyncCallback.iY
 				!= -1)
 		{
+#ifdef _DEBUG
+			ReportStatistics();
+#endif
 			// Set the grid cell to the color of the current player and
 			// save how many new pairs were captured
 			TInt numPairsCaptured = iGameData->GetGrid()->SetGridCell(
 					iSaveMoveForAsyncCallback.iX, iSaveMoveForAsyncCallback.iY,
 					iGameData->GetCurrentPlayerColor(),
 					iGameData->GetPairCheckEnabled());
+			// The hints were for the position before the move.
+			iGameData->GetGrid()->SetHintCells(NULL, 0);
 			// If at least one pair was captured, increase the number of captured pairs.
 			if (numPairsCaptured > 0)
 			{
@@ -529,6 +623,13 @@ void CGomokuGameView::AsyncHandleFinishedTurnL()
 			// the game is not over yet -> don't request any more callbacks
 			// and start the turn of the next player.
 			iTimer->Cancel();
+			// Set before starting the turn, as the player is allowed to
+			// send its move from within StartTurn().
+			iTurnGameId = iGameId;
+			const TInt playerNum = iGameData->GetCurrentPlayerNum();
+			iGameData->GetCurrentPlayer()->SetCapturedPairs(
+					iGameData->GetPairsCaptured(playerNum),
+					iGameData->GetPairsCaptured(3 - playerNum));
 			iGameData->GetCurrentPlayer()->StartTurn();
 		}
 	}
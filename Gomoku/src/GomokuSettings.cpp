@@ -38,6 +38,14 @@ CAknSettingItem* CGomokuSettings::CreateSettingItemL(TInt aIdentifier)
 	case ESettingsRowsSlider:
 		return new (ELeave) CAknSliderSettingItem(aIdentifier,
 				iGameData->GetGridRows());
+
+	case ESettingsMoveTimeSlider:
+		return new (ELeave) CAknSliderSettingItem(aIdentifier,
+				iGameData->GetMoveTime());
+
+	case ESettingsThreadsSlider:
+		return new (ELeave) CAknSliderSettingItem(aIdentifier,
+				iGameData->GetThreads());
 	default:
 		return NULL;
 	}
@@ -50,6 +58,8 @@ void CGomokuSettings::UpdateItemsFromGameDataL()
 	(*SettingItemArray())[ESettingsNumPairsWinSlider]->LoadL();
 	(*SettingItemArray())[ESettingsColsSlider]->LoadL();
 	(*SettingItemArray())[ESettingsRowsSlider]->LoadL();
+	(*SettingItemArray())[ESettingsMoveTimeSlider]->LoadL();
+	(*SettingItemArray())[ESettingsThreadsSlider]->LoadL();
 	// Make sure the shown items correspond to the current settings.
 	UpdateItemVisibilityL();
 }